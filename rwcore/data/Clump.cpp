@@ -27,16 +27,31 @@ ModelFrame::ModelFrame(unsigned int index, glm::mat3 dR, glm::vec3 dT)
 void ModelFrame::reset() {
     matrix = glm::translate(glm::mat4(1.0f), defaultTranslation) *
              glm::mat4(defaultRotation);
-    updateHierarchyTransform();
+    markDirty();
 }
 
-void ModelFrame::updateHierarchyTransform() {
-    // Update our own transformation
+void ModelFrame::markDirty() {
+    // Descendants of a dirty frame are already dirty
+    if (dirty_) {
+        return;
+    }
+    dirty_ = true;
+    for (const auto& child : children_) {
+        child->markDirty();
+    }
+}
+
+void ModelFrame::resolveWorldTransform() const {
     if (parent_) {
         worldtransform_ = parent_->getWorldTransform() * matrix;
     } else {
         worldtransform_ = matrix;
     }
+    dirty_ = false;
+}
+
+void ModelFrame::updateHierarchyTransform() {
+    resolveWorldTransform();
     for (const auto& child : children_) {
         child->updateHierarchyTransform();
     }
@@ -52,7 +67,7 @@ void ModelFrame::addChild(const ModelFramePtr& child) {
     }
     child->parent_ = this;
     children_.push_back(child);
-    child->updateHierarchyTransform();
+    child->markDirty();
 }
 
 ModelFrame* ModelFrame::findDescendant(const std::string& name) const {
@@ -100,6 +115,34 @@ ModelFrame* Clump::findFrame(const std::string& name) const {
 
 Clump::~Clump() = default;
 
+void Clump::setFrame(const ModelFramePtr& root) {
+    rootframe_ = root;
+    frames_.clear();
+    if (!root) {
+        return;
+    }
+
+    // Depth first, so that each frame comes after its parent
+    std::vector<ModelFrame*> open{root.get()};
+    while (!open.empty()) {
+        auto frame = open.back();
+        open.pop_back();
+        frames_.push_back(frame);
+        const auto& children = frame->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            open.push_back(it->get());
+        }
+    }
+
+    updateTransforms();
+}
+
+void Clump::updateTransforms() const {
+    for (auto frame : frames_) {
+        frame->updateWorldTransform();
+    }
+}
+
 void Clump::recalculateMetrics() {
     boundingRadius = std::numeric_limits<float>::min();
     for (const auto& atomic : atomics_) {
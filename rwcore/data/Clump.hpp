@@ -15,13 +15,22 @@
 
 /**
  * ModelFrame stores transformation hierarchy
+ *
+ * Changing a frame's transform only marks it and its descendants dirty, the
+ * world transforms are recalculated when they are next read or when the
+ * Clump resolves them with Clump::updateTransforms().
+ *
+ * Reading the world transform of a dirty frame writes to it, so frames that
+ * may be dirty must not be read from more than one thread.
  */
 class ModelFrame {
     unsigned int index;
     glm::mat3 defaultRotation;
     glm::vec3 defaultTranslation;
     glm::mat4 matrix{1.0f};
-    glm::mat4 worldtransform_{1.0f};
+    mutable glm::mat4 worldtransform_{1.0f};
+    /// worldtransform_ is out of date, and so are the descendants'
+    mutable bool dirty_ = false;
     ModelFrame* parent_;
     std::string name;
     std::vector<ModelFramePtr> children_;
@@ -34,7 +43,7 @@ public:
 
     void setTransform(const glm::mat4& m) {
         matrix = m;
-        updateHierarchyTransform();
+        markDirty();
     }
 
     const glm::mat4& getTransform() const {
@@ -59,25 +68,45 @@ public:
 
     void setTranslation(const glm::vec3& t) {
         matrix[3] = glm::vec4(t, matrix[3][3]);
-        updateHierarchyTransform();
+        markDirty();
     }
 
     void setRotation(const glm::mat3& r) {
         for (unsigned int i = 0; i < 3; i++) {
             matrix[i] = glm::vec4(r[i], matrix[i][3]);
         }
-        updateHierarchyTransform();
+        markDirty();
     }
 
     /**
-     * Updates the cached matrix
+     * Marks the world transform of this frame and its descendants as out of
+     * date
+     */
+    void markDirty();
+
+    bool isDirty() const {
+        return dirty_;
+    }
+
+    /**
+     * Recalculates the world transform if it is out of date
+     */
+    void updateWorldTransform() const {
+        if (dirty_) {
+            resolveWorldTransform();
+        }
+    }
+
+    /**
+     * Recalculates the world transform of this frame and all descendants
      */
     void updateHierarchyTransform();
 
     /**
-     * @return the cached world transformation for this Frame
+     * @return the world transformation for this Frame
      */
     const glm::mat4& getWorldTransform() const {
+        updateWorldTransform();
         return worldtransform_;
     }
 
@@ -98,6 +127,9 @@ public:
     ModelFrame* findDescendant(const std::string& name) const;
 
     ModelFramePtr cloneHierarchy() const;
+
+private:
+    void resolveWorldTransform() const;
 };
 
 /**
@@ -170,6 +202,10 @@ struct Geometry {
     DrawBuffer dbuff;
     GeometryBuffer gbuff;
 
+    /// Vertex data waiting to be uploaded into gbuff, only kept afterwards
+    /// if the loader was asked to
+    std::vector<GeometryVertex> vertices;
+
     GLuint EBO;
 
     RW::BSGeometryBounds geometryBounds;
@@ -265,14 +301,28 @@ public:
         return atomics_;
     }
 
-    void setFrame(const ModelFramePtr& root) {
-        rootframe_ = root;
-    }
+    /**
+     * Sets the root of the frame hierarchy, which must be complete as the
+     * frames are listed and their transforms resolved here
+     */
+    void setFrame(const ModelFramePtr& root);
 
     const ModelFramePtr& getFrame() const {
         return rootframe_;
     }
 
+    /**
+     * @return every frame in the hierarchy, parents before their children
+     */
+    const std::vector<ModelFrame*>& getFrames() const {
+        return frames_;
+    }
+
+    /**
+     * Resolves the world transforms of all dirty frames in one pass
+     */
+    void updateTransforms() const;
+
     /**
      * @return A Copy of the frames and atomics in this clump
      */
@@ -282,6 +332,7 @@ private:
     float boundingRadius;
     AtomicList atomics_;
     ModelFramePtr rootframe_;
+    std::vector<ModelFrame*> frames_;
 };
 
 #endif
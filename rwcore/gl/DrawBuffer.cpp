@@ -4,6 +4,7 @@
 
 #include <gl/gl_core_3_3.h>
 #include <gl/GeometryBuffer.hpp>
+#include <rw/headless.hpp>
 
 DrawBuffer::DrawBuffer() : vao(0) {
 }
@@ -14,7 +15,21 @@ DrawBuffer::~DrawBuffer() {
     }
 }
 
+void DrawBuffer::addGeometryOnce(
+    std::initializer_list<GeometryBuffer*> gbuffs) {
+    if (hasGeometry) {
+        return;
+    }
+    for (auto gbuff : gbuffs) {
+        addGeometry(gbuff);
+    }
+    hasGeometry = true;
+}
+
 void DrawBuffer::addGeometry(GeometryBuffer* gbuff) {
+    if (isHeadless()) {
+        return;
+    }
     if (vao == 0) {
         glGenVertexArrays(1, &vao);
     }
@@ -27,5 +42,6 @@ void DrawBuffer::addGeometry(GeometryBuffer* gbuff) {
         glEnableVertexAttribArray(vaoindex);
         glVertexAttribPointer(vaoindex, static_cast<GLint>(at.size), at.type, GL_TRUE, at.stride,
                               reinterpret_cast<void*>(at.offset));
+        glVertexAttribDivisor(vaoindex, at.divisor);
     }
 }
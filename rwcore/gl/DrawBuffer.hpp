@@ -3,6 +3,8 @@
 
 #include <gl/gl_core_3_3.h>
 
+#include <initializer_list>
+
 class GeometryBuffer;
 
 /**
@@ -11,6 +13,7 @@ class GeometryBuffer;
 class DrawBuffer {
     GLuint vao;
     GLenum facetype;
+    bool hasGeometry = false;
 
 public:
     DrawBuffer();
@@ -30,8 +33,16 @@ public:
 
     /**
      * Adds a Geometry Buffer to the Draw Buffer.
+     *
+     * A buffer of per-instance attributes can be added after the vertices.
      */
     void addGeometry(GeometryBuffer* gbuff);
+
+    /**
+     * Adds the Geometry Buffers on the first call only, for draw buffers that
+     * are set up once their streamed vertices have been uploaded.
+     */
+    void addGeometryOnce(std::initializer_list<GeometryBuffer*> gbuffs);
 };
 
 #endif
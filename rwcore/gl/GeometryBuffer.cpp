@@ -1,5 +1,7 @@
 #include "gl/GeometryBuffer.hpp"
 
+#include "rw/headless.hpp"
+
 GeometryBuffer::~GeometryBuffer() {
     if (vbo != 0) {
         glDeleteBuffers(1, &vbo);
@@ -7,11 +9,14 @@ GeometryBuffer::~GeometryBuffer() {
 }
 
 void GeometryBuffer::uploadVertices(GLsizei num, GLsizeiptr size,
-                                    const GLvoid* mem) {
+                                    const GLvoid* mem, GLenum usage) {
+    this->num = num;
+    if (isHeadless()) {
+        return;
+    }
     if (vbo == 0) {
         glGenBuffers(1, &vbo);
     }
-    this->num = num;
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, size, mem, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, size, mem, usage);
 }
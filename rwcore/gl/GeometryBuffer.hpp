@@ -12,7 +12,12 @@ enum AttributeSemantic {
     ATRS_Position = 0,
     ATRS_Normal = 1,
     ATRS_Colour = 2,
-    ATRS_TexCoord = 3
+    ATRS_TexCoord = 3,
+    /// Per-instance data, read by the shader from these locations
+    ATRS_Instance0 = 4,
+    ATRS_Instance1 = 5,
+    ATRS_Instance2 = 6,
+    ATRS_Instance3 = 7
 };
 
 /**
@@ -24,10 +29,17 @@ struct AttributeIndex {
     GLsizei stride;
     size_t offset;
     GLenum type;
+    /// Number of instances that share each element, 0 advances per vertex
+    GLuint divisor;
 
     AttributeIndex(AttributeSemantic s, GLsizei sz, GLsizei strd, size_t offs,
-                   GLenum type = GL_FLOAT)
-        : sem(s), size(sz), stride(strd), offset(offs), type(type) {
+                   GLenum type = GL_FLOAT, GLuint divisor = 0)
+        : sem(s)
+        , size(sz)
+        , stride(strd)
+        , offset(offs)
+        , type(type)
+        , divisor(divisor) {
     }
 };
 
@@ -64,18 +76,34 @@ public:
      *
      * vertex_attributes() is assumed to exist so that vertex types
      * can implicitly declare the strides and offsets for their data.
+     *
+     * Buffers that are refilled every frame should pass GL_STREAM_DRAW as
+     * the usage.
      */
     template <class T>
-    void uploadVertices(const std::vector<T>& data) {
-        uploadVertices(static_cast<GLsizei>(data.size()), data.size() * sizeof(T), data.data());
+    void uploadVertices(const std::vector<T>& data,
+                        GLenum usage = GL_STATIC_DRAW) {
+        uploadVertices(static_cast<GLsizei>(data.size()), data.size() * sizeof(T), data.data(), usage);
         // Assume T has a static method for attributes;
         attributes = T::vertex_attributes();
     }
 
+    /**
+     * Replaces the contents with vertices that are refilled every frame.
+     *
+     * The previous contents are orphaned rather than overwritten, since draws
+     * that are still in flight may be reading them.
+     */
+    template <class T>
+    void streamVertices(const std::vector<T>& data) {
+        uploadVertices(data, GL_STREAM_DRAW);
+    }
+
     /**
      * Uploads raw memory into the buffer.
      */
-    void uploadVertices(GLsizei num, GLsizeiptr size, const GLvoid* mem);
+    void uploadVertices(GLsizei num, GLsizeiptr size, const GLvoid* mem,
+                        GLenum usage = GL_STATIC_DRAW);
 
     const AttributeList& getDataAttributes() const {
         return attributes;
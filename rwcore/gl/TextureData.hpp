@@ -7,9 +7,38 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+
+/**
+ * Owns an array texture that several textures of a TXD are packed into.
+ */
+class TextureArray {
+public:
+    explicit TextureArray(GLuint name) : arrayName(name) {
+    }
+
+    ~TextureArray() {
+        if (arrayName != 0) {
+            glDeleteTextures(1, &arrayName);
+        }
+    }
+
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+
+    GLuint getName() const {
+        return arrayName;
+    }
+
+private:
+    GLuint arrayName;
+};
 
 /**
  * Stores a handle and metadata about a loaded texture.
+ *
+ * Textures packed into a TextureArray have no texture of their own, they are
+ * sampled from a layer of the array instead.
  */
 class TextureData {
 public:
@@ -17,8 +46,19 @@ public:
         : texName(name), size(dims), hasAlpha(alpha) {
     }
 
+    TextureData(std::shared_ptr<TextureArray> packed, GLint arrayLayer,
+                const glm::ivec2& dims, bool alpha)
+        : texName(0)
+        , size(dims)
+        , hasAlpha(alpha)
+        , array(std::move(packed))
+        , layer(arrayLayer) {
+    }
+
     ~TextureData() {
-        glDeleteTextures(1, &texName);
+        if (texName != 0) {
+            glDeleteTextures(1, &texName);
+        }
     }
 
     GLuint getName() const {
@@ -33,6 +73,20 @@ public:
         return hasAlpha;
     }
 
+    /**
+     * @return the name of the array texture this is packed into, or 0
+     */
+    GLuint getArrayName() const {
+        return array ? array->getName() : 0;
+    }
+
+    /**
+     * @return the layer of the array texture, or -1 if it isn't packed
+     */
+    GLint getLayer() const {
+        return layer;
+    }
+
     static auto create(GLuint name, const glm::ivec2& size,
                          bool transparent) {
         return std::make_unique<TextureData>(name, size, transparent);
@@ -42,6 +96,8 @@ private:
     GLuint texName;
     glm::ivec2 size;
     bool hasAlpha;
+    std::shared_ptr<TextureArray> array;
+    GLint layer = -1;
 };
 using TextureArchive = std::unordered_map<std::string, std::unique_ptr<TextureData>>;
 
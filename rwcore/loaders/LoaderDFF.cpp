@@ -15,6 +15,7 @@
 #include "loaders/RWBinaryStream.hpp"
 #include "platform/FileHandle.hpp"
 #include "rw/debug.hpp"
+#include "rw/headless.hpp"
 
 enum DFFChunks {
     CHUNK_STRUCT = 0x0001,
@@ -57,16 +58,16 @@ LoaderDFF::FrameList LoaderDFF::readFrameList(const RWBStream &stream) {
         throw DFFLoaderException("Frame List missing struct chunk");
     }
 
-    char *headerPtr = listStream.getCursor();
+    const char *headerPtr = listStream.getCursor();
 
-    unsigned int numFrames = *reinterpret_cast<std::uint32_t *>(headerPtr);
+    unsigned int numFrames = *reinterpret_cast<const std::uint32_t *>(headerPtr);
     headerPtr += sizeof(std::uint32_t);
 
     FrameList framelist;
     framelist.reserve(numFrames);
 
     for (auto f = 0u; f < numFrames; ++f) {
-        auto data = reinterpret_cast<RWBSFrame *>(headerPtr);
+        auto data = reinterpret_cast<const RWBSFrame *>(headerPtr);
         headerPtr += sizeof(RWBSFrame);
         auto frame =
             std::make_shared<ModelFrame>(f, data->rotation, data->position);
@@ -123,7 +124,7 @@ LoaderDFF::GeometryList LoaderDFF::readGeometryList(const RWBStream &stream) {
         throw DFFLoaderException("Geometry List missing struct chunk");
     }
 
-    char *headerPtr = listStream.getCursor();
+    const char *headerPtr = listStream.getCursor();
 
     unsigned int numGeometries = bit_cast<std::uint32_t>(*headerPtr);
     headerPtr += sizeof(std::uint32_t);
@@ -155,7 +156,7 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
 
     auto geom = std::make_shared<Geometry>();
 
-    char *headerPtr = geomStream.getCursor();
+    const char *headerPtr = geomStream.getCursor();
 
     geom->flags = bit_cast<std::uint16_t>(*headerPtr);
     headerPtr += sizeof(std::uint16_t);
@@ -252,23 +253,44 @@ GeometryPtr LoaderDFF::readGeometry(const RWBStream &stream) {
     geom->dbuff.setFaceType(geom->facetype == Geometry::Triangles
                                 ? GL_TRIANGLES
                                 : GL_TRIANGLE_STRIP);
-    geom->gbuff.uploadVertices(verts);
-    geom->dbuff.addGeometry(&geom->gbuff);
+    geom->vertices = std::move(verts);
 
-    glGenBuffers(1, &geom->EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom->EBO);
+    return geom;
+}
+
+void LoaderDFF::uploadGeometry(Geometry &geom, bool keepVertices) {
+    for (auto &material : geom.materials) {
+        for (auto &texture : material.textures) {
+            if (!texture.texture && textureLookup) {
+                texture.texture = textureLookup(texture.name, texture.alphaName);
+            }
+        }
+    }
+
+    if (isHeadless()) {
+        return;
+    }
+
+    geom.gbuff.uploadVertices(geom.vertices);
+    geom.dbuff.addGeometry(&geom.gbuff);
+
+    glGenBuffers(1, &geom.EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom.EBO);
 
     size_t icount = std::accumulate(
-        geom->subgeom.begin(), geom->subgeom.end(), size_t{0u},
+        geom.subgeom.begin(), geom.subgeom.end(), size_t{0u},
         [](size_t a, const SubGeometry &b) { return a + b.numIndices; });
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * icount, nullptr,
                  GL_STATIC_DRAW);
-    for (auto &sg : geom->subgeom) {
+    for (auto &sg : geom.subgeom) {
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sg.start * sizeof(uint32_t),
                         sizeof(uint32_t) * sg.numIndices, sg.indices.data());
     }
 
-    return geom;
+    // The GL buffers own the vertex data from now on
+    if (!keepVertices) {
+        geom.vertices = {};
+    }
 }
 
 void LoaderDFF::readMaterialList(const GeometryPtr &geom, const RWBStream &stream) {
@@ -303,7 +325,7 @@ void LoaderDFF::readMaterial(const GeometryPtr &geom, const RWBStream &stream) {
         throw DFFLoaderException("Material missing struct chunk");
     }
 
-    char *matData = materialStream.getCursor();
+    const char *matData = materialStream.getCursor();
 
     Geometry::Material material;
 
@@ -363,8 +385,8 @@ void LoaderDFF::readTexture(Geometry::Material &material,
     std::transform(name.begin(), name.end(), name.begin(), ::tolower);
     std::transform(alpha.begin(), alpha.end(), alpha.begin(), ::tolower);
 
-    auto textureInstPtr = textureLookup ? textureLookup(name, alpha) : nullptr;
-    material.textures.emplace_back(std::move(name), std::move(alpha), textureInstPtr);
+    // Textures are resolved when the geometry is uploaded
+    material.textures.emplace_back(std::move(name), std::move(alpha), nullptr);
 }
 
 void LoaderDFF::readGeometryExtension(const GeometryPtr &geom,
@@ -454,7 +476,26 @@ AtomicPtr LoaderDFF::readAtomic(FrameList &framelist,
     return atomic;
 }
 
-ClumpPtr LoaderDFF::loadFromMemory(const FileContentsInfo& file) {
+ClumpPtr LoaderDFF::loadFromMemory(const FileContentsInfo& file,
+                                   bool keepVertices) {
+    auto model = parseFromMemory(file);
+    if (model) {
+        uploadClump(*model, keepVertices);
+    }
+    return model;
+}
+
+void LoaderDFF::uploadClump(Clump &clump, bool keepVertices) {
+    for (const auto &atomic : clump.getAtomics()) {
+        const auto &geometry = atomic->getGeometry();
+        // Geometry may be shared between atomics, only upload it once
+        if (geometry && geometry->EBO == 0) {
+            uploadGeometry(*geometry, keepVertices);
+        }
+    }
+}
+
+ClumpPtr LoaderDFF::parseFromMemory(const FileContentsInfo& file) {
     auto model = std::make_shared<Clump>();
 
     RWBStream rootStream(file.data.get(), file.length);
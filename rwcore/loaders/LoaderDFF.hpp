@@ -30,7 +30,24 @@ public:
     using GeometryList = std::vector<GeometryPtr>;
     using FrameList = std::vector<ModelFramePtr>;
 
-    ClumpPtr loadFromMemory(const FileContentsInfo& file);
+    ClumpPtr loadFromMemory(const FileContentsInfo& file,
+                            bool keepVertices = false);
+
+    /**
+     * Parses a clump without making any GL calls or resolving textures, so
+     * it may be called from any thread. The result must be passed to
+     * uploadClump() on the GL thread before it is rendered.
+     */
+    ClumpPtr parseFromMemory(const FileContentsInfo& file);
+
+    /**
+     * Creates the GL buffers and resolves the textures for a clump returned
+     * by parseFromMemory(). In headless mode only the textures are resolved.
+     *
+     * @param keepVertices keep each geometry's vertices after they have been
+     * uploaded, for code that reads them on the CPU
+     */
+    void uploadClump(Clump& clump, bool keepVertices = false);
 
     void setTextureLookupCallback(const TextureLookupCallback& tlc) {
         textureLookup = tlc;
@@ -55,6 +72,8 @@ private:
 
     void readBinMeshPLG(const GeometryPtr& geom, const RWBStream& stream);
 
+    void uploadGeometry(Geometry& geom, bool keepVertices);
+
     AtomicPtr readAtomic(FrameList& framelist, GeometryList& geometrylist,
                          const RWBStream& stream);
 };
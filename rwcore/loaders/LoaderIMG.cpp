@@ -5,6 +5,7 @@
 #include <cstring>
 #include <algorithm>
 
+#include <platform/MappedFile.hpp>
 #include <rw/debug.hpp>
 
 namespace {
@@ -56,6 +57,11 @@ bool LoaderIMG::load(const std::filesystem::path& filepath) {
     auto imgPath = filepath;
     imgPath.replace_extension(".img");
 
+    m_mapping = mapFile(imgPath, m_mappingSize);
+    if (m_mapping) {
+        return true;
+    }
+
     m_archive_stream.open(imgPath.string(), std::ios::binary);
     if (!m_archive_stream.is_open()) {
         RW_ERROR("Failed to open " << imgPath.string());
@@ -66,7 +72,7 @@ bool LoaderIMG::load(const std::filesystem::path& filepath) {
 
 /// Get the information of a asset in the examining archive
 bool LoaderIMG::findAssetInfo(const std::string& assetname,
-                              LoaderIMGFile& out) {
+                              LoaderIMGFile& out) const {
     for (const auto& asset : m_assets) {
         if (assetname.compare(asset.name) == 0) {
             out = asset;
@@ -77,8 +83,25 @@ bool LoaderIMG::findAssetInfo(const std::string& assetname,
     return false;
 }
 
+std::shared_ptr<const char[]> LoaderIMG::viewAsset(
+    const LoaderIMGFile& asset) const {
+    if (!m_mapping) {
+        return nullptr;
+    }
+
+    std::size_t begin = std::size_t(asset.offset) * kAssetRecordSize;
+    std::size_t size = std::size_t(asset.size) * kAssetRecordSize;
+    if (begin > m_mappingSize || size > m_mappingSize - begin) {
+        RW_ERROR("Asset " << asset.name << " is outside of the archive");
+        return nullptr;
+    }
+
+    // Shares ownership of the mapping while pointing at the asset
+    return std::shared_ptr<const char[]>(m_mapping, m_mapping.get() + begin);
+}
+
 std::unique_ptr<char[]> LoaderIMG::loadToMemory(const std::string& assetname) {
-    if (!m_archive_stream.is_open()) {
+    if (!m_mapping && !m_archive_stream.is_open()) {
         return nullptr;
     }
 
@@ -92,6 +115,16 @@ std::unique_ptr<char[]> LoaderIMG::loadToMemory(const std::string& assetname) {
 
     std::streamsize asset_size = assetInfo.size * kAssetRecordSize;
     auto raw_data = std::make_unique<char[]>(asset_size);
+
+    if (m_mapping) {
+        auto view = viewAsset(assetInfo);
+        if (!view) {
+            return nullptr;
+        }
+        std::memcpy(raw_data.get(), view.get(), asset_size);
+        return raw_data;
+    }
+
     m_archive_stream.seekg(assetInfo.offset * kAssetRecordSize);
     m_archive_stream.read(raw_data.get(), asset_size);
 
@@ -19,7 +19,9 @@ public:
 /**
     \class LoaderIMG
     \brief Parses the structure of GTA .IMG archives and loads the files in it
-           Warning: loadToMemory() is thread-unsafe, refer to its description.
+           The archive is memory mapped where possible, see viewAsset().
+           Warning: loadToMemory() is thread-unsafe if the archive could not
+           be mapped, refer to its description.
 */
 class LoaderIMG {
 public:
@@ -44,16 +46,28 @@ public:
     /// Load a file from the archive to memory and pass a pointer to it
     /// Warning: Returns nullptr if by any reason it can't load the file
     //
-    /// Warning: CURRENTLY NOT THREADSAFE!
-    //           This method access/modifies m_archive_stream unconditionally,
-    //           be aware of that.
+    /// Warning: NOT THREADSAFE unless isMapped() returns true!
+    //           Without a mapping this method access/modifies
+    //           m_archive_stream, be aware of that.
     std::unique_ptr<char[]> loadToMemory(const std::string& assetname);
 
+    /// Returns a pointer into the mapped archive without copying the asset,
+    /// the pointer keeps the mapping alive after the loader is destroyed.
+    /// The mapping is read-only and shared by every view of the archive.
+    /// Returns nullptr if the archive isn't mapped or the asset is out of
+    /// bounds. Safe to call from multiple threads.
+    std::shared_ptr<const char[]> viewAsset(const LoaderIMGFile& asset) const;
+
+    /// Returns true if the archive has been memory mapped
+    bool isMapped() const {
+        return m_mapping != nullptr;
+    }
+
     /// Writes the contents of assetname to filename
     bool saveAsset(const std::string& assetname, const std::string& filename);
 
     /// Get the information of an asset in the examining archive
-    bool findAssetInfo(const std::string& assetname, LoaderIMGFile& out);
+    bool findAssetInfo(const std::string& assetname, LoaderIMGFile& out) const;
 
     /// Get the information of an asset by its index
     const LoaderIMGFile& getAssetInfoByIndex(size_t index) const {
@@ -73,6 +87,8 @@ private:
     Version m_version = GTAIIIVC;  ///< Version of this IMG archive
     std::filesystem::path m_archive;  ///< Path to the archive being used (no extension)
     std::ifstream m_archive_stream; ///< File stream for archive
+    std::shared_ptr<const char[]> m_mapping; ///< Mapped archive, if available
+    std::size_t m_mappingSize = 0; ///< Size of the mapped archive
 
     std::vector<LoaderIMGFile> m_assets; ///< Asset info of the archive
 };
@@ -11,6 +11,7 @@
 #include "loaders/RWBinaryStream.hpp"
 #include "platform/FileHandle.hpp"
 #include "rw/debug.hpp"
+#include "rw/headless.hpp"
 
 namespace {
 constexpr GLuint gErrorTextureData[] = {0xFFFF00FF, 0xFF000000, 0xFF000000, 0xFFFF00FF};
@@ -22,6 +23,10 @@ constexpr GLuint gTextureBlue[] = {0xFFFF0000};
 
 static
 std::unique_ptr<TextureData> getErrorTexture() {
+    if (isHeadless()) {
+        return TextureData::create(0, {2, 2}, false);
+    }
+
     GLuint errTexName = 0;
     std::unique_ptr<TextureData> tex = nullptr;
     if (errTexName == 0) {
@@ -40,26 +45,30 @@ const size_t paletteSize = 1024;
 
 static
 void processPalette(uint32_t* fullColor, RW::BinaryStreamSection& rootSection) {
-    uint8_t* dataBase = reinterpret_cast<uint8_t*>(
+    const uint8_t* dataBase = reinterpret_cast<const uint8_t*>(
         rootSection.raw() + sizeof(RW::BSSectionHeader) +
         sizeof(RW::BSTextureNative) - 4);
 
-    uint8_t* coldata = (dataBase + paletteSize + sizeof(uint32_t));
-    uint32_t raster_size = *reinterpret_cast<uint32_t*>(dataBase + paletteSize);
-    uint32_t* palette = reinterpret_cast<uint32_t*>(dataBase);
+    const uint8_t* coldata = (dataBase + paletteSize + sizeof(uint32_t));
+    uint32_t raster_size =
+        *reinterpret_cast<const uint32_t*>(dataBase + paletteSize);
+    const uint32_t* palette = reinterpret_cast<const uint32_t*>(dataBase);
 
     for (size_t j = 0; j < raster_size; ++j) {
         *(fullColor++) = palette[coldata[j]];
     }
 }
 
-static std::unique_ptr<TextureData> createTexture(
-    RW::BSTextureNative& texNative, RW::BinaryStreamSection& rootSection) {
+static TextureImage decodeTexture(RW::BSTextureNative& texNative,
+                                  RW::BinaryStreamSection& rootSection) {
+    TextureImage image;
+    image.native = texNative;
+
     // TODO: Exception handling.
     if (texNative.platform != 8) {
         RW_ERROR("Unsupported texture platform " << std::dec
                   << texNative.platform);
-        return getErrorTexture();
+        return image;
     }
 
     bool isPal8 =
@@ -69,60 +78,69 @@ static std::unique_ptr<TextureData> createTexture(
                   texNative.rasterformat == RW::BSTextureNative::FORMAT_8888 ||
                   texNative.rasterformat == RW::BSTextureNative::FORMAT_888;
     // Export this value
-    bool transparent =
+    image.transparent =
         !((texNative.rasterformat & RW::BSTextureNative::FORMAT_888) ==
           RW::BSTextureNative::FORMAT_888);
 
     if (!(isPal8 || isFulc)) {
         RW_ERROR("Unsupported raster format " << std::dec
                   << texNative.rasterformat);
-        return getErrorTexture();
+        return image;
     }
 
-    GLuint textureName = 0;
+    const size_t pixelCount = size_t(texNative.width) * texNative.height;
 
     if (isPal8) {
-        std::vector<uint32_t> fullColor(texNative.width * texNative.height);
-
-        processPalette(fullColor.data(), rootSection);
+        image.pixels.resize(pixelCount * sizeof(uint32_t));
 
-        glGenTextures(1, &textureName);
-        glBindTexture(GL_TEXTURE_2D, textureName);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texNative.width,
-                     texNative.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                     fullColor.data());
-    } else if (isFulc) {
+        processPalette(reinterpret_cast<uint32_t*>(image.pixels.data()),
+                       rootSection);
+    } else {
         auto coldata = rootSection.raw() + sizeof(RW::BSTextureNative);
         coldata += sizeof(uint32_t);
 
-        GLenum type = GL_UNSIGNED_BYTE, format = GL_RGBA;
+        size_t pixelSize = sizeof(uint32_t);
         switch (texNative.rasterformat) {
             case RW::BSTextureNative::FORMAT_1555:
-                format = GL_RGBA;
-                type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+                image.format = GL_RGBA;
+                image.type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+                pixelSize = sizeof(uint16_t);
                 break;
             case RW::BSTextureNative::FORMAT_8888:
-                format = GL_BGRA;
+                image.format = GL_BGRA;
                 // type = GL_UNSIGNED_INT_8_8_8_8_REV;
                 coldata += 8;
-                type = GL_UNSIGNED_BYTE;
+                image.type = GL_UNSIGNED_BYTE;
                 break;
             case RW::BSTextureNative::FORMAT_888:
-                format = GL_BGRA;
-                type = GL_UNSIGNED_BYTE;
+                image.format = GL_BGRA;
+                image.type = GL_UNSIGNED_BYTE;
                 break;
             default:
                 break;
         }
 
-        glGenTextures(1, &textureName);
-        glBindTexture(GL_TEXTURE_2D, textureName);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texNative.width,
-                     texNative.height, 0, format, type, coldata);
-    } else {
-        return getErrorTexture();
+        auto begin = reinterpret_cast<const uint8_t*>(coldata);
+        image.pixels.assign(begin, begin + pixelCount * pixelSize);
+    }
+
+    return image;
+}
+
+static GLenum wrapMode(uint8_t wrap) {
+    switch (wrap) {
+        default:
+        case RW::BSTextureNative::WRAP_WRAP:
+            return GL_REPEAT;
+        case RW::BSTextureNative::WRAP_CLAMP:
+            return GL_CLAMP_TO_EDGE;
+        case RW::BSTextureNative::WRAP_MIRROR:
+            return GL_MIRRORED_REPEAT;
     }
+}
 
+static void setSamplerParameters(GLenum target,
+                                 const RW::BSTextureNative& texNative) {
     GLenum texFilter = GL_LINEAR;
     switch (texNative.filterflags & 0xFF) {
         default:
@@ -134,47 +152,134 @@ static std::unique_ptr<TextureData> createTexture(
             break;
     }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                    GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texFilter);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, texFilter);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, wrapMode(texNative.wrapU));
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, wrapMode(texNative.wrapV));
+}
 
-    GLenum texwrap = GL_REPEAT;
-    switch (texNative.wrapU) {
-        default:
-        case RW::BSTextureNative::WRAP_WRAP:
-            texwrap = GL_REPEAT;
-            break;
-        case RW::BSTextureNative::WRAP_CLAMP:
-            texwrap = GL_CLAMP_TO_EDGE;
-            break;
-        case RW::BSTextureNative::WRAP_MIRROR:
-            texwrap = GL_MIRRORED_REPEAT;
-            break;
+static std::unique_ptr<TextureData> uploadTexture(const TextureImage& image) {
+    if (image.pixels.empty()) {
+        return getErrorTexture();
     }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texwrap);
 
-    switch (texNative.wrapV) {
-        default:
-        case RW::BSTextureNative::WRAP_WRAP:
-            texwrap = GL_REPEAT;
-            break;
-        case RW::BSTextureNative::WRAP_CLAMP:
-            texwrap = GL_CLAMP_TO_EDGE;
-            break;
-        case RW::BSTextureNative::WRAP_MIRROR:
-            texwrap = GL_MIRRORED_REPEAT;
-            break;
+    const auto& texNative = image.native;
+
+    if (isHeadless()) {
+        return TextureData::create(0, {texNative.width, texNative.height},
+                                   image.transparent);
     }
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texwrap);
+
+    GLuint textureName = 0;
+    glGenTextures(1, &textureName);
+    glBindTexture(GL_TEXTURE_2D, textureName);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texNative.width, texNative.height,
+                 0, image.format, image.type, image.pixels.data());
+
+    setSamplerParameters(GL_TEXTURE_2D, texNative);
 
     glGenerateMipmap(GL_TEXTURE_2D);
 
     return TextureData::create(textureName, {texNative.width, texNative.height},
-                               transparent);
+                               image.transparent);
+}
+
+namespace {
+/// The smallest GL_MAX_ARRAY_TEXTURE_LAYERS that GL 3.3 allows
+constexpr std::size_t kMaxArrayLayers = 256;
+
+/// Textures may share an array if they have the same size and sampling
+bool canShareArray(const RW::BSTextureNative& a,
+                   const RW::BSTextureNative& b) {
+    return a.width == b.width && a.height == b.height && a.wrapU == b.wrapU &&
+           a.wrapV == b.wrapV &&
+           (a.filterflags & 0xFF) == (b.filterflags & 0xFF);
+}
+
+void uploadArray(const std::vector<const TextureImage*>& layers,
+                 TextureArchive& inTextures) {
+    const auto& texNative = layers.front()->native;
+
+    GLuint arrayName = 0;
+    glGenTextures(1, &arrayName);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arrayName);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, texNative.width,
+                 texNative.height, static_cast<GLsizei>(layers.size()), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    // Each layer keeps the pixel format it was decoded with
+    for (std::size_t l = 0; l < layers.size(); ++l) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(l),
+                        texNative.width, texNative.height, 1,
+                        layers[l]->format, layers[l]->type,
+                        layers[l]->pixels.data());
+    }
+
+    setSamplerParameters(GL_TEXTURE_2D_ARRAY, texNative);
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    auto array = std::make_shared<TextureArray>(arrayName);
+    for (std::size_t l = 0; l < layers.size(); ++l) {
+        const auto image = layers[l];
+        inTextures[image->name] = std::make_unique<TextureData>(
+            array, static_cast<GLint>(l),
+            glm::ivec2{image->native.width, image->native.height},
+            image->transparent);
+    }
+}
+}  // namespace
+
+static void uploadTextures(const TextureImageList& images,
+                           TextureArchive& inTextures, bool packArrays) {
+    if (!packArrays || isHeadless()) {
+        for (const auto& image : images) {
+            inTextures[image.name] = uploadTexture(image);
+        }
+        return;
+    }
+
+    std::vector<std::vector<const TextureImage*>> groups;
+    for (const auto& image : images) {
+        if (image.pixels.empty()) {
+            inTextures[image.name] = uploadTexture(image);
+            continue;
+        }
+        auto group = std::find_if(
+            groups.begin(), groups.end(), [&](const auto& g) {
+                return g.size() < kMaxArrayLayers &&
+                       canShareArray(g.front()->native, image.native);
+            });
+        if (group == groups.end()) {
+            group = groups.emplace(groups.end());
+        }
+        group->push_back(&image);
+    }
+
+    for (const auto& group : groups) {
+        // An array wouldn't save any binds
+        if (group.size() == 1) {
+            inTextures[group.front()->name] = uploadTexture(*group.front());
+        } else {
+            uploadArray(group, inTextures);
+        }
+    }
 }
 
 bool TextureLoader::loadFromMemory(const FileContentsInfo& file,
-                                   TextureArchive& inTextures) {
+                                   TextureArchive& inTextures,
+                                   bool packArrays) {
+    TextureImageList images;
+    if (!decodeFromMemory(file, images)) {
+        return false;
+    }
+
+    uploadTextures(images, inTextures, packArrays);
+    return true;
+}
+
+bool TextureLoader::decodeFromMemory(const FileContentsInfo& file,
+                                     TextureImageList& outImages) {
     auto data = file.data.get();
     RW::BinaryStreamSection root(data);
     /*auto texDict =*/root.readStructure<RW::BSTextureDictionary>();
@@ -187,13 +292,18 @@ bool TextureLoader::loadFromMemory(const FileContentsInfo& file,
 
         RW::BSTextureNative texNative =
             rootSection.readStructure<RW::BSTextureNative>();
-        std::string name = std::string(texNative.diffuseName);
-        std::string alpha = std::string(texNative.alphaName);
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-        std::transform(alpha.begin(), alpha.end(), alpha.begin(), ::tolower);
+        auto image = decodeTexture(texNative, rootSection);
+        image.name = std::string(texNative.diffuseName);
+        std::transform(image.name.begin(), image.name.end(),
+                       image.name.begin(), ::tolower);
 
-        inTextures[name] = createTexture(texNative, rootSection);
+        outImages.push_back(std::move(image));
     }
 
     return true;
 }
+
+void TextureLoader::upload(const TextureImageList& images,
+                           TextureArchive& inTextures, bool packArrays) {
+    uploadTextures(images, inTextures, packArrays);
+}
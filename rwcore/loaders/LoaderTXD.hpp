@@ -2,11 +2,52 @@
 #define _LIBRW_TEXTURELOADER_HPP_
 
 #include <gl/TextureData.hpp>
+#include <loaders/RWBinaryStream.hpp>
 #include <rw/forward.hpp>
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Pixel data for one texture decoded from a TXD, ready to be uploaded.
+ *
+ * Empty pixel data means the texture could not be decoded, and the error
+ * texture is created in its place.
+ */
+struct TextureImage {
+    std::string name;
+    RW::BSTextureNative native{};
+    GLenum format = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+    bool transparent = false;
+    std::vector<uint8_t> pixels;
+};
+using TextureImageList = std::vector<TextureImage>;
+
 class TextureLoader {
 public:
-    bool loadFromMemory(const FileContentsInfo& file, TextureArchive& inTextures);
+    /**
+     * Loads the textures in a TXD.
+     *
+     * With packArrays, textures that have the same size and sampling are
+     * packed into array textures, which only the world shader can sample.
+     */
+    bool loadFromMemory(const FileContentsInfo& file, TextureArchive& inTextures,
+                        bool packArrays = false);
+
+    /**
+     * Decodes the textures in a TXD without making any GL calls, this may
+     * be called from any thread.
+     */
+    bool decodeFromMemory(const FileContentsInfo& file,
+                          TextureImageList& outImages);
+
+    /**
+     * Creates GL textures for decoded images, must be called on the GL thread
+     */
+    static void upload(const TextureImageList& images,
+                       TextureArchive& inTextures, bool packArrays = false);
 };
 
 #endif
@@ -6,12 +6,15 @@
 
 /**
  * @brief Contains a pointer to a file's contents.
+ *
+ * The contents may be a view into a read-only memory mapped archive shared
+ * with other handles.
  */
 struct FileContentsInfo {
-    std::unique_ptr<char[]> data;
+    std::shared_ptr<const char[]> data;
     size_t length;
 
-    FileContentsInfo(std::unique_ptr<char[]> mem, size_t len)
+    FileContentsInfo(std::shared_ptr<const char[]> mem, size_t len)
         : data(std::move(mem)), length(len) {
     }
 
@@ -98,7 +98,7 @@ FileContentsInfo FileIndex::openFile(const std::string &filePath) {
 
     const auto &indexedData = indexedDataPos->second;
 
-    std::unique_ptr<char[]> data = nullptr;
+    std::shared_ptr<const char[]> data = nullptr;
     size_t length = 0;
 
     if (indexedData.type == IndexedDataType::ARCHIVE) {
@@ -112,7 +112,13 @@ FileContentsInfo FileIndex::openFile(const std::string &filePath) {
         auto filename = std::filesystem::path(indexedData.assetData).filename().string();
         if (loader.findAssetInfo(filename, file)) {
             length = file.size * 2048;
-            data = loader.loadToMemory(filename);
+            if (loader.isMapped()) {
+                data = loader.viewAsset(file);
+            } else {
+                // Without a mapping LoaderIMG reads through a single stream
+                std::lock_guard<std::mutex> lock(archiveMutex_);
+                data = loader.loadToMemory(filename);
+            }
         }
     } else {
         std::ifstream dfile(indexedData.path, std::ios::binary);
@@ -123,8 +129,9 @@ FileContentsInfo FileIndex::openFile(const std::string &filePath) {
         dfile.seekg(0, std::ios::end);
         length = dfile.tellg();
         dfile.seekg(0);
-        data = std::make_unique<char[]>(length);
-        dfile.read(data.get(), length);
+        auto contents = std::make_unique<char[]>(length);
+        dfile.read(contents.get(), length);
+        data = std::move(contents);
     }
 
     return {std::move(data), length};
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 #include <loaders/LoaderIMG.hpp>
 #include <rw/forward.hpp>
@@ -54,6 +55,8 @@ public:
     /**
      * Returns a FileHandle for the file if it can be found in the
      * file index, otherwise an empty FileHandle is returned.
+     * Files inside memory mapped archives are returned without copying.
+     * This may be called from multiple threads once indexing is complete.
      * @param filePath name of the file to open
      * @return FileHandle to the file, nullptr if this FileINdexed has not indexed the path
      */
@@ -99,6 +102,12 @@ private:
      * @brief loaders_ Maps .img filepaths to its respective loader
      */
     std::unordered_map<std::string, LoaderIMG> loaders_;
+
+    /**
+     * @brief archiveMutex_ Serialises reads through archives that could not be
+     * memory mapped
+     */
+    std::mutex archiveMutex_;
 };
 
 #endif
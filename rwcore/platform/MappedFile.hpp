@@ -0,0 +1,17 @@
+#ifndef _LIBRW_MAPPEDFILE_HPP_
+#define _LIBRW_MAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+/**
+ * Maps the whole file read-only, the memory is released when the last
+ * reference to it is dropped.
+ *
+ * @return nullptr if the file is empty or can't be mapped
+ */
+std::shared_ptr<const char[]> mapFile(const std::filesystem::path& path,
+                                      std::size_t& size);
+
+#endif
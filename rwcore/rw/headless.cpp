@@ -0,0 +1,15 @@
+#include "rw/headless.hpp"
+
+#include <atomic>
+
+namespace {
+std::atomic<bool> gHeadless{false};
+}  // namespace
+
+void setHeadless(bool headless) {
+    gHeadless = headless;
+}
+
+bool isHeadless() {
+    return gHeadless;
+}
@@ -0,0 +1,15 @@
+#ifndef _LIBRW_HEADLESS_HPP_
+#define _LIBRW_HEADLESS_HPP_
+
+/**
+ * Headless mode is for running without a GL context or audio device.
+ *
+ * Textures and models are still decoded, but only kept on the CPU: no GL
+ * or OpenAL objects are created. It has to be set before any data is
+ * loaded and stays set for the lifetime of the process.
+ */
+void setHeadless(bool headless);
+
+bool isHeadless();
+
+#endif
@@ -47,8 +47,8 @@ void PlayerController::enterNearestVehicle() {
         VehicleObject* nearest = nullptr;
         float d = 10.f;
 
-        for (auto& p : world->vehiclePool.objects) {
-            auto object = p.second.get();
+        for (auto& p : world->vehiclePool) {
+            auto object = p.get();
             float vd =
                 glm::length(character->getPosition() - object->getPosition());
             if (vd < d) {
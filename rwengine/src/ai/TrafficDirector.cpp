@@ -49,21 +49,11 @@ std::vector<ai::AIGraphNode*> TrafficDirector::findAvailableNodes(
         bool blocked = false;
         float dist2 = glm::distance2(camera.position, (*it)->position);
 
-        for (const auto& obj : world->pedestrianPool.objects) {
-            if (glm::distance2((*it)->position, obj.second->getPosition()) <=
-                minDist) {
-                blocked = true;
-                break;
-            }
-        }
-
-        for (const auto& obj : world->vehiclePool.objects) {
-            if (glm::distance2((*it)->position, obj.second->getPosition()) <=
-                minDist) {
-                blocked = true;
-                break;
-            }
-        }
+        const auto& node = (*it)->position;
+        blocked = world->objectGrid.anyInRadius(
+            node, std::sqrt(minDist), [&](GameObject* object) {
+                return glm::distance2(node, object->getPosition()) <= minDist;
+            });
 
         // Check that we're not going to spawn something right where the player
         // is looking
@@ -135,7 +125,7 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
     std::vector<uint16_t> peds = {1};
 
     // Determine which zone the viewpoint is in
-    auto zone = world->data->findZoneAt(camera.position);
+    auto zone = world->data->findZoneAt(camera.position, zoneHint);
     bool day = (world->state->basic.gameHour >= 8 &&
                 world->state->basic.gameHour <= 19);
     int groupid = zone ? (day ? zone->pedGroupDay : zone->pedGroupNight) : 0;
@@ -151,8 +141,8 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
     auto availablePedsNodes = findAvailableNodes(ai::NodeType::Pedestrian, camera, radius);
 
     // We have not reached the limit of spawned pedestrians
-    if (maximumPedestrians > world->pedestrianPool.objects.size()) {
-        const auto availablePeds = maximumPedestrians - world->pedestrianPool.objects.size();
+    if (maximumPedestrians > world->pedestrianPool.size()) {
+        const auto availablePeds = maximumPedestrians - world->pedestrianPool.size();
 
         size_t counter = availablePeds;
         // maxSpawn can be -1 for "as many as possible"
@@ -167,11 +157,16 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
             if (counter == 0) {
                 break;
             }
-            counter--;
 
             // Spawn a pedestrian from the available pool
             const auto pedId =
                 peds.at(world->getRandomNumber(0u, peds.size() - 1));
+            // Try again later rather than stalling on the load
+            if (!world->data->streamer.request(pedId)) {
+                continue;
+            }
+            counter--;
+
             auto ped = world->createPedestrian(pedId, spawn->position);
             ped->applyOffset();
             ped->setLifetime(GameObject::TrafficLifetime);
@@ -183,8 +178,8 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
     auto availableVehicleNodes = findAvailableNodes(ai::NodeType::Vehicle, camera, radius);
 
     // We have not reached the limit of spawned vehicles
-    if (maximumCars > world->vehiclePool.objects.size()) {
-        const auto availableCars = maximumCars - world->vehiclePool.objects.size();
+    if (maximumCars > world->vehiclePool.size()) {
+        const auto availableCars = maximumCars - world->vehiclePool.size();
 
         size_t counter = availableCars;
         // maxSpawn can be -1 for "as many as possible"
@@ -199,6 +194,18 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
             if (counter == 0) {
                 break;
             }
+
+            // Pick the vehicle and driver first, so nothing is spawned
+            // until both have been streamed in
+            const auto carId =
+                cars.at(world->getRandomNumber(0u, cars.size() - 1));
+            const auto pedId =
+                peds.at(world->getRandomNumber(0u, peds.size() - 1));
+            const bool carReady = world->data->streamer.request(carId);
+            const bool pedReady = world->data->streamer.request(pedId);
+            if (!carReady || !pedReady) {
+                continue;
+            }
             counter--;
 
             // Get the next node, to spawn in between
@@ -236,16 +243,12 @@ std::vector<GameObject*> TrafficDirector::populateNearby(
                 strafe * (2.5f + 5.f * static_cast<float>(lane - 1));
 
             // Spawn a vehicle from the available pool
-            const auto carId =
-                cars.at(world->getRandomNumber(0u, cars.size() - 1));
             auto vehicle = world->createVehicle(carId, next->position + diff + laneOffset, orientation);
             vehicle->applyOffset();
             vehicle->setLifetime(GameObject::TrafficLifetime);
             vehicle->setHandbraking(false);
 
             // Spawn a pedestrian and put it into the vehicle
-            const auto pedId =
-                peds.at(world->getRandomNumber(0u, peds.size() - 1));
             CharacterObject* character = world->createPedestrian(pedId, vehicle->getPosition());
             character->setLifetime(GameObject::TrafficLifetime);
             character->setCurrentVehicle(vehicle, 0);
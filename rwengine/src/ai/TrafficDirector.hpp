@@ -4,6 +4,8 @@
 #include <vector>
 #include <cstddef>
 
+#include <data/ZoneGrid.hpp>
+
 class GameWorld;
 class GameObject;
 class ViewCamera;
@@ -45,6 +47,8 @@ private:
     float carDensity = 1.f;
     size_t maximumPedestrians = 20;
     size_t maximumCars = 10;
+    /// The camera usually stays in the same zone between populations
+    ZoneGrid::Hint zoneHint;
 };
 
 }  // namespace ai
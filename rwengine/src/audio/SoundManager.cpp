@@ -16,6 +16,7 @@ extern "C" {
 #include "engine/GameWorld.hpp"
 #include "render/ViewCamera.hpp"
 
+#include <rw/headless.hpp>
 #include <rw/types.hpp>
 
 Sound& SoundManager::getSfxBufferRef(size_t name) {
@@ -55,6 +56,10 @@ SoundManager::~SoundManager() {
 }
 
 bool SoundManager::initializeOpenAL() {
+    if (isHeadless()) {
+        return false;
+    }
+
     alDevice = alcOpenDevice(nullptr);
     if (!alDevice) {
         RW_ERROR("Could not find OpenAL device!");
@@ -112,6 +117,10 @@ void SoundManager::deinitializeOpenAL() {
 
 bool SoundManager::loadSound(const std::string& name,
                              const std::string& fileName, bool streamed) {
+    if (isHeadless()) {
+        return false;
+    }
+
     Sound* sound = nullptr;
     auto sound_iter = sounds.find(name);
 
@@ -146,6 +155,11 @@ void SoundManager::loadSound(size_t index) {
 }
 
 size_t SoundManager::createSfxInstance(size_t index) {
+    if (isHeadless()) {
+        // Hand out an id that will never be found by playSfx()
+        return bufferNr++;
+    }
+
     Sound* sound = nullptr;
     auto soundRef = sfx.find(index);
 
@@ -21,6 +21,8 @@ class ViewCamera;
 /// these containg raw source and openAL buffer for playing (only one instance
 /// simultaneously), these containg only source or buffer. (It allows multiple
 /// instances simultaneously without duplicating raw source).
+/// In headless mode no device is opened and no sounds are loaded, so every
+/// request to play one is ignored.
 class SoundManager {
 public:
     SoundManager();
@@ -0,0 +1,117 @@
+#include "core/JobSystem.hpp"
+
+#include <algorithm>
+
+#include "core/Profiler.hpp"
+
+JobSystem::JobSystem(unsigned int workers) {
+    startWorkers(workers);
+}
+
+JobSystem::~JobSystem() {
+    stopWorkers();
+}
+
+void JobSystem::setWorkerCount(unsigned int workers) {
+    if (workers == workers_.size()) {
+        return;
+    }
+
+    stopWorkers();
+    startWorkers(workers);
+}
+
+void JobSystem::startWorkers(unsigned int workers) {
+    running_ = true;
+    for (auto i = 0u; i < workers; ++i) {
+        workers_.emplace_back(&JobSystem::workerMain, this);
+    }
+}
+
+void JobSystem::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    batchReady_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t chunks,
+                            const ChunkFunction& function) {
+    chunks = std::min(chunks, count);
+    if (chunks == 0) {
+        return;
+    }
+
+    if (chunks == 1 || workers_.empty()) {
+        for (std::size_t c = 0; c < chunks; ++c) {
+            function(c, count * c / chunks, count * (c + 1) / chunks);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        function_ = &function;
+        count_ = count;
+        chunks_ = chunks;
+        nextChunk_ = 0;
+        remaining_ = chunks;
+        generation_++;
+    }
+    batchReady_.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    batchDone_.wait(lock, [this] { return remaining_ == 0 && busy_ == 0; });
+    function_ = nullptr;
+}
+
+void JobSystem::runChunks() {
+    for (;;) {
+        auto c = nextChunk_++;
+        if (c >= chunks_) {
+            return;
+        }
+
+        (*function_)(c, count_ * c / chunks_, count_ * (c + 1) / chunks_);
+
+        if (--remaining_ == 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batchDone_.notify_all();
+        }
+    }
+}
+
+void JobSystem::workerMain() {
+    RW_PROFILE_THREAD("Jobs");
+
+    std::size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            batchReady_.wait(lock, [&] {
+                return !running_ || (generation_ != seen && function_);
+            });
+            if (!running_) {
+                return;
+            }
+            seen = generation_;
+            busy_++;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_--;
+        }
+        batchDone_.notify_all();
+    }
+}
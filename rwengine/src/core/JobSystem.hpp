@@ -0,0 +1,92 @@
+#ifndef _RWENGINE_JOBSYSTEM_HPP_
+#define _RWENGINE_JOBSYSTEM_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs data parallel work on a fixed set of worker threads
+ *
+ * Work is submitted with parallelFor(), which blocks until all of it has
+ * been completed. The calling thread takes part in the work, so a JobSystem
+ * without workers simply runs everything on the caller.
+ *
+ * parallelFor() must not be called from inside a job.
+ */
+class JobSystem {
+public:
+    /**
+     * Called with the chunk index and the [begin, end) range of the chunk
+     */
+    using ChunkFunction =
+        std::function<void(std::size_t chunk, std::size_t begin, std::size_t end)>;
+
+    explicit JobSystem(unsigned int workers = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @return the number of threads taking part in parallelFor()
+     */
+    std::size_t getConcurrency() const {
+        return workers_.size() + 1;
+    }
+
+    /**
+     * Stops the current workers and starts the given number of new ones.
+     *
+     * Must not be called while parallelFor() is running.
+     */
+    void setWorkerCount(unsigned int workers);
+
+    /**
+     * Splits [0, count) into chunks ranges of similar size and calls
+     * function once for each, returning when they have all finished.
+     */
+    void parallelFor(std::size_t count, std::size_t chunks,
+                     const ChunkFunction& function);
+
+    /**
+     * Same as above, using one chunk per thread
+     */
+    void parallelFor(std::size_t count, const ChunkFunction& function) {
+        parallelFor(count, getConcurrency(), function);
+    }
+
+private:
+    void startWorkers(unsigned int workers);
+
+    void stopWorkers();
+
+    void workerMain();
+
+    /// Runs chunks of the current batch until there are none left
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable batchReady_;
+    std::condition_variable batchDone_;
+    bool running_ = true;
+
+    /// Incremented for each batch so workers can tell it apart from the last
+    std::size_t generation_ = 0;
+
+    const ChunkFunction* function_ = nullptr;
+    std::size_t count_ = 0;
+    std::size_t chunks_ = 0;
+    std::atomic<std::size_t> nextChunk_{0};
+    std::atomic<std::size_t> remaining_{0};
+    /// Workers inside runChunks(), the batch can't be replaced until it's 0
+    std::size_t busy_ = 0;
+};
+
+#endif
@@ -8,16 +8,19 @@ void Logger::log(const std::string& component, Logger::MessageSeverity severity,
                  const std::string& message) {
     LogMessage m{component, severity, message};
 
+    std::lock_guard<std::mutex> lock(mutex);
     for (MessageReceiver* r : receivers) {
         r->messageReceived(m);
     }
 }
 
 void Logger::addReceiver(Logger::MessageReceiver* out) {
+    std::lock_guard<std::mutex> lock(mutex);
     receivers.push_back(out);
 }
 
 void Logger::removeReceiver(Logger::MessageReceiver* out) {
+    std::lock_guard<std::mutex> lock(mutex);
     receivers.erase(std::remove(receivers.begin(), receivers.end(), out),
                     receivers.end());
 }
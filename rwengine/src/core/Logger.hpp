@@ -3,6 +3,7 @@
 
 #include <array>
 #include <initializer_list>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -10,7 +11,8 @@
 /**
  * Handles and stores messages from different components
  *
- * Dispatches received messages to logger outputs.
+ * Dispatches received messages to logger outputs. Messages can be logged
+ * from any thread, receivers are called one message at a time.
  */
 class Logger {
 public:
@@ -59,6 +61,7 @@ public:
     void error(const std::string& component, const std::string& message);
 
 private:
+    std::mutex mutex;
     std::vector<MessageReceiver*> receivers;
 };
 
@@ -0,0 +1,128 @@
+#include "core/TaskGraph.hpp"
+
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+
+namespace {
+/// Runs the step's function, returning how long it took in milliseconds
+double runTimed(const TaskGraph::Function& function,
+                std::exception_ptr& error) {
+    RW_PROFILE_SCOPE("TaskGraph step");
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        function();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+}  // namespace
+
+void TaskGraph::add(std::string name, std::vector<std::string> dependencies,
+                    Function function, Thread thread) {
+    steps_.push_back(Step{std::move(name), std::move(dependencies),
+                          std::move(function), thread});
+    names_.emplace(steps_.back().name, &steps_.back());
+}
+
+bool TaskGraph::isReady(const Step& step) const {
+    for (const auto& dependency : step.dependencies) {
+        auto it = names_.find(dependency);
+        if (it != names_.end() && !it->second->done) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TaskGraph::run(JobSystem* jobs) {
+    for (std::size_t wave = 0;; ++wave) {
+        std::vector<Step*> mainSteps;
+        std::vector<Step*> anySteps;
+        for (auto& step : steps_) {
+            if (step.done || !isReady(step)) {
+                continue;
+            }
+            (step.thread == Thread::Main ? mainSteps : anySteps)
+                .push_back(&step);
+        }
+
+        if (mainSteps.empty() && anySteps.empty()) {
+            for (const auto& step : steps_) {
+                if (!step.done) {
+                    throw std::runtime_error("TaskGraph step " + step.name +
+                                             " is part of a dependency cycle");
+                }
+            }
+            return;
+        }
+
+        std::vector<Timing> anyTimings(anySteps.size());
+        std::vector<std::exception_ptr> anyErrors(anySteps.size());
+        auto runAny = [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                anyTimings[i] = {anySteps[i]->name,
+                                 runTimed(anySteps[i]->function, anyErrors[i]),
+                                 wave, Thread::Any};
+            }
+        };
+        auto runAllAny = [&] {
+            if (jobs) {
+                jobs->parallelFor(anySteps.size(), anySteps.size(),
+                                  [&](std::size_t, std::size_t begin,
+                                      std::size_t end) { runAny(begin, end); });
+            } else {
+                runAny(0, anySteps.size());
+            }
+        };
+
+        // The steps for any thread are started from a helper thread, which
+        // isn't a job and so can call parallelFor, leaving this thread free
+        // for the main thread steps
+        std::thread helper;
+        if (jobs && !mainSteps.empty() && !anySteps.empty()) {
+            helper = std::thread(runAllAny);
+        }
+
+        std::exception_ptr error;
+        for (auto step : mainSteps) {
+            std::exception_ptr stepError;
+            const auto ms = runTimed(step->function, stepError);
+            timings_.push_back({step->name, ms, wave, Thread::Main});
+            if (stepError && !error) {
+                error = stepError;
+            }
+        }
+
+        if (helper.joinable()) {
+            helper.join();
+        } else {
+            runAllAny();
+        }
+
+        for (std::size_t i = 0; i < anySteps.size(); ++i) {
+            timings_.push_back(std::move(anyTimings[i]));
+            if (anyErrors[i] && !error) {
+                error = anyErrors[i];
+            }
+        }
+
+        for (auto step : mainSteps) {
+            step->done = true;
+        }
+        for (auto step : anySteps) {
+            step->done = true;
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
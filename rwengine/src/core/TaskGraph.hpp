@@ -0,0 +1,83 @@
+#ifndef _RWENGINE_TASKGRAPH_HPP_
+#define _RWENGINE_TASKGRAPH_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * @brief Runs named steps once the steps they depend on have finished
+ *
+ * Steps run in waves. Each wave holds every step whose dependencies are
+ * done. Steps marked Thread::Main run one after another on the thread that
+ * called run(), for work such as creating GL objects. At the same time, the
+ * other steps of the wave run on the JobSystem.
+ *
+ * Main thread steps may add more steps, which run in the following waves.
+ */
+class TaskGraph {
+public:
+    enum class Thread {
+        /// Runs on any thread, together with the other steps of its wave
+        Any,
+        /// Runs on the thread that called run()
+        Main
+    };
+
+    using Function = std::function<void()>;
+
+    /**
+     * How long a step took, in the order the steps finished
+     */
+    struct Timing {
+        std::string name;
+        double milliseconds = 0.;
+        std::size_t wave = 0;
+        Thread thread = Thread::Any;
+    };
+
+    /**
+     * Adds a step that runs after all of the steps named in dependencies.
+     * Names that don't belong to a step are ignored.
+     */
+    void add(std::string name, std::vector<std::string> dependencies,
+             Function function, Thread thread = Thread::Any);
+
+    /**
+     * Runs every step, using jobs for the steps that can run on any thread.
+     * Without a JobSystem every step runs on the calling thread.
+     *
+     * If a step throws, the rest of its wave still runs, then the exception
+     * is rethrown and no more steps are started.
+     *
+     * @throws std::runtime_error if the remaining steps depend on each other
+     */
+    void run(JobSystem* jobs = nullptr);
+
+    const std::vector<Timing>& getTimings() const {
+        return timings_;
+    }
+
+private:
+    struct Step {
+        std::string name;
+        std::vector<std::string> dependencies;
+        Function function;
+        Thread thread;
+        bool done = false;
+    };
+
+    bool isReady(const Step& step) const;
+
+    /// Steps are only added at the end, so they keep their address
+    std::deque<Step> steps_;
+    std::unordered_map<std::string, const Step*> names_;
+    std::vector<Timing> timings_;
+};
+
+#endif
@@ -81,7 +81,7 @@ public:
         return collision.get();
     }
 
-    /// @todo replace with proper streaming implementation
+    /// Models are loaded on demand, see ModelStreamer::request()
     virtual bool isLoaded() const = 0;
 
     virtual void unload() = 0;
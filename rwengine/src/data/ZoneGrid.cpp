@@ -0,0 +1,139 @@
+#include "data/ZoneGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "data/ZoneData.hpp"
+
+namespace {
+/// Lists the zones with each child's subtree before its parent
+void appendPostOrder(ZoneData& zone, std::vector<ZoneData*>& order) {
+    for (ZoneData* child : zone.children_) {
+        appendPostOrder(*child, order);
+    }
+    order.push_back(&zone);
+}
+}  // namespace
+
+void ZoneGrid::build(ZoneData& root) {
+    clear();
+
+    min_ = glm::vec2(root.min);
+    max_ = glm::vec2(root.max);
+    cellSize_ = glm::max((max_ - min_) / static_cast<float>(kCellsPerAxis),
+                         glm::vec2(1e-3f));
+
+    std::vector<ZoneData*> zones;
+    appendPostOrder(root, zones);
+
+    auto cellRange = [&](const ZoneData& zone, glm::ivec2& first,
+                         glm::ivec2& last) {
+        const auto maxCell = static_cast<int>(kCellsPerAxis) - 1;
+        auto toCell = [&](const glm::vec3& p) {
+            return glm::clamp(
+                glm::ivec2(glm::floor((glm::vec2(p) - min_) / cellSize_)), 0,
+                maxCell);
+        };
+        first = toCell(zone.min);
+        last = toCell(zone.max);
+    };
+
+    // Count the zones in each cell, then fill them in order
+    std::vector<std::uint32_t> counts(kCellsPerAxis * kCellsPerAxis, 0);
+    for (const ZoneData* zone : zones) {
+        glm::ivec2 first, last;
+        cellRange(*zone, first, last);
+        for (auto y = first.y; y <= last.y; ++y) {
+            for (auto x = first.x; x <= last.x; ++x) {
+                counts[y * kCellsPerAxis + x]++;
+            }
+        }
+    }
+
+    cellStarts_.resize(counts.size() + 1);
+    cellStarts_[0] = 0;
+    for (std::size_t c = 0; c < counts.size(); ++c) {
+        cellStarts_[c + 1] = cellStarts_[c] + counts[c];
+        counts[c] = cellStarts_[c];
+    }
+
+    candidates_.resize(cellStarts_.back());
+    for (ZoneData* zone : zones) {
+        glm::ivec2 first, last;
+        cellRange(*zone, first, last);
+        for (auto y = first.y; y <= last.y; ++y) {
+            for (auto x = first.x; x <= last.x; ++x) {
+                candidates_[counts[y * kCellsPerAxis + x]++] = zone;
+            }
+        }
+    }
+}
+
+void ZoneGrid::clear() {
+    cellStarts_.clear();
+    candidates_.clear();
+    generation_++;
+}
+
+bool ZoneGrid::cellAt(const glm::vec3& point, std::size_t& cell) const {
+    if (point.x < min_.x || point.y < min_.y || point.x > max_.x ||
+        point.y > max_.y) {
+        return false;
+    }
+    const auto maxCell = kCellsPerAxis - 1;
+    const auto x = std::min(
+        static_cast<std::size_t>((point.x - min_.x) / cellSize_.x), maxCell);
+    const auto y = std::min(
+        static_cast<std::size_t>((point.y - min_.y) / cellSize_.y), maxCell);
+    cell = y * kCellsPerAxis + x;
+    return true;
+}
+
+ZoneData* ZoneGrid::findInCell(std::size_t cell, const glm::vec3& point,
+                               std::size_t& candidate) const {
+    const auto begin = cellStarts_[cell];
+    const auto end = cellStarts_[cell + 1];
+    for (auto i = begin; i < end; ++i) {
+        if (candidates_[i]->containsPoint(point)) {
+            candidate = i - begin;
+            return candidates_[i];
+        }
+    }
+    return nullptr;
+}
+
+ZoneData* ZoneGrid::find(const glm::vec3& point) const {
+    std::size_t cell;
+    if (empty() || !cellAt(point, cell)) {
+        return nullptr;
+    }
+    std::size_t candidate;
+    return findInCell(cell, point, candidate);
+}
+
+ZoneData* ZoneGrid::find(const glm::vec3& point, Hint& hint) const {
+    std::size_t cell;
+    if (empty() || !cellAt(point, cell)) {
+        hint.zone = nullptr;
+        return nullptr;
+    }
+
+    // The last zone is still the answer if it contains the point and none
+    // of the zones ahead of it do
+    if (hint.generation == generation_ && hint.zone && hint.cell == cell &&
+        hint.zone->containsPoint(point)) {
+        const auto begin = cellStarts_[cell];
+        const auto ahead = std::any_of(
+            candidates_.begin() + begin,
+            candidates_.begin() + begin + hint.candidate,
+            [&](const ZoneData* zone) { return zone->containsPoint(point); });
+        if (!ahead) {
+            return hint.zone;
+        }
+    }
+
+    hint.generation = generation_;
+    hint.cell = cell;
+    hint.zone = findInCell(cell, point, hint.candidate);
+    return hint.zone;
+}
@@ -0,0 +1,74 @@
+#ifndef _RWENGINE_ZONEGRID_HPP_
+#define _RWENGINE_ZONEGRID_HPP_
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ZoneData;
+
+/**
+ * @brief Grid over a zone hierarchy, for finding the zone at a point without
+ * descending the hierarchy
+ *
+ * The root zone's X and Y extents are split into cells. Each cell lists the
+ * zones that overlap it, in the order ZoneData::findLeafAtPoint would visit
+ * them: children before their parent, and siblings in order. The first zone
+ * in the list that contains the point is the one findLeafAtPoint returns.
+ *
+ * The grid holds pointers into the hierarchy, so it must be built again
+ * whenever the hierarchy changes.
+ */
+class ZoneGrid {
+public:
+    static constexpr std::size_t kCellsPerAxis = 64;
+
+    /**
+     * The result of a caller's last query. A caller that queries nearby
+     * points can keep one to check its last zone first.
+     */
+    struct Hint {
+        std::uint32_t generation = 0;
+        std::size_t cell = 0;
+        /// Position of zone in its cell's list
+        std::size_t candidate = 0;
+        ZoneData* zone = nullptr;
+    };
+
+    void build(ZoneData& root);
+
+    void clear();
+
+    bool empty() const {
+        return candidates_.empty();
+    }
+
+    /**
+     * @return the same zone as root.findLeafAtPoint(point)
+     */
+    ZoneData* find(const glm::vec3& point) const;
+
+    ZoneData* find(const glm::vec3& point, Hint& hint) const;
+
+private:
+    bool cellAt(const glm::vec3& point, std::size_t& cell) const;
+
+    ZoneData* findInCell(std::size_t cell, const glm::vec3& point,
+                         std::size_t& candidate) const;
+
+    glm::vec2 min_{};
+    glm::vec2 max_{};
+    glm::vec2 cellSize_{1.f};
+
+    /// Cell c's zones are candidates_[cellStarts_[c]] to cellStarts_[c + 1]
+    std::vector<std::uint32_t> cellStarts_;
+    std::vector<ZoneData*> candidates_;
+
+    /// Changes on every build, so that old hints are ignored
+    std::uint32_t generation_ = 0;
+};
+
+#endif
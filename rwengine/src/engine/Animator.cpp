@@ -14,31 +14,41 @@
 Animator::Animator(const ClumpPtr& _model) : model(_model) {
 }
 
-void Animator::tick(float dt) {
-    if (model == nullptr || animations.empty()) {
+void Animator::advance(float dt) {
+    if (model == nullptr) {
         return;
     }
 
-    struct BoneTransform {
-        glm::vec3 translation{};
-        glm::quat rotation{1.0f,0.0f,0.0f,0.0f};
-    };
+    for (AnimationState& state : animations) {
+        if (state.animation == nullptr) continue;
+
+        state.time = state.time + dt;
+    }
+}
+
+void Animator::sample() {
+    if (model == nullptr || animations.empty()) {
+        return;
+    }
 
     for (AnimationState& state : animations) {
         if (state.animation == nullptr) continue;
 
-        if (state.boneInstances.empty()) {
-            for (auto& [name, bone] : state.animation->bones) {
-                auto frame = model->findFrame(name);
+        const auto& tracks = state.animation->getTracks();
+
+        if (!state.bound) {
+            for (uint32_t t = 0; t < tracks.size(); ++t) {
+                auto frame = model->findFrame(tracks.names[t]);
                 if (!frame) {
                     continue;
                 }
-                state.boneInstances.emplace(&bone, frame);
+                state.tracks.push_back(t);
+                state.frames.push_back(frame);
             }
+            state.cursors.assign(state.tracks.size(), 0);
+            state.bound = true;
         }
 
-        state.time = state.time + dt;
-
         float animTime = state.time;
         if (!state.repeat) {
             animTime = std::min(animTime, state.animation->duration);
@@ -46,18 +56,17 @@ void Animator::tick(float dt) {
             animTime = std::fmod(animTime, state.animation->duration);
         }
 
-        for (auto& [bonePtr, frame] : state.boneInstances) {
-            if (bonePtr->frames.empty()) continue;
-            auto kf = bonePtr->getInterpolatedKeyframe(animTime);
+        const auto count = state.tracks.size();
+        rotations.resize(count);
+        translations.resize(count);
+        tracks.sample(animTime, state.tracks.data(), count, rotations.data(),
+                      translations.data(), state.cursors.data());
 
-            BoneTransform xform;
-            xform.rotation = kf.rotation;
-            if (bonePtr->type != AnimationBone::R00) {
-                xform.translation = kf.position;
-            }
+        for (size_t i = 0; i < count; ++i) {
+            auto frame = state.frames[i];
             frame->setTranslation(frame->getDefaultTranslation() +
-                                     xform.translation);
-            frame->setRotation(glm::mat3_cast(xform.rotation));
+                                  translations[i]);
+            frame->setRotation(glm::mat3_cast(rotations[i]));
         }
     }
 }
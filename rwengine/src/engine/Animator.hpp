@@ -4,10 +4,12 @@
 #include <rw/debug.hpp>
 #include <rw/forward.hpp>
 
-#include <map>
+#include <cstdint>
 #include <vector>
 
-struct AnimationBone;
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
 class ModelFrame;
 
 /**
@@ -33,7 +35,13 @@ class Animator {
         float speed;
         /// Automatically restart
         bool repeat;
-        std::map<AnimationBone*, ModelFrame*> boneInstances;
+        /// Tracks of the animation that have a frame in the model
+        std::vector<uint32_t> tracks{};
+        /// The frame animated by each of tracks
+        std::vector<ModelFrame*> frames{};
+        /// Keyframe cursor of each of tracks, kept between samples
+        std::vector<uint32_t> cursors{};
+        bool bound = false;
     };
 
     /**
@@ -46,6 +54,10 @@ class Animator {
      */
     std::vector<AnimationState> animations;
 
+    /// Sampled values for the tracks of one animation, kept between ticks
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> translations;
+
 public:
     Animator(const ClumpPtr& _model);
 
@@ -61,7 +73,7 @@ public:
         if (slot >= animations.size()) {
             animations.resize(slot + 1);
         }
-        animations[slot] = {anim, 0.f, speed, repeat, {}};
+        animations[slot] = {anim, 0.f, speed, repeat};
     }
 
     void setAnimationSpeed(unsigned int slot, float speed) {
@@ -75,7 +87,23 @@ public:
      * @brief tick Update animation paramters for server-side data.
      * @param dt
      */
-    void tick(float dt);
+    void tick(float dt) {
+        advance(dt);
+        sample();
+    }
+
+    /**
+     * Moves the time of the playing animations forward, without changing
+     * the model
+     */
+    void advance(float dt);
+
+    /**
+     * Sets the model's frames to the playing animations at their current
+     * time. This only changes the animator and its model, so animators can
+     * be sampled on different threads.
+     */
+    void sample();
 
     /**
      * Returns true if the animation has finished playing.
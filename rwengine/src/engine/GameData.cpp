@@ -19,6 +19,7 @@
 
 #include "core/Logger.hpp"
 #include "core/Profiler.hpp"
+#include "core/TaskGraph.hpp"
 #include "data/CollisionModel.hpp"
 #include "engine/GameState.hpp"
 #include "engine/GameWorld.hpp"
@@ -34,103 +35,223 @@
 #include "platform/FileIndex.hpp"
 
 GameData::GameData(Logger* log, const std::filesystem::path& path)
-    : datpath(path), logger(log) {
+    : datpath(path), logger(log), streamer(*this, log) {
     dffLoader.setTextureLookupCallback(
         [&](const std::string& texture, const std::string&) {
             return findSlotTexture(currenttextureslot, texture);
         });
 }
 
+struct GameData::LevelCommand {
+    std::string type;
+    std::string argument;
+    int zone = 0;
+
+    std::unique_ptr<LoaderIDE> ide;
+    std::unique_ptr<LoaderCOL> col;
+    bool parsed = false;
+
+    /// IDE and COL files can be parsed before the commands are run
+    bool canParseAhead() const {
+        return type == "IDE" || type == "COLFILE";
+    }
+};
+
 bool GameData::load() {
     if (!isValidGameDirectory()) {
         return false;
     }
 
-    index.indexTree(datpath);
-
-    loadIMG("models/gta3.img");
-    /// @todo cuts.img files should be loaded differently to gta3.img
-    loadIMG("anim/cuts.img");
-
-    textureSlots["particle"] = loadTextureArchive("particle.txd");
-    textureSlots["icons"] = loadTextureArchive("icons.txd");
-    textureSlots["hud"] = loadTextureArchive("hud.txd");
-    textureSlots["fonts"] = loadTextureArchive("fonts.txd");
-    textureSlots["generic"] = loadTextureArchive("generic.txd");
-    loadToTextureArchive("misc.txd", textureSlots["generic"]);
-
-    loadCarcols("data/carcols.dat");
-    loadWeather("data/timecyc.dat");
-    loadHandling("data/handling.cfg");
-    loadWaterpro("data/waterpro.dat");
-    loadWeaponDAT("data/weapon.dat");
-    loadPedStats("data/pedstats.dat");
-    loadPedRelations("data/ped.dat");
-
-    loadIFP("ped.ifp");
-
-    /// @todo load real data
-    pedAnimGroups["player"] = std::make_unique<AnimGroup>(
-        AnimGroup::getBuiltInAnimGroup(animations, "player"));
-
     // Clear existing zones
     gamezones = ZoneDataList{
         {"CITYZON", 0, {-4000.f, -4000.f, -500.f}, {4000.f, 4000.f, 500.f}, 0, 0, 0}};
+    buildZoneHierarchy();
+
+    using Thread = TaskGraph::Thread;
+    TaskGraph graph;
+    std::vector<std::vector<LevelCommand>> levelFiles;
+
+    // Every other step finds its files through the index. The level files
+    // are read here so that their IDE and COL files can be parsed while the
+    // rest of the data loads.
+    graph.add(
+        "index", {},
+        [&] {
+            index.indexTree(datpath);
+
+            loadIMG("models/gta3.img");
+            /// @todo cuts.img files should be loaded differently to gta3.img
+            loadIMG("anim/cuts.img");
+
+            levelFiles.push_back(readLevelFile("data/default.dat"));
+            levelFiles.push_back(readLevelFile("data/gta3.dat"));
+
+            // Textures from the level files are added to the slots below
+            std::vector<std::string> parsed{"textures"};
+            for (auto& commands : levelFiles) {
+                for (auto& command : commands) {
+                    if (!command.canParseAhead()) {
+                        continue;
+                    }
+                    auto name = command.type + " " + command.argument;
+                    if (std::find(parsed.begin(), parsed.end(), name) !=
+                        parsed.end()) {
+                        name += " #" + std::to_string(parsed.size());
+                    }
+                    // IDE files need the ped stats to define pedestrians
+                    graph.add(name, {"pedstats"}, [this, &command] {
+                        parseLevelCommand(command);
+                    });
+                    parsed.push_back(std::move(name));
+                }
+            }
 
-    loadLevelFile("data/default.dat");
-    loadLevelFile("data/gta3.dat");
-
-    // Load ped groups after IDEs so they can resolve
-    loadPedGroups("data/pedgrp.dat");
+            graph.add("levels", std::move(parsed),
+                      [&] {
+                          for (auto& commands : levelFiles) {
+                              runLevelFile(commands);
+                          }
+                      },
+                      Thread::Main);
+
+            // Load ped groups after IDEs so they can resolve
+            graph.add("pedgroups", {"levels"},
+                      [&] { loadPedGroups("data/pedgrp.dat"); });
+        },
+        Thread::Main);
+
+    // Texture archives create GL textures
+    graph.add("textures", {"index"},
+              [&] {
+                  textureSlots["particle"] = loadTextureArchive("particle.txd");
+                  textureSlots["icons"] = loadTextureArchive("icons.txd");
+                  textureSlots["hud"] = loadTextureArchive("hud.txd");
+                  textureSlots["fonts"] = loadTextureArchive("fonts.txd");
+                  textureSlots["generic"] = loadTextureArchive("generic.txd");
+                  loadToTextureArchive("misc.txd", textureSlots["generic"]);
+              },
+              Thread::Main);
+
+    graph.add("carcols", {"index"}, [&] { loadCarcols("data/carcols.dat"); });
+    graph.add("timecyc", {"index"}, [&] { loadWeather("data/timecyc.dat"); });
+    graph.add("handling", {"index"},
+              [&] { loadHandling("data/handling.cfg"); });
+    graph.add("waterpro", {"index"},
+              [&] { loadWaterpro("data/waterpro.dat"); });
+    graph.add("weapons", {"index"}, [&] { loadWeaponDAT("data/weapon.dat"); });
+    graph.add("pedstats", {"index"},
+              [&] { loadPedStats("data/pedstats.dat"); });
+    graph.add("pedrelations", {"index"},
+              [&] { loadPedRelations("data/ped.dat"); });
+
+    graph.add("animations", {"index"}, [&] {
+        loadIFP("ped.ifp");
+
+        /// @todo load real data
+        pedAnimGroups["player"] = std::make_unique<AnimGroup>(
+            AnimGroup::getBuiltInAnimGroup(animations, "player"));
+    });
+
+    graph.run(jobs);
+    loadTimings = graph.getTimings();
 
     return true;
 }
 
 void GameData::loadLevelFile(const std::string& path) {
+    auto commands = readLevelFile(path);
+    runLevelFile(commands);
+}
+
+std::vector<GameData::LevelCommand> GameData::readLevelFile(
+    const std::string& path) {
+    std::vector<LevelCommand> commands;
+
     auto datpath = index.findFilePath(path);
     std::ifstream datfile(datpath.string());
 
     if (!datfile.is_open()) {
         logger->error("Data", "Failed to open game file " + path);
-        return;
+        return commands;
     }
 
-    // Reset texture slot
-    currenttextureslot = "generic";
-
-    for (std::string line, cmd; std::getline(datfile, line);) {
+    for (std::string line; std::getline(datfile, line);) {
         if (line.empty() || line[0] == '#') continue;
 #ifndef RW_WINDOWS
         line.erase(line.size() - 1);
 #endif
 
         size_t space = line.find_first_of(' ');
-        if (space != line.npos) {
-            cmd = line.substr(0, space);
-            if (cmd == "IDE") {
-                auto path = line.substr(space + 1);
-                loadIDE(path);
-            } else if (cmd == "SPLASH") {
-                splash = line.substr(space + 1);
-            } else if (cmd == "COLFILE") {
-                int zone = lexical_cast<int>(line.substr(space + 1, 1));
-                auto path = line.substr(space + 3);
-                loadCOL(zone, path);
-            } else if (cmd == "IPL") {
-                auto path = line.substr(space + 1);
-                loadIPL(path);
-            } else if (cmd == "TEXDICTION") {
-                auto path = line.substr(space + 1);
-                /// @todo improve TXD handling
-                auto name = index.findFilePath(path).filename().string();
-                std::transform(name.begin(), name.end(), name.begin(),
-                               ::tolower);
-                loadTXD(name);
-            } else if (cmd == "MODELFILE") {
-                auto path = line.substr(space + 1);
-                loadModelFile(path);
+        if (space == line.npos) {
+            continue;
+        }
+
+        LevelCommand command;
+        command.type = line.substr(0, space);
+        if (command.type == "COLFILE") {
+            command.zone = lexical_cast<int>(line.substr(space + 1, 1));
+            command.argument = line.substr(space + 3);
+        } else {
+            command.argument = line.substr(space + 1);
+        }
+        commands.push_back(std::move(command));
+    }
+
+    return commands;
+}
+
+void GameData::parseLevelCommand(LevelCommand& command) {
+    if (command.type == "IDE") {
+        auto systempath = index.findFilePath(command.argument);
+        command.ide = std::make_unique<LoaderIDE>();
+        if (!levelCache.loadIDE(systempath, pedstats, *command.ide)) {
+            logger->error("Data", "Failed to load IDE " + command.argument);
+            command.ide.reset();
+        }
+    } else if (command.type == "COLFILE") {
+        auto systempath = index.findFilePath(command.argument);
+        command.col = std::make_unique<LoaderCOL>();
+        if (!levelCache.loadCOL(systempath, *command.col)) {
+            command.col.reset();
+        }
+    }
+    command.parsed = true;
+}
+
+void GameData::runLevelFile(std::vector<LevelCommand>& commands) {
+    // Reset texture slot
+    currenttextureslot = "generic";
+
+    for (auto& command : commands) {
+        if (command.canParseAhead() && !command.parsed) {
+            parseLevelCommand(command);
+        }
+
+        const auto& cmd = command.type;
+        if (cmd == "IDE") {
+            if (command.ide) {
+                addModelInfos(*command.ide);
+            }
+        } else if (cmd == "SPLASH") {
+            splash = command.argument;
+        } else if (cmd == "COLFILE") {
+            if (command.col) {
+                addCollisions(*command.col);
             }
+        } else if (cmd == "IPL") {
+            loadIPL(command.argument);
+        } else if (cmd == "TEXDICTION") {
+            /// @todo improve TXD handling
+            auto name = index.findFilePath(command.argument).filename().string();
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            loadTXD(name);
+        } else if (cmd == "MODELFILE") {
+            loadModelFile(command.argument);
         }
+
+        // The parsed files aren't needed once they have been added
+        command.ide.reset();
+        command.col.reset();
     }
 
     for (const auto& model : modelinfo) {
@@ -142,17 +263,21 @@ void GameData::loadLevelFile(const std::string& path) {
 }
 
 void GameData::loadIDE(const std::string& path) {
-    auto systempath = index.findFilePath(path).string();
+    auto systempath = index.findFilePath(path);
     LoaderIDE idel;
 
-    if (idel.load(systempath, pedstats)) {
-        std::move(idel.objects.begin(), idel.objects.end(),
-                  std::inserter(modelinfo, modelinfo.end()));
+    if (levelCache.loadIDE(systempath, pedstats, idel)) {
+        addModelInfos(idel);
     } else {
         logger->error("Data", "Failed to load IDE " + path);
     }
 }
 
+void GameData::addModelInfos(LoaderIDE& ide) {
+    std::move(ide.objects.begin(), ide.objects.end(),
+              std::inserter(modelinfo, modelinfo.end()));
+}
+
 uint16_t GameData::findModelObject(const std::string model) {
     auto defit = std::find_if(modelinfo.begin(), modelinfo.end(),
                               [&](const decltype(modelinfo)::value_type& d) {
@@ -178,20 +303,34 @@ void GameData::loadCOL(const size_t zone, const std::string& name) {
 
     LoaderCOL col;
 
-    auto systempath = index.findFilePath(name).string();
+    auto systempath = index.findFilePath(name);
 
-    if (col.load(systempath)) {
-        // Associate loaded collisions with models
-        for (auto& c : col.collisions) {
-            // Find by name
-            auto id = findModelObject(c->name);
-            auto model = modelinfo.find(id);
-            if (model == modelinfo.end()) {
-                logger->error("Data", "no model for collsion " + c->name);
-                continue;
-            }
-            model->second->setCollisionModel(c);
+    if (levelCache.loadCOL(systempath, col)) {
+        addCollisions(col);
+    }
+}
+
+void GameData::addCollisions(LoaderCOL& col) {
+    // Find models by name once for the whole file, the first model with a
+    // name is used as findModelObject would
+    std::unordered_map<std::string, ModelID> models;
+    models.reserve(modelinfo.size());
+    for (const auto& [id, info] : modelinfo) {
+        auto name = info->name;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        models.emplace(std::move(name), id);
+    }
+
+    // Associate loaded collisions with models
+    for (auto& c : col.collisions) {
+        auto name = c->name;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        auto found = models.find(name);
+        if (found == models.end()) {
+            logger->error("Data", "no model for collsion " + c->name);
+            continue;
         }
+        modelinfo[found->second]->setCollisionModel(c);
     }
 }
 
@@ -208,23 +347,38 @@ bool GameData::loadZone(const std::string& path) {
     LoaderIPL ipll;
 
     // Load the zones
-    if (!ipll.load(path)) {
+    if (!levelCache.loadIPL(path, ipll)) {
         logger->error("Data", "Failed to load zones from " + path);
         return false;
     }
 
     gamezones.insert(gamezones.end(), ipll.zones.begin(), ipll.zones.end());
 
-    // Build zone hierarchy
+    buildZoneHierarchy();
+
+    return true;
+}
+
+void GameData::buildZoneHierarchy() {
+    if (gamezones.empty()) {
+        zoneGrid.clear();
+        return;
+    }
+
+    // Every zone is cleared first, a zone can gain children as soon as it
+    // is inserted
     for (ZoneData& zone : gamezones) {
         zone.children_.clear();
+        zone.parent_ = nullptr;
+    }
+    for (ZoneData& zone : gamezones) {
         if (&zone == &gamezones.front()) {
             continue;
         }
         gamezones[0].insertZone(zone);
     }
 
-    return true;
+    zoneGrid.build(gamezones[0]);
 }
 
 enum ColSection {
@@ -355,7 +509,7 @@ void GameData::loadWater(const std::string& path) {
     }
 }
 
-void GameData::loadTXD(const std::string& name) {
+void GameData::loadTXD(const std::string& name, bool packArrays) {
     RW_PROFILE_COUNTER_ADD("loadTXD", 1);
     auto slot = name;
     auto ext = name.find(".txd");
@@ -372,10 +526,11 @@ void GameData::loadTXD(const std::string& name) {
         return;
     }
 
-    textureSlots[slot] = loadTextureArchive(name);
+    textureSlots[slot] = loadTextureArchive(name, packArrays);
 }
 
-TextureArchive GameData::loadTextureArchive(const std::string& name) {
+TextureArchive GameData::loadTextureArchive(const std::string& name,
+                                            bool packArrays) {
     RW_PROFILE_COUNTER_ADD("loadTextureArchive", 1);
     /// @todo refactor loadTXD to use correct file locations
     auto file = index.openFile(name);
@@ -387,7 +542,7 @@ TextureArchive GameData::loadTextureArchive(const std::string& name) {
     TextureArchive textures;
 
     TextureLoader l;
-    if (!l.loadFromMemory(file, textures)) {
+    if (!l.loadFromMemory(file, textures, packArrays)) {
         logger->error("Data", "Error loading txd: " + name);
         return {};
     }
@@ -474,11 +629,11 @@ void GameData::loadModelFile(const std::string& name) {
     }
 }
 
-bool GameData::loadModel(ModelID model) {
-    auto info = modelinfo[model].get();
+void GameData::getModelFileNames(const BaseModelInfo* info, std::string& name,
+                                 std::string& slotname) const {
     /// @todo replace openFile with API for loading from CDIMAGE archives
-    auto name = info->name;
-    auto slotname = info->textureslot;
+    name = info->name;
+    slotname = info->textureslot;
 
     // Re-direct special models
     switch (info->type()) {
@@ -504,9 +659,15 @@ bool GameData::loadModel(ModelID model) {
     std::transform(name.begin(), name.end(), name.begin(), ::tolower);
     std::transform(slotname.begin(), slotname.end(), slotname.begin(),
                    ::tolower);
+}
+
+bool GameData::loadModel(ModelID model) {
+    auto info = modelinfo[model].get();
+    std::string name, slotname;
+    getModelFileNames(info, name, slotname);
 
     /// @todo remove this from here
-    loadTXD(slotname + ".txd");
+    loadTXD(slotname + ".txd", true);
 
     auto file = index.openFile(name + ".dff");
     if (!file.data) {
@@ -514,12 +675,24 @@ bool GameData::loadModel(ModelID model) {
                                   std::to_string(model) + " [" + name + "]");
         return false;
     }
-    auto m = dffLoader.loadFromMemory(file);
+    auto m = dffLoader.loadFromMemory(file, keepsModelVertices(info));
     if (!m) {
         logger->error("Data",
                       "Error loading model file for " + std::to_string(model));
         return false;
     }
+
+    setModelClump(info, m);
+
+    return true;
+}
+
+bool GameData::keepsModelVertices(const BaseModelInfo* info) {
+    return info->type() == ModelDataType::SimpleInfo &&
+           static_cast<const SimpleModelInfo*>(info)->isBigBuilding();
+}
+
+void GameData::setModelClump(BaseModelInfo* info, const ClumpPtr& m) {
     /// @todo handle timeinfo models correctly.
     auto isSimple = info->type() == ModelDataType::SimpleInfo;
     if (isSimple) {
@@ -539,15 +712,25 @@ bool GameData::loadModel(ModelID model) {
         clump->setModel(m);
         /// @todo how is LOD handled for clump objects?
     }
-
-    return true;
 }
 
 void GameData::loadIFP(const std::string& name, bool cutsceneAnimation) {
     auto f = index.openFile(name);
 
     if (f.data) {
-        if (LoaderIFP loader{}; loader.loadFromMemory(f.data.get())) {
+        // Animations are only sampled through their tracks, so the
+        // keyframes can be quantized
+        if (LoaderIFP loader{}; loader.loadFromMemory(f.data.get(), true)) {
+            std::size_t bytes = 0;
+            for (const auto& [animName, animation] : loader.animations) {
+                bytes += animation->getMemoryUsage();
+            }
+            logger->info("Data", "Loaded " + name + ": " +
+                                     std::to_string(loader.animations.size()) +
+                                     " animations, " +
+                                     std::to_string(bytes / 1024) +
+                                     " KiB of keyframes");
+
             auto& dest = cutsceneAnimation ? animationsCutscene : animations;
             dest.insert(loader.animations.begin(), loader.animations.end());
         }
@@ -742,8 +925,12 @@ ZoneData *GameData::findZone(const std::string &name) {
 
 ZoneData *GameData::findZoneAt(const glm::vec3 &pos) {
     RW_CHECK(!gamezones.empty(), "No game zones loaded");
-    ZoneData* zone = gamezones[0].findLeafAtPoint(pos);
-    return zone;
+    return zoneGrid.find(pos);
+}
+
+ZoneData *GameData::findZoneAt(const glm::vec3 &pos, ZoneGrid::Hint &hint) {
+    RW_CHECK(!gamezones.empty(), "No game zones loaded");
+    return zoneGrid.find(pos, hint);
 }
 
 int GameData::getWaterIndexAt(const glm::vec3& ws) const {
@@ -765,6 +952,45 @@ float GameData::getWaveHeightAt(const glm::vec3& ws) const {
            WATER_HEIGHT;
 }
 
+namespace {
+/// @return The index of the water table tile under ws, or -1 outside it
+int waterTileAt(const glm::vec3& ws) {
+    auto wX = static_cast<int>((ws.x + WATER_WORLD_SIZE / 2.f) /
+                               (WATER_WORLD_SIZE / WATER_HQ_DATA_SIZE));
+    auto wY = static_cast<int>((ws.y + WATER_WORLD_SIZE / 2.f) /
+                               (WATER_WORLD_SIZE / WATER_HQ_DATA_SIZE));
+    if (wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 &&
+        wY < WATER_HQ_DATA_SIZE) {
+        return (wX * WATER_HQ_DATA_SIZE) + wY;
+    }
+    return -1;
+}
+}  // namespace
+
+bool GameData::hasWaterAt(const glm::vec3& ws) const {
+    const auto tile = waterTileAt(ws);
+    return tile >= 0 && realWater[tile] < NO_WATER_INDEX;
+}
+
+void GameData::getWaterHeightsAt(const glm::vec3* points, std::size_t count,
+                                 float* heights) const {
+    const auto time = engine->getGameTime();
+
+    for (std::size_t p = 0; p < count; ++p) {
+        const auto tile = waterTileAt(points[p]);
+        const int hI = tile >= 0 ? realWater[tile] : NO_WATER_INDEX;
+        if (hI >= NO_WATER_INDEX) {
+            heights[p] = kNoWaterHeight;
+            continue;
+        }
+        // Only points over water pay for the wave
+        heights[p] = waterHeights[hI] +
+                     (1 + std::sin(time + (points[p].x + points[p].y) *
+                                              WATER_SCALE)) *
+                         WATER_HEIGHT;
+    }
+}
+
 bool GameData::isValidGameDirectory() const {
     std::error_code ec;
     if (!std::filesystem::is_directory(datpath, ec)) {
@@ -5,12 +5,14 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <core/TaskGraph.hpp>
 #include <platform/FileIndex.hpp>
 #include <rw/debug.hpp>
 #include <rw/forward.hpp>
@@ -21,13 +23,19 @@
 #include <data/WeaponData.hpp>
 #include <data/Weather.hpp>
 #include <data/ZoneData.hpp>
+#include <data/ZoneGrid.hpp>
+#include <engine/ModelStreamer.hpp>
 #include <fonts/GameTexts.hpp>
 #include <loaders/LoaderDFF.hpp>
+#include <loaders/LevelCache.hpp>
 #include <loaders/LoaderIMG.hpp>
 #include <loaders/LoaderTXD.hpp>
 #include <objects/VehicleInfo.hpp>
 
+class JobSystem;
 class Logger;
+class LoaderCOL;
+class LoaderIDE;
 struct WeaponData;
 class GameWorld;
 class TextureAtlas;
@@ -39,7 +47,7 @@ class SCMFile;
  *
  * @todo Move parsing of one-off data files from this class.
  * @todo Improve how Loaders and written and used
- * @todo Considering implementation of streaming data and object handles.
+ * @todo Considering implementation of object handles.
  */
 class GameData {
 private:
@@ -50,6 +58,36 @@ private:
     Logger* logger;
     LoaderDFF dffLoader;
 
+    JobSystem* jobs = nullptr;
+    std::vector<TaskGraph::Timing> loadTimings;
+
+    /**
+     * A command from a level file, with the IDE or COL file it names once
+     * that has been parsed
+     */
+    struct LevelCommand;
+
+    /**
+     * Reads the commands from a level file without running them
+     */
+    std::vector<LevelCommand> readLevelFile(const std::string& path);
+
+    /**
+     * Parses the IDE or COL file named by command. This doesn't change the
+     * GameData and can be called from any thread.
+     */
+    void parseLevelCommand(LevelCommand& command);
+
+    /**
+     * Runs the level file commands in order, after parsing any that haven't
+     * been parsed yet
+     */
+    void runLevelFile(std::vector<LevelCommand>& commands);
+
+    void addModelInfos(LoaderIDE& ide);
+
+    void addCollisions(LoaderCOL& col);
+
 public:
     /**
      * ctor
@@ -112,8 +150,28 @@ public:
     void loadWaterpro(const std::string& path);
     void loadWater(const std::string& path);
 
+    /**
+     * Loads all of the game data, using the JobSystem for the files that
+     * don't depend on each other if one has been set
+     */
     bool load();
 
+    /**
+     * @brief setJobSystem Set the JobSystem used to load the game data
+     *
+     * The JobSystem must outlive load().
+     */
+    void setJobSystem(JobSystem* jobSystem) {
+        jobs = jobSystem;
+    }
+
+    /**
+     * @return how long each step of the last load() took
+     */
+    const std::vector<TaskGraph::Timing>& getLoadTimings() const {
+        return loadTimings;
+    }
+
     /**
      * Loads model, placement, models and textures from a level file
      */
@@ -122,13 +180,17 @@ public:
     /**
      * Loads the txt slot if it is not already loaded and sets
      * the current TXD slot
+     *
+     * @param packArrays pack the textures into array textures, for slots
+     * that are only drawn by the world shader
      */
-    void loadTXD(const std::string& name);
+    void loadTXD(const std::string& name, bool packArrays = false);
 
     /**
      * Loads a named texture archive from the game data
      */
-    TextureArchive loadTextureArchive(const std::string& name);
+    TextureArchive loadTextureArchive(const std::string& name,
+                                      bool packArrays = false);
 
     /**
      * Loads to named a texture archive from the game data
@@ -160,6 +222,23 @@ public:
      */
     bool loadModel(ModelID model);
 
+    /**
+     * Determines the DFF name and texture slot a model is loaded from
+     */
+    void getModelFileNames(const BaseModelInfo* info, std::string& name,
+                           std::string& slotname) const;
+
+    /**
+     * Associates a loaded clump with a model's data
+     */
+    void setModelClump(BaseModelInfo* info, const ClumpPtr& clump);
+
+    /**
+     * @return true if the model's vertices stay on the CPU once loaded, which
+     * is the case for big buildings so they can be merged into LOD meshes
+     */
+    static bool keepsModelVertices(const BaseModelInfo* info);
+
     /**
      * Loads an IFP file containing animations
      */
@@ -200,6 +279,11 @@ public:
 
     FileIndex index;
 
+    /**
+     * Compiled IPL and COL files, disabled unless given a directory
+     */
+    LevelCache levelCache;
+
     /**
      * Files that have been loaded previously
      */
@@ -219,10 +303,25 @@ public:
 
     ZoneDataList mapzones;
 
+    /**
+     * Grid over the gamezones hierarchy, rebuilt with the hierarchy
+     */
+    ZoneGrid zoneGrid;
+
     ZoneData* findZone(const std::string& name);
 
     ZoneData* findZoneAt(const glm::vec3& pos);
 
+    /**
+     * Finds the zone at pos, checking the zone in hint first
+     */
+    ZoneData* findZoneAt(const glm::vec3& pos, ZoneGrid::Hint& hint);
+
+    /**
+     * Builds the gamezones hierarchy, with the first zone as the root
+     */
+    void buildZoneHierarchy();
+
     std::unordered_map<ModelID, std::unique_ptr<BaseModelInfo>> modelinfo;
 
     uint16_t findModelObject(const std::string model);
@@ -357,8 +456,35 @@ public:
     int getWaterIndexAt(const glm::vec3& ws) const;
     float getWaveHeightAt(const glm::vec3& ws) const;
 
+    /// Height returned for points without water under them
+    static constexpr float kNoWaterHeight =
+        -std::numeric_limits<float>::infinity();
+
+    /// @return true if the water table has water under ws
+    bool hasWaterAt(const glm::vec3& ws) const;
+
+    /**
+     * Finds the height of the water surface, including the waves, under each
+     * point. Points outside the water table or over tiles without water are
+     * given kNoWaterHeight, which every point is above.
+     */
+    void getWaterHeightsAt(const glm::vec3* points, std::size_t count,
+                           float* heights) const;
+
+    float getWaterHeightAt(const glm::vec3& ws) const {
+        float height;
+        getWaterHeightsAt(&ws, 1, &height);
+        return height;
+    }
+
     GameTexts texts;
 
+    /**
+     * Background model loading, declared last so that it's stopped before
+     * anything its workers use is destroyed.
+     */
+    ModelStreamer streamer;
+
 private:
     /**
      * Determines whether the given path is a valid game directory.
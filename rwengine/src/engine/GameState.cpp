@@ -1,5 +1,9 @@
 #include "engine/GameState.hpp"
 
+#include <limits>
+
+#include "objects/GameObject.hpp"
+
 int GameState::addRadarBlip(BlipData& blip) {
     int l = 0;
     for (const auto& [nr, blipData] : radarBlips) {
@@ -23,6 +27,33 @@ void GameState::removeBlip(int blip) {
     }
 }
 
+void GameState::addMissionObject(GameObject* object) {
+    auto index = object->getMissionIndex();
+    if (index < missionObjects.size() && missionObjects[index] == object) {
+        return;
+    }
+    object->setMissionIndex(missionObjects.size());
+    missionObjects.push_back(object);
+}
+
+void GameState::removeMissionObject(GameObject* object) {
+    auto index = object->getMissionIndex();
+    if (index >= missionObjects.size() || missionObjects[index] != object) {
+        return;
+    }
+    missionObjects[index] = missionObjects.back();
+    missionObjects[index]->setMissionIndex(index);
+    missionObjects.pop_back();
+    object->setMissionIndex(std::numeric_limits<std::size_t>::max());
+}
+
+void GameState::clearMissionObjects() {
+    for (auto object : missionObjects) {
+        object->setMissionIndex(std::numeric_limits<std::size_t>::max());
+    }
+    missionObjects.clear();
+}
+
 void GameState::addHospitalRestart(const glm::vec4 location) {
     hospitalRestarts.push_back(location);
 }
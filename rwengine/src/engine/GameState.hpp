@@ -285,9 +285,17 @@ public:
      */
     ScriptInt* scriptOnMissionFlag = nullptr;
 
-    /** Objects created by the current mission */
+    /**
+     * Objects created by the current mission, in no particular order. Use
+     * addMissionObject and removeMissionObject to change it.
+     */
     std::vector<GameObject*> missionObjects;
 
+    void addMissionObject(GameObject* object);
+    /// Removes the object in constant time, if it's a mission object
+    void removeMissionObject(GameObject* object);
+    void clearMissionObjects();
+
     bool overrideNextRestart = false;
     glm::vec4 nextRestartLocation{};
     std::vector<glm::vec4> hospitalRestarts, policeRestarts;
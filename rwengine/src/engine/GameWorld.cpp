@@ -113,13 +113,19 @@ GameWorld::~GameWorld() {
 bool GameWorld::placeItems(const std::string& name) {
     LoaderIPL ipll;
 
-    if (ipll.load(name)) {
+    if (data->levelCache.loadIPL(name, ipll)) {
         // Find the object.
         for (const auto& inst : ipll.m_instances) {
-            if (!createInstance(inst.id, inst.pos, inst.rot)) {
+            auto instance = createInstance(inst.id, inst.pos, inst.rot);
+            if (!instance) {
                 logger->error("World", "No object data for instance " +
                                            std::to_string(inst.id) + " in " +
                                            name);
+                continue;
+            }
+            // Objects with dynamics can be pushed around
+            if (!instance->dynamics) {
+                staticInstances.insert(instance);
             }
         }
 
@@ -162,8 +168,7 @@ InstanceObject* GameWorld::createInstance(const uint16_t id,
 
         auto ptr = instance.get();
 
-        instancePool.insert(std::move(instance));
-        allObjects.push_back(ptr);
+        insertObject(std::move(instance));
 
         modelInstances.emplace(oi->name, ptr);
 
@@ -180,27 +185,27 @@ void GameWorld::createTraffic(const ViewCamera& viewCamera) {
 }
 
 void GameWorld::cleanupTraffic(const ViewCamera& focus) {
-    for (auto& p : pedestrianPool.objects) {
-        if (p.second->getLifetime() != GameObject::TrafficLifetime) {
+    for (auto& object : pedestrianPool) {
+        if (object->getLifetime() != GameObject::TrafficLifetime) {
             continue;
         }
 
-        if (glm::distance(focus.position, p.second->getPosition()) >=
+        if (glm::distance(focus.position, object->getPosition()) >=
             kMaxTrafficCleanupRadius) {
-            if (!focus.frustum.intersects(p.second->getPosition(), 1.f)) {
-                destroyObjectQueued(p.second.get());
+            if (!focus.frustum.intersects(object->getPosition(), 1.f)) {
+                destroyObjectQueued(object.get());
             }
         }
     }
-    for (auto& p : vehiclePool.objects) {
-        if (p.second->getLifetime() != GameObject::TrafficLifetime) {
+    for (auto& object : vehiclePool) {
+        if (object->getLifetime() != GameObject::TrafficLifetime) {
             continue;
         }
 
-        if (glm::distance(focus.position, p.second->getPosition()) >=
+        if (glm::distance(focus.position, object->getPosition()) >=
             kMaxTrafficCleanupRadius) {
-            if (!focus.frustum.intersects(p.second->getPosition(), 1.f)) {
-                destroyObjectQueued(p.second.get());
+            if (!focus.frustum.intersects(object->getPosition(), 1.f)) {
+                destroyObjectQueued(object.get());
             }
         }
     }
@@ -234,8 +239,7 @@ CutsceneObject* GameWorld::createCutsceneObject(const uint16_t id,
     auto instance = std::make_unique<CutsceneObject>(this, pos, rot, model, modelinfo);
     auto ptr = instance.get();
 
-    cutscenePool.insert(std::move(instance));
-    allObjects.push_back(ptr);
+    insertObject(std::move(instance));
 
     return ptr;
 }
@@ -318,8 +322,8 @@ VehicleObject* GameWorld::createVehicle(const uint16_t id, const glm::vec3& pos,
     auto ptr = vehicle.get();
     vehicle->setGameObjectID(gid);
 
-    vehiclePool.insert(std::move(vehicle));
-    allObjects.push_back(ptr);
+    insertObject(std::move(vehicle));
+    objectGrid.insert(ptr);
 
     return ptr;
 }
@@ -342,8 +346,8 @@ CharacterObject* GameWorld::createPedestrian(const uint16_t id,
     auto ped = std::make_unique<CharacterObject>(this, pos, rot, pt, controller);
     auto ptr = ped.get();
     ped->setGameObjectID(gid);
-    pedestrianPool.insert(std::move(ped));
-    allObjects.push_back(ptr);
+    insertObject(std::move(ped));
+    objectGrid.insert(ptr);
     return ptr;
 }
 
@@ -372,8 +376,8 @@ CharacterObject* GameWorld::createPlayer(const glm::vec3& pos,
     ped->setGameObjectID(gid);
     ped->setLifetime(GameObject::PlayerLifetime);
     players.push_back(controller);
-    pedestrianPool.insert(std::move(ped));
-    allObjects.push_back(ptr);
+    insertObject(std::move(ped));
+    objectGrid.insert(ptr);
     return ptr;
 }
 
@@ -424,8 +428,7 @@ PickupObject* GameWorld::createPickup(const glm::vec3& pos, int id, int type) {
 
     auto ptr = pickup.get();
 
-    pickupPool.insert(std::move(pickup));
-    allObjects.push_back(ptr);
+    insertObject(std::move(pickup));
 
     return ptr;
 }
@@ -444,34 +447,88 @@ Payphone* GameWorld::createPayphone(const glm::vec2 coord) {
 }
 
 void GameWorld::ObjectPool::insert(std::unique_ptr<GameObject> object) {
-    if (object->getGameObjectID() == 0) {
-        // Find the lowest free GameObjectID.
-        GameObjectID availID = 1;
-        for (auto& [id, objectPtr] : objects) {
-            if (id == availID) availID++;
+    const auto requested = object->getGameObjectID();
+    if (requested == 0 || !claimSlot(requested)) {
+        RW_CHECK(requested == 0, "Object ID is already in use");
+        uint32_t slot;
+        if (free_.empty()) {
+            slot = static_cast<uint32_t>(slots_.size());
+            RW_ASSERT(slot < (1u << kSlotBits) - 1);
+            slots_.emplace_back();
+        } else {
+            slot = free_.back();
+            free_.pop_back();
         }
+        object->setGameObjectID(makeID(slot, slots_[slot].generation));
+    }
+
+    slots_[getSlot(object->getGameObjectID())].object =
+        static_cast<uint32_t>(objects_.size());
+    objects_.push_back(std::move(object));
+}
+
+bool GameWorld::ObjectPool::claimSlot(GameObjectID id) {
+    const auto slot = getSlot(id);
+    if (slot >= (1u << kSlotBits) - 1) {
+        return false;
+    }
 
-        object->setGameObjectID(availID);
+    if (slot >= slots_.size()) {
+        // The slots skipped over are free, lowest at the back
+        const auto first = static_cast<uint32_t>(slots_.size());
+        for (auto s = slot; s-- > first;) {
+            free_.push_back(s);
+        }
+        slots_.resize(slot + 1);
+    } else {
+        auto it = std::find(free_.begin(), free_.end(), slot);
+        if (it == free_.end()) {
+            return false;
+        }
+        free_.erase(it);
     }
-    objects[object->getGameObjectID()] = std::move(object);
+
+    slots_[slot].generation = getGeneration(id);
+    return true;
 }
 
 GameObject* GameWorld::ObjectPool::find(GameObjectID id) const {
-    auto it = objects.find(id);
-    return (it == objects.end()) ? nullptr : it->second.get();
+    const auto slot = getSlot(id);
+    if (slot >= slots_.size()) {
+        return nullptr;
+    }
+    const auto& s = slots_[slot];
+    if (s.object == kNoObject || s.generation != getGeneration(id)) {
+        return nullptr;
+    }
+    return objects_[s.object].get();
 }
 
 void GameWorld::ObjectPool::remove(GameObject* object) {
-    if (object) {
-        auto it = objects.find(object->getGameObjectID());
-        if (it != objects.end()) {
-            it = objects.erase(it);
-        }
+    if (object == nullptr || find(object->getGameObjectID()) != object) {
+        return;
     }
+
+    const auto index = getSlot(object->getGameObjectID());
+    auto& slot = slots_[index];
+
+    // Fill the gap with the last object
+    if (slot.object != objects_.size() - 1) {
+        auto& last = objects_.back();
+        slots_[getSlot(last->getGameObjectID())].object = slot.object;
+        std::swap(objects_[slot.object], last);
+    }
+    objects_.pop_back();
+
+    slot.object = kNoObject;
+    slot.generation = (slot.generation + 1) & ((1u << kGenerationBits) - 1);
+    free_.push_back(index);
 }
 
 void GameWorld::ObjectPool::clear() {
-    objects.clear();
+    objects_.clear();
+    slots_.clear();
+    free_.clear();
 }
 
 GameWorld::ObjectPool& GameWorld::getTypeObjectPool(GameObject* object) {
@@ -509,21 +566,33 @@ GameObject* GameWorld::getBlipTarget(const BlipData& blip) const {
     }
 }
 
-void GameWorld::destroyObject(GameObject* object) {
-    auto& pool = getTypeObjectPool(object);
-    pool.remove(object);
+void GameWorld::insertObject(std::unique_ptr<GameObject> object) {
+    object->setWorldIndex(allObjects.size());
+    allObjects.push_back(object.get());
+    getTypeObjectPool(object.get()).insert(std::move(object));
+}
 
+void GameWorld::destroyObject(GameObject* object) {
     // Remove from mission objects
     if (state) {
-        auto& mO = state->missionObjects;
-        mO.erase(std::remove(mO.begin(), mO.end(), object), mO.end());
+        state->removeMissionObject(object);
     }
 
-    auto it = std::find(allObjects.begin(), allObjects.end(), object);
-    RW_CHECK(it != allObjects.end(), "destroying object not in allObjects");
-    if (it != allObjects.end()) {
-        allObjects.erase(it);
+    // Objects added to allObjects directly don't know their index
+    auto index = object->getWorldIndex();
+    if (index >= allObjects.size() || allObjects[index] != object) {
+        auto it = std::find(allObjects.begin(), allObjects.end(), object);
+        RW_CHECK(it != allObjects.end(), "destroying object not in allObjects");
+        index = static_cast<size_t>(it - allObjects.begin());
     }
+    if (index < allObjects.size()) {
+        allObjects[index] = allObjects.back();
+        allObjects[index]->setWorldIndex(index);
+        allObjects.pop_back();
+    }
+
+    auto& pool = getTypeObjectPool(object);
+    pool.remove(object);
 }
 
 void GameWorld::destroyObjectQueued(GameObject* object) {
@@ -748,24 +817,57 @@ void GameWorld::PhysicsTickCallback(btDynamicsWorld* physWorld,
     RW_PROFILE_SCOPEC(__func__, MP_CYAN);
     GameWorld* world = static_cast<GameWorld*>(physWorld->getWorldUserInfo());
 
-    RW_PROFILE_COUNTER_SET("physicsTick/vehiclePool", world->vehiclePool.objects.size());
-    for (auto& p : world->vehiclePool.objects) {
+    RW_PROFILE_COUNTER_SET("physicsTick/vehiclePool", world->vehiclePool.size());
+
+    // The water under every vehicle that has any is looked up at once
+    auto& points = world->waterPoints;
+    auto& offsets = world->waterPointOffsets;
+    points.clear();
+    offsets.clear();
+    for (auto& p : world->vehiclePool) {
+        auto object = static_cast<VehicleObject*>(p.get());
+        const auto offset = points.size();
+        points.resize(offset + VehicleObject::kWaterPoints);
+        if (object->getWaterPoints(&points[offset])) {
+            offsets.push_back(offset);
+        } else {
+            points.resize(offset);
+            offsets.push_back(kNoWaterPoints);
+        }
+    }
+    auto& heights = world->waterHeights;
+    heights.resize(points.size());
+    world->data->getWaterHeightsAt(points.data(), points.size(),
+                                   heights.data());
+
+    auto offset = offsets.begin();
+    for (auto& p : world->vehiclePool) {
         RW_PROFILE_SCOPEC("VehicleObject", MP_THISTLE1);
-        auto object = static_cast<VehicleObject*>(p.second.get());
-        object->tickPhysics(timeStep);
+        auto object = static_cast<VehicleObject*>(p.get());
+        const auto first = *offset++;
+        object->tickPhysics(timeStep, first != kNoWaterPoints
+                                          ? &heights[first]
+                                          : nullptr);
     }
 
-    RW_PROFILE_COUNTER_SET("physicsTick/pedestrianPool", world->pedestrianPool.objects.size());
-    for (auto& p : world->pedestrianPool.objects) {
+    RW_PROFILE_COUNTER_SET("physicsTick/pedestrianPool", world->pedestrianPool.size());
+    for (auto& p : world->pedestrianPool) {
         RW_PROFILE_SCOPEC("CharacterObject", MP_THISTLE1);
-        auto object = static_cast<CharacterObject*>(p.second.get());
+        auto object = static_cast<CharacterObject*>(p.get());
         object->tickPhysics(timeStep);
     }
 
-    RW_PROFILE_COUNTER_SET("physicsTick/instancePool", world->instancePool.objects.size());
-    for (auto& p : world->instancePool.objects) {
-        auto object = static_cast<InstanceObject*>(p.second.get());
+    // Instances that haven't been disturbed are left alone
+    auto& active = world->activeInstances;
+    RW_PROFILE_COUNTER_SET("physicsTick/instancePool", world->instancePool.size());
+    RW_PROFILE_COUNTER_SET("physicsTick/activeInstances", active.size());
+    for (std::size_t i = 0; i < active.size();) {
+        auto object = active[i];
         object->tickPhysics(timeStep);
+        // Idle instances leave, and the last instance takes their place
+        if (object->isAwake()) {
+            ++i;
+        }
     }
 }
 
@@ -815,8 +917,8 @@ void GameWorld::clearCutscene() {
 }
 
 void GameWorld::eraseCutsceneObjects() {
-    for (auto& p : cutscenePool.objects) {
-        destroyObjectQueued(p.second.get());
+    for (auto& object : cutscenePool) {
+        destroyObjectQueued(object.get());
     }
 }
 
@@ -953,11 +1055,12 @@ VehicleObject* GameWorld::tryToSpawnVehicle(VehicleGenerator& gen) {
     }
 
     // Ensure there's no existing vehicles near our spawn point
-    for (auto& v : vehiclePool.objects) {
-        if (glm::distance2(position, v.second->getPosition()) <
-            kMinClearRadius * kMinClearRadius) {
-            return nullptr;
-        }
+    if (objectGrid.anyInRadius(position, kMinClearRadius, [&](auto object) {
+            return object->type() == GameObject::Vehicle &&
+                   glm::distance2(position, object->getPosition()) <
+                       kMinClearRadius * kMinClearRadius;
+        })) {
+        return nullptr;
     }
 
     int id = gen.vehicleID;
@@ -1006,27 +1109,16 @@ bool GameWorld::isRaining() const {
 void GameWorld::clearObjectsWithinArea(const glm::vec3 center,
                                        const float radius,
                                        const bool clearParticles) {
-    // Vehicles
-    for (auto& obj : vehiclePool.objects) {
-        if (!obj.second->canBeRemoved()) {
-            continue;
-        }
-
-        if (glm::distance(center, obj.second->getPosition()) < radius) {
-            destroyObjectQueued(obj.second.get());
-        }
-    }
-
-    // Peds
-    for (auto& obj : pedestrianPool.objects) {
-        if (!obj.second->canBeRemoved()) {
-            continue;
+    // Vehicles and peds
+    objectGrid.forEachInRadius(center, radius, [&](GameObject* object) {
+        if (!object->canBeRemoved()) {
+            return;
         }
 
-        if (glm::distance(center, obj.second->getPosition()) < radius) {
-            destroyObjectQueued(obj.second.get());
+        if (glm::distance(center, object->getPosition()) < radius) {
+            destroyObjectQueued(object);
         }
-    }
+    });
 
     /// @todo Do we also have to clear all projectiles + particles *in this
     /// area*, even if the bool is false?
@@ -1047,19 +1139,14 @@ GameWorld::findOverlappingObjects(const glm::vec3 &center,
                                   float radius) const {
     std::vector<GameObject*> overlapping;
 
-    auto checkObjects = [&](const auto& objects) {
-        for (auto& p : objects) {
-            const auto& object = p.second.get();
-            auto objectBounds = object->getClump()->getBoundingRadius();
-            if (glm::distance(center, object->getPosition()) <
-                radius + objectBounds) {
-                overlapping.push_back(object);
-            }
+    const auto searchRadius = radius + objectGrid.getMaxObjectRadius();
+    objectGrid.forEachInRadius(center, searchRadius, [&](GameObject* object) {
+        auto objectBounds = object->getClump()->getBoundingRadius();
+        if (glm::distance(center, object->getPosition()) <
+            radius + objectBounds) {
+            overlapping.push_back(object);
         }
-    };
-
-    checkObjects(vehiclePool.objects);
-    checkObjects(pedestrianPool.objects);
+    });
 
     return overlapping;
 }
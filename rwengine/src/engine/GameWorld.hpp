@@ -1,7 +1,9 @@
 #ifndef _RWENGINE_GAMEWORLD_HPP_
 #define _RWENGINE_GAMEWORLD_HPP_
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
 #include <random>
@@ -21,6 +23,8 @@
 #include <audio/SoundManager.hpp>
 #include <data/Chase.hpp>
 #include <engine/Garage.hpp>
+#include <engine/SpatialGrid.hpp>
+#include <engine/StaticInstanceGrid.hpp>
 #include <objects/ObjectTypes.hpp>
 
 class btCollisionDispatcher;
@@ -250,13 +254,23 @@ public:
     /**
      * Each object type is allocated from a pool. This object helps manage
      * the individual pools.
+     *
+     * A GameObjectID holds a slot number and the slot's generation, which
+     * changes each time the slot is freed. IDs of destroyed objects are
+     * therefore never found again, even once their slot has been reused.
+     * The objects themselves are kept in a dense array for iteration.
      */
-    struct ObjectPool {
-        std::map<GameObjectID, std::unique_ptr<GameObject>> objects;
+    class ObjectPool {
+    public:
+        using Objects = std::vector<std::unique_ptr<GameObject>>;
+
+        static constexpr unsigned int kSlotBits = 20;
+        /// Small enough to keep IDs positive as script integers
+        static constexpr unsigned int kGenerationBits = 11;
 
         /**
          * Allocates the game object a GameObjectID and inserts it into
-         * the pool
+         * the pool, keeping the ID it already has if that is free
          */
         void insert(std::unique_ptr<GameObject> object);
 
@@ -274,8 +288,79 @@ public:
          * Removes all stored objects
          */
         void clear();
+
+        /**
+         * @return the objects in no particular order, removing an object
+         * moves the last object into its place
+         */
+        const Objects& getObjects() const {
+            return objects_;
+        }
+
+        Objects::const_iterator begin() const {
+            return objects_.begin();
+        }
+
+        Objects::const_iterator end() const {
+            return objects_.end();
+        }
+
+        std::size_t size() const {
+            return objects_.size();
+        }
+
+        bool empty() const {
+            return objects_.empty();
+        }
+
+    private:
+        static constexpr uint32_t kNoObject = UINT32_MAX;
+
+        struct Slot {
+            uint32_t generation = 0;
+            /// Index into objects_, or kNoObject if the slot is free
+            uint32_t object = kNoObject;
+        };
+
+        static GameObjectID makeID(uint32_t slot, uint32_t generation) {
+            return (generation << kSlotBits) | (slot + 1);
+        }
+
+        static uint32_t getSlot(GameObjectID id) {
+            return (id & ((1u << kSlotBits) - 1)) - 1;
+        }
+
+        static uint32_t getGeneration(GameObjectID id) {
+            return id >> kSlotBits;
+        }
+
+        /// Takes the slot named by id if it is free
+        bool claimSlot(GameObjectID id);
+
+        Objects objects_;
+        std::vector<Slot> slots_;
+        /// Free slots, the next to be used is at the back
+        std::vector<uint32_t> free_;
     };
 
+    /**
+     * Pedestrians and vehicles by position, declared before the pools so
+     * that it outlives the objects
+     */
+    SpatialGrid objectGrid;
+
+    /**
+     * Instances placed from IPL files that can't move on their own, for
+     * culling them by cell. Also declared before the pools
+     */
+    StaticInstanceGrid staticInstances;
+
+    /**
+     * Instances that are given a physics tick, see InstanceObject::wake().
+     * Also declared before the pools
+     */
+    std::vector<InstanceObject*> activeInstances;
+
     /**
      * Stores all game objects
      */
@@ -290,6 +375,11 @@ public:
 
     ObjectPool& getTypeObjectPool(GameObject* object);
 
+    /**
+     * Inserts an object into its type's pool and allObjects
+     */
+    void insertObject(std::unique_ptr<GameObject> object);
+
     std::vector<ai::PlayerController*> players;
 
     std::vector<std::unique_ptr<Garage>> garages;
@@ -422,6 +512,13 @@ public:
         return dist(randomNumberGen);
     }
 
+    /**
+     * Reseeds the random numbers, for reproducible simulations
+     */
+    void setRandomSeed(unsigned int seed) {
+        randomNumberGen.seed(seed);
+    }
+
 private:
     /**
      * @brief Used by objects to delete themselves during updates.
@@ -430,6 +527,17 @@ private:
 
     std::vector<AreaIndicatorInfo> areaIndicators;
 
+    /**
+     * The vehicles' water lookups in PhysicsTickCallback, kept to reuse
+     * their memory. Each vehicle has the offset of its points, or
+     * kNoWaterPoints if there's no water under it.
+     */
+    static constexpr std::size_t kNoWaterPoints =
+        std::numeric_limits<std::size_t>::max();
+    std::vector<glm::vec3> waterPoints;
+    std::vector<float> waterHeights;
+    std::vector<std::size_t> waterPointOffsets;
+
     /**
      * Flag for pausing the simulation
      */
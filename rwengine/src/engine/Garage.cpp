@@ -35,8 +35,8 @@ Garage::Garage(GameWorld* engine_, size_t id_, const glm::vec3& coord0,
     midpoint.y = (min.y + max.y) / 2;
 
     // Find door objects for this garage
-    for (const auto& p : engine->instancePool.objects) {
-        const auto inst = static_cast<InstanceObject*>(p.second.get());
+    for (const auto& p : engine->instancePool) {
+        const auto inst = static_cast<InstanceObject*>(p.get());
 
         if (!inst->getClump()) {
             continue;
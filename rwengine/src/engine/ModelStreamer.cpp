@@ -0,0 +1,222 @@
+#include "engine/ModelStreamer.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include <loaders/LoaderDFF.hpp>
+#include <platform/FileHandle.hpp>
+
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "engine/GameData.hpp"
+
+ModelStreamer::ModelStreamer(GameData& data, Logger* logger)
+    : data_(data), logger_(logger) {
+}
+
+ModelStreamer::~ModelStreamer() {
+    stop();
+}
+
+void ModelStreamer::start(unsigned int threads) {
+    if (isAsynchronous() || threads == 0) {
+        return;
+    }
+
+    running_ = true;
+    for (auto i = 0u; i < threads; ++i) {
+        workers_.emplace_back(&ModelStreamer::workerMain, this);
+    }
+}
+
+void ModelStreamer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    available_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    queued_.clear();
+    finished_.clear();
+    inFlight_.clear();
+}
+
+bool ModelStreamer::request(ModelID model) {
+    auto it = data_.modelinfo.find(model);
+    if (it == data_.modelinfo.end()) {
+        return false;
+    }
+
+    auto info = it->second.get();
+    if (info->isLoaded()) {
+        return true;
+    }
+
+    if (hasFailed(model)) {
+        return false;
+    }
+
+    if (!isAsynchronous()) {
+        if (!data_.loadModel(model)) {
+            failed_.insert(model);
+            return false;
+        }
+        return true;
+    }
+
+    if (!inFlight_.insert(model).second) {
+        // Already on its way
+        return false;
+    }
+
+    Job job;
+    job.model = model;
+    data_.getModelFileNames(info, job.name, job.slot);
+    job.loadTextures =
+        data_.textureSlots.find(job.slot) == data_.textureSlots.end();
+
+    requestedThisFrame_++;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_.push_back(std::move(job));
+    }
+    available_.notify_one();
+
+    return false;
+}
+
+void ModelStreamer::update() {
+    RW_PROFILE_SCOPE(__func__);
+    namespace chrono = std::chrono;
+
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return chrono::duration<float, std::milli>(chrono::steady_clock::now() -
+                                                   start)
+            .count();
+    };
+
+    stats_.requested = requestedThisFrame_;
+    stats_.committed = 0;
+    requestedThisFrame_ = 0;
+
+    while (elapsed() < budget_) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finished_.empty()) {
+                break;
+            }
+            job = std::move(finished_.front());
+            finished_.pop_front();
+        }
+
+        commit(job);
+        stats_.committed++;
+    }
+
+    stats_.commitTime = elapsed();
+    stats_.pending = inFlight_.size();
+
+    RW_PROFILE_COUNTER_SET("streaming/requested", stats_.requested);
+    RW_PROFILE_COUNTER_SET("streaming/committed", stats_.committed);
+    RW_PROFILE_COUNTER_SET("streaming/pending", stats_.pending);
+}
+
+void ModelStreamer::workerMain() {
+    RW_PROFILE_THREAD("Streaming");
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock,
+                            [this] { return !running_ || !queued_.empty(); });
+            if (!running_) {
+                return;
+            }
+            job = std::move(queued_.front());
+            queued_.pop_front();
+        }
+
+        process(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_.push_back(std::move(job));
+        }
+    }
+}
+
+void ModelStreamer::process(Job& job) {
+    RW_PROFILE_SCOPE(__func__);
+
+    if (job.loadTextures) {
+        auto file = data_.index.openFile(job.slot + ".txd");
+        if (file.data) {
+            TextureLoader loader;
+            if (!loader.decodeFromMemory(file, job.textures)) {
+                job.error = "Error loading txd: " + job.slot;
+            }
+        }
+    }
+
+    auto file = data_.index.openFile(job.name + ".dff");
+    if (!file.data) {
+        job.error = "Failed to load model for " + std::to_string(job.model) +
+                    " [" + job.name + "]";
+        return;
+    }
+
+    try {
+        LoaderDFF loader;
+        job.clump = loader.parseFromMemory(file);
+    } catch (DFFLoaderException& ex) {
+        job.error = ex.which();
+    }
+
+    if (!job.clump && job.error.empty()) {
+        job.error = "Error loading model file for " + std::to_string(job.model);
+    }
+}
+
+void ModelStreamer::commit(Job& job) {
+    RW_PROFILE_SCOPE(__func__);
+    inFlight_.erase(job.model);
+
+    if (!job.error.empty()) {
+        logger_->error("Data", job.error);
+    }
+    if (!job.clump) {
+        failed_.insert(job.model);
+    }
+
+    if (job.loadTextures &&
+        data_.textureSlots.find(job.slot) == data_.textureSlots.end()) {
+        TextureLoader::upload(job.textures, data_.textureSlots[job.slot],
+                              true);
+    }
+
+    auto it = data_.modelinfo.find(job.model);
+    if (!job.clump || it == data_.modelinfo.end() ||
+        it->second->isLoaded()) {
+        // Either failed, or loaded synchronously while this was in flight
+        return;
+    }
+
+    LoaderDFF loader;
+    loader.setTextureLookupCallback(
+        [&](const std::string& texture, const std::string&) {
+            return data_.findSlotTexture(job.slot, texture);
+        });
+    loader.uploadClump(*job.clump,
+                       GameData::keepsModelVertices(it->second.get()));
+
+    data_.setModelClump(it->second.get(), job.clump);
+}
@@ -0,0 +1,148 @@
+#ifndef _RWENGINE_MODELSTREAMER_HPP_
+#define _RWENGINE_MODELSTREAMER_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <loaders/LoaderTXD.hpp>
+#include <rw/forward.hpp>
+
+#include <data/ModelData.hpp>
+
+class GameData;
+class Logger;
+
+/**
+ * @brief Loads models in the background
+ *
+ * Requests are queued on the game thread and handed to worker threads,
+ * which read the DFF and TXD files from the archives and parse them. The
+ * parsed data is then committed on the game thread by update(), which only
+ * creates the GL buffers and textures, and stops once the per-frame budget
+ * has been used.
+ *
+ * Until start() is called the streamer loads synchronously, so code
+ * without a game loop (tests, tools) sees the same behaviour as calling
+ * GameData::loadModel directly.
+ *
+ * Models that fail to load are remembered and never requested again.
+ */
+class ModelStreamer {
+public:
+    /**
+     * Counters for the most recent call to update()
+     */
+    struct FrameStats {
+        /// Models requested since the last update
+        std::size_t requested = 0;
+        /// Models committed by the last update
+        std::size_t committed = 0;
+        /// Models still being read or waiting to be committed
+        std::size_t pending = 0;
+        /// Time spent committing, in milliseconds
+        float commitTime = 0.f;
+    };
+
+    ModelStreamer(GameData& data, Logger* logger);
+    ~ModelStreamer();
+
+    ModelStreamer(const ModelStreamer&) = delete;
+    ModelStreamer& operator=(const ModelStreamer&) = delete;
+
+    /**
+     * Starts the worker threads, enabling asynchronous loading
+     */
+    void start(unsigned int threads);
+
+    /**
+     * Stops the worker threads, any outstanding requests are discarded
+     */
+    void stop();
+
+    bool isAsynchronous() const {
+        return !workers_.empty();
+    }
+
+    /**
+     * Sets the time update() may spend committing models each frame
+     */
+    void setFrameBudget(float milliseconds) {
+        budget_ = milliseconds;
+    }
+
+    float getFrameBudget() const {
+        return budget_;
+    }
+
+    /**
+     * Requests that a model be loaded
+     *
+     * @return true if the model is ready for use
+     */
+    bool request(ModelID model);
+
+    /**
+     * @return true if the model failed to load
+     */
+    bool hasFailed(ModelID model) const {
+        return failed_.find(model) != failed_.end();
+    }
+
+    /**
+     * Commits loaded models within the frame budget, must be called on the
+     * GL thread once per frame.
+     */
+    void update();
+
+    const FrameStats& getFrameStats() const {
+        return stats_;
+    }
+
+private:
+    struct Job {
+        ModelID model = 0;
+        std::string name;
+        std::string slot;
+        bool loadTextures = false;
+
+        ClumpPtr clump;
+        TextureImageList textures;
+        std::string error;
+    };
+
+    void workerMain();
+
+    void process(Job& job);
+
+    void commit(Job& job);
+
+    GameData& data_;
+    Logger* logger_;
+
+    float budget_ = 2.f;
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    bool running_ = false;
+
+    /// Waiting to be picked up by a worker
+    std::deque<Job> queued_;
+    /// Waiting to be committed on the game thread
+    std::deque<Job> finished_;
+    /// Every model between request() and commit()
+    std::unordered_set<ModelID> inFlight_;
+    /// Models that couldn't be loaded
+    std::unordered_set<ModelID> failed_;
+
+    std::size_t requestedThisFrame_ = 0;
+    FrameStats stats_;
+};
+
+#endif
@@ -14,8 +14,8 @@
 Payphone::Payphone(GameWorld* engine_, size_t id_, const glm::vec2& coord)
     : engine(engine_), id(id_) {
     // Find payphone object, original game does this differently
-    for (const auto& p : engine->instancePool.objects) {
-        auto o = p.second.get();
+    for (const auto& p : engine->instancePool) {
+        auto o = p.get();
         if (!o->getClump()) {
             continue;
         }
@@ -983,13 +983,7 @@ bool SaveGame::loadGame(GameState& state, const std::string& file) {
                             zone.level, day.pedgroup, night.pedgroup);
     }
     // Re-build zone hierarchy
-    for (ZoneData& zone : gamezones) {
-        if (&zone == &gamezones[0]) {
-            continue;
-        }
-
-        gamezones[0].insertZone(zone);
-    }
+    state.world->data->buildZoneHierarchy();
 
     // Block 12
     BlockSize gangBlockSize;
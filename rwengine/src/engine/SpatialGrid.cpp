@@ -0,0 +1,89 @@
+#include "engine/SpatialGrid.hpp"
+
+#include <algorithm>
+
+#include <data/Clump.hpp>
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize_(cellSize) {
+}
+
+SpatialGrid::~SpatialGrid() {
+    clear();
+}
+
+void SpatialGrid::insert(GameObject* object) {
+    RW_CHECK(object->grid_ == nullptr, "Object is already in a grid");
+    if (object->grid_) {
+        return;
+    }
+
+    object->grid_ = this;
+    object->gridCell_ = keyFor(object->getPosition());
+    addToCell(object, object->gridCell_);
+    count_++;
+
+    updateRadius(object);
+}
+
+void SpatialGrid::remove(GameObject* object) {
+    if (object->grid_ != this) {
+        return;
+    }
+
+    removeFromCell(object, object->gridCell_);
+    object->grid_ = nullptr;
+    count_--;
+}
+
+void SpatialGrid::update(GameObject* object) {
+    const auto key = keyFor(object->getPosition());
+    if (key == object->gridCell_) {
+        return;
+    }
+
+    removeFromCell(object, object->gridCell_);
+    addToCell(object, key);
+    object->gridCell_ = key;
+}
+
+void SpatialGrid::updateRadius(GameObject* object) {
+    if (const auto& clump = object->getClump()) {
+        maxObjectRadius_ =
+            std::max(maxObjectRadius_, clump->getBoundingRadius());
+    }
+}
+
+void SpatialGrid::clear() {
+    for (auto& [key, objects] : cells_) {
+        for (auto object : objects) {
+            object->grid_ = nullptr;
+        }
+    }
+    cells_.clear();
+    count_ = 0;
+    maxObjectRadius_ = 0.f;
+}
+
+void SpatialGrid::addToCell(GameObject* object, Key key) {
+    cells_[key].push_back(object);
+}
+
+void SpatialGrid::removeFromCell(GameObject* object, Key key) {
+    auto it = cells_.find(key);
+    RW_CHECK(it != cells_.end(), "Object's cell is missing");
+    if (it == cells_.end()) {
+        return;
+    }
+
+    auto& objects = it->second;
+    auto found = std::find(objects.begin(), objects.end(), object);
+    if (found != objects.end()) {
+        *found = objects.back();
+        objects.pop_back();
+    }
+
+    // Only occupied cells are kept, so that large queries can visit them all
+    if (objects.empty()) {
+        cells_.erase(it);
+    }
+}
@@ -0,0 +1,186 @@
+#ifndef _RWENGINE_SPATIALGRID_HPP_
+#define _RWENGINE_SPATIALGRID_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtx/norm.hpp>
+#include <glm/vec3.hpp>
+
+#include <objects/GameObject.hpp>
+
+/**
+ * @brief Uniform grid of objects, for finding the objects near a point
+ * without visiting every object in the world
+ *
+ * The grid is divided on the X and Y axes only, and only cells that contain
+ * objects are stored. Objects stay in the grid until they are removed or
+ * destroyed, and move between cells whenever their position is set.
+ */
+class SpatialGrid {
+public:
+    using Key = uint64_t;
+
+    static constexpr float kDefaultCellSize = 32.f;
+
+    explicit SpatialGrid(float cellSize = kDefaultCellSize);
+
+    ~SpatialGrid();
+
+    SpatialGrid(const SpatialGrid&) = delete;
+    SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+    void insert(GameObject* object);
+
+    void remove(GameObject* object);
+
+    /**
+     * Moves the object to the cell for its current position
+     */
+    void update(GameObject* object);
+
+    /**
+     * Grows the largest object radius to cover the object's current model
+     */
+    void updateRadius(GameObject* object);
+
+    void clear();
+
+    std::size_t size() const {
+        return count_;
+    }
+
+    /**
+     * @return the largest bounding radius the objects inserted have had, for
+     * queries that must include objects overlapping the area
+     */
+    float getMaxObjectRadius() const {
+        return maxObjectRadius_;
+    }
+
+    /**
+     * Calls function with every object whose position is inside the box
+     */
+    template <class Function>
+    void forEachInBox(const glm::vec3& min, const glm::vec3& max,
+                      Function&& function) const {
+        visitBox(min, max, [&](GameObject* object) {
+            const auto& p = object->getPosition();
+            if (p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+                p.x <= max.x && p.y <= max.y && p.z <= max.z) {
+                function(object);
+            }
+            return false;
+        });
+    }
+
+    /**
+     * Calls function with every object whose position is within radius of
+     * center
+     */
+    template <class Function>
+    void forEachInRadius(const glm::vec3& center, float radius,
+                         Function&& function) const {
+        const auto radius2 = radius * radius;
+        visitBox(center - glm::vec3(radius), center + glm::vec3(radius),
+                 [&](GameObject* object) {
+                     if (glm::distance2(center, object->getPosition()) <=
+                         radius2) {
+                         function(object);
+                     }
+                     return false;
+                 });
+    }
+
+    /**
+     * @return true if predicate is true for an object within radius of
+     * center, stopping at the first one
+     */
+    template <class Predicate>
+    bool anyInRadius(const glm::vec3& center, float radius,
+                     Predicate&& predicate) const {
+        const auto radius2 = radius * radius;
+        return visitBox(center - glm::vec3(radius),
+                        center + glm::vec3(radius), [&](GameObject* object) {
+                            return glm::distance2(center,
+                                                  object->getPosition()) <=
+                                       radius2 &&
+                                   predicate(object);
+                        });
+    }
+
+private:
+    int32_t cellCoord(float v) const {
+        return static_cast<int32_t>(std::floor(v / cellSize_));
+    }
+
+    static Key makeKey(int32_t x, int32_t y) {
+        return (static_cast<Key>(static_cast<uint32_t>(x)) << 32) |
+               static_cast<uint32_t>(y);
+    }
+
+    Key keyFor(const glm::vec3& position) const {
+        return makeKey(cellCoord(position.x), cellCoord(position.y));
+    }
+
+    void addToCell(GameObject* object, Key key);
+
+    void removeFromCell(GameObject* object, Key key);
+
+    /**
+     * Calls visitor with each object in the cells overlapping the box,
+     * stopping when it returns true
+     *
+     * @return true if the visitor stopped the search
+     */
+    template <class Visitor>
+    bool visitBox(const glm::vec3& min, const glm::vec3& max,
+                  Visitor&& visitor) const {
+        const auto x0 = cellCoord(min.x), x1 = cellCoord(max.x);
+        const auto y0 = cellCoord(min.y), y1 = cellCoord(max.y);
+        const auto area = (static_cast<double>(x1) - x0 + 1) *
+                          (static_cast<double>(y1) - y0 + 1);
+
+        // Large areas have more cells to look up than there are occupied
+        if (area > static_cast<double>(cells_.size())) {
+            for (const auto& [key, objects] : cells_) {
+                const auto x = static_cast<int32_t>(key >> 32);
+                const auto y = static_cast<int32_t>(key & 0xFFFFFFFF);
+                if (x < x0 || x > x1 || y < y0 || y > y1) {
+                    continue;
+                }
+                for (auto object : objects) {
+                    if (visitor(object)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        for (auto x = x0; x <= x1; ++x) {
+            for (auto y = y0; y <= y1; ++y) {
+                auto it = cells_.find(makeKey(x, y));
+                if (it == cells_.end()) {
+                    continue;
+                }
+                for (auto object : it->second) {
+                    if (visitor(object)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    float cellSize_;
+    std::size_t count_ = 0;
+    float maxObjectRadius_ = 0.f;
+    std::unordered_map<Key, std::vector<GameObject*>> cells_;
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "engine/StaticInstanceGrid.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <data/Clump.hpp>
+#include <rw/debug.hpp>
+
+#include "data/ModelData.hpp"
+#include "objects/InstanceObject.hpp"
+
+StaticInstanceGrid::StaticInstanceGrid(float cellSize) : cellSize_(cellSize) {
+}
+
+StaticInstanceGrid::~StaticInstanceGrid() {
+    clear();
+}
+
+void StaticInstanceGrid::insert(InstanceObject* instance) {
+    RW_CHECK(instance->cellGrid_ == nullptr, "Instance is already in a grid");
+    if (instance->cellGrid_) {
+        return;
+    }
+
+    const auto key = keyFor(instance->getPosition());
+    auto it = cellIndices_.find(key);
+    if (it == cellIndices_.end()) {
+        it = cellIndices_.emplace(key, static_cast<uint32_t>(cells_.size()))
+                 .first;
+        cells_.emplace_back();
+    }
+
+    auto& cell = cells_[it->second];
+    instance->cellGrid_ = this;
+    instance->cell_ = it->second;
+    instance->cellSlot_ = static_cast<uint32_t>(cell.instances.size());
+    cell.instances.push_back(instance);
+    cell.dirty = true;
+    cell.version++;
+    count_++;
+}
+
+void StaticInstanceGrid::remove(InstanceObject* instance) {
+    if (instance->cellGrid_ != this) {
+        return;
+    }
+
+    auto& cell = cells_[instance->cell_];
+    auto& instances = cell.instances;
+    instances[instance->cellSlot_] = instances.back();
+    instances[instance->cellSlot_]->cellSlot_ = instance->cellSlot_;
+    instances.pop_back();
+    cell.dirty = true;
+    cell.version++;
+
+    instance->cellGrid_ = nullptr;
+    count_--;
+}
+
+void StaticInstanceGrid::invalidate(InstanceObject* instance) {
+    if (instance->cellGrid_ == this) {
+        auto& cell = cells_[instance->cell_];
+        cell.dirty = true;
+        cell.version++;
+    }
+}
+
+void StaticInstanceGrid::clear() {
+    for (auto& cell : cells_) {
+        for (auto instance : cell.instances) {
+            instance->cellGrid_ = nullptr;
+        }
+    }
+    cells_.clear();
+    cellIndices_.clear();
+    count_ = 0;
+}
+
+void StaticInstanceGrid::updateBounds() {
+    for (auto& cell : cells_) {
+        if (cell.dirty) {
+            computeBounds(cell);
+            cell.dirty = false;
+        }
+    }
+}
+
+void StaticInstanceGrid::computeBounds(Cell& cell) {
+    if (cell.instances.empty()) {
+        cell.radius = 0.f;
+        cell.lodDistance = 0.f;
+        return;
+    }
+
+    constexpr auto kMax = std::numeric_limits<float>::max();
+    glm::vec3 min{kMax}, max{-kMax};
+    glm::vec3 boundsMin{kMax}, boundsMax{-kMax};
+    float lodDistance = 0.f;
+
+    for (auto instance : cell.instances) {
+        const auto& position = instance->getPosition();
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+
+        // ObjectRenderer offsets the geometry's bounds by the position only
+        auto addGeometry = [&](const Atomic* atomic) {
+            if (!atomic || !atomic->getGeometry()) {
+                return;
+            }
+            const auto& bounds = atomic->getGeometry()->geometryBounds;
+            boundsMin = glm::min(boundsMin, position + bounds.center -
+                                                glm::vec3(bounds.radius));
+            boundsMax = glm::max(boundsMax, position + bounds.center +
+                                                glm::vec3(bounds.radius));
+        };
+
+        // The instance's atomic is given the geometry of one of its model's
+        // atomics, depending on the distance
+        addGeometry(instance->getAtomic().get());
+        auto modelinfo = instance->getModelInfo<SimpleModelInfo>();
+        for (auto i = 0; i < modelinfo->getNumAtomics(); ++i) {
+            addGeometry(modelinfo->getAtomic(i));
+        }
+
+        lodDistance = std::max(lodDistance, modelinfo->getLargestLodDistance());
+    }
+
+    // None of the models are loaded, so nothing in the cell can be drawn
+    if (boundsMin.x > boundsMax.x) {
+        boundsMin = min;
+        boundsMax = max;
+    }
+
+    cell.min = min;
+    cell.max = max;
+    cell.center = (boundsMin + boundsMax) * 0.5f;
+    cell.radius = glm::length(boundsMax - boundsMin) * 0.5f;
+    cell.lodDistance = lodDistance;
+}
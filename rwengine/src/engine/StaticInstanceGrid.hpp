@@ -0,0 +1,100 @@
+#ifndef _RWENGINE_STATICINSTANCEGRID_HPP_
+#define _RWENGINE_STATICINSTANCEGRID_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+class InstanceObject;
+
+/**
+ * @brief Uniform grid of the map's static instances, for rejecting whole
+ * cells when building the render list
+ *
+ * Like SpatialGrid the grid is divided on the X and Y axes only. Each cell
+ * keeps bounds that cover every instance in it:
+ *  - the box around the instances' positions, for the draw distance test
+ *  - a sphere around the bounds of every LOD geometry of the instances, for
+ *    the frustum test
+ *  - the largest LOD distance of the instances' models
+ *
+ * Instances stay in the cell they were inserted in. Moving one or changing
+ * its model marks the cell, and its bounds are computed again by the next
+ * updateBounds().
+ */
+class StaticInstanceGrid {
+public:
+    using Key = uint64_t;
+
+    static constexpr float kDefaultCellSize = 128.f;
+
+    struct Cell {
+        std::vector<InstanceObject*> instances;
+        glm::vec3 min{};
+        glm::vec3 max{};
+        glm::vec3 center{};
+        float radius = 0.f;
+        float lodDistance = 0.f;
+        /// The bounds no longer cover the instances
+        bool dirty = true;
+        /// Changes whenever the instances change, for data built from them
+        uint32_t version = 0;
+    };
+
+    explicit StaticInstanceGrid(float cellSize = kDefaultCellSize);
+
+    ~StaticInstanceGrid();
+
+    StaticInstanceGrid(const StaticInstanceGrid&) = delete;
+    StaticInstanceGrid& operator=(const StaticInstanceGrid&) = delete;
+
+    void insert(InstanceObject* instance);
+
+    void remove(InstanceObject* instance);
+
+    /**
+     * Marks the instance's cell, after it has moved, changed model or been
+     * hidden
+     */
+    void invalidate(InstanceObject* instance);
+
+    void clear();
+
+    /**
+     * Computes the bounds of the cells that have been marked
+     */
+    void updateBounds();
+
+    std::size_t size() const {
+        return count_;
+    }
+
+    const std::vector<Cell>& getCells() const {
+        return cells_;
+    }
+
+private:
+    int32_t cellCoord(float v) const {
+        return static_cast<int32_t>(std::floor(v / cellSize_));
+    }
+
+    Key keyFor(const glm::vec3& position) const {
+        return (static_cast<Key>(static_cast<uint32_t>(cellCoord(position.x)))
+                << 32) |
+               static_cast<uint32_t>(cellCoord(position.y));
+    }
+
+    static void computeBounds(Cell& cell);
+
+    float cellSize_;
+    std::size_t count_ = 0;
+    /// Cells are only added, so that instances can keep their cell's index
+    std::vector<Cell> cells_;
+    std::unordered_map<Key, uint32_t> cellIndices_;
+};
+
+#endif
@@ -0,0 +1,843 @@
+#include "loaders/LevelCache.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+#include <platform/MappedFile.hpp>
+
+#include "data/CollisionModel.hpp"
+#include "data/ModelData.hpp"
+#include "data/PathData.hpp"
+#include "loaders/LoaderCOL.hpp"
+#include "loaders/LoaderIDE.hpp"
+#include "loaders/LoaderIPL.hpp"
+
+namespace {
+
+constexpr char kMagic[4] = {'R', 'W', 'L', 'C'};
+constexpr uint32_t kVersion = 1;
+
+enum class EntryKind : uint32_t { IPL = 1, COL = 2, IDE = 3 };
+
+struct EntryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t kind;
+    /// Sizes of the records, so entries from a different build are rejected
+    uint32_t layout;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint64_t sourceHash;
+};
+
+/// Strings are stored as offsets into a table at the end of the entry
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct InstanceRecord {
+    int32_t id;
+    StringRef model;
+    float pos[3];
+    float scale[3];
+    float rot[4];
+};
+
+struct ZoneRecord {
+    StringRef name;
+    int32_t type;
+    float min[3];
+    float max[3];
+    int32_t island;
+};
+
+struct CollisionRecord {
+    StringRef name;
+    uint32_t modelid;
+    CollisionModel::Sphere boundingSphere;
+    CollisionModel::Box boundingBox;
+    uint32_t spheres;
+    uint32_t boxes;
+    uint32_t vertices;
+    uint32_t faces;
+};
+
+struct SimpleModelRecord {
+    int32_t id;
+    StringRef name;
+    StringRef textureslot;
+    uint32_t numAtomics;
+    float lodDistances[3];
+    int32_t flags;
+    int32_t timeOn;
+    int32_t timeOff;
+    /// Number of the following path records that belong to the model
+    uint32_t paths;
+};
+
+struct PathRecord {
+    int32_t type;
+    int32_t id;
+    StringRef modelName;
+    uint32_t nodes;
+};
+
+struct ClumpModelRecord {
+    int32_t id;
+    StringRef name;
+    StringRef textureslot;
+};
+
+struct VehicleModelRecord {
+    int32_t id;
+    StringRef name;
+    StringRef textureslot;
+    int32_t type;
+    StringRef handling;
+    StringRef vehicleName;
+    int32_t vehicleClass;
+    int32_t frequency;
+    int32_t level;
+    uint32_t componentRules;
+    int32_t wheelModel;
+    float wheelScale;
+};
+
+struct PedModelRecord {
+    int32_t id;
+    StringRef name;
+    StringRef textureslot;
+    int32_t type;
+    /// Stored by name, the ped stats may have changed since
+    StringRef stats;
+    StringRef animGroup;
+    int32_t carsMask;
+};
+
+static_assert(std::is_trivially_copyable_v<CollisionModel::Sphere> &&
+                  std::is_trivially_copyable_v<CollisionModel::Box> &&
+                  std::is_trivially_copyable_v<CollisionModel::Triangle> &&
+                  std::is_trivially_copyable_v<glm::vec3>,
+              "Collision data must be stored as plain bytes");
+static_assert(std::is_trivially_copyable_v<PathNode>,
+              "Path nodes must be stored as plain bytes");
+
+constexpr uint32_t layoutOf(EntryKind kind) {
+    switch (kind) {
+        case EntryKind::IPL:
+            return sizeof(InstanceRecord) << 16 | sizeof(ZoneRecord);
+        case EntryKind::COL:
+            return sizeof(CollisionRecord) << 24 |
+                   sizeof(CollisionModel::Sphere) << 16 |
+                   sizeof(CollisionModel::Box) << 8 |
+                   sizeof(CollisionModel::Triangle);
+        case EntryKind::IDE:
+            return sizeof(SimpleModelRecord) << 24 |
+                   sizeof(VehicleModelRecord) << 16 |
+                   sizeof(PedModelRecord) << 8 | sizeof(PathNode);
+    }
+    return 0;
+}
+
+constexpr std::size_t kAlignment = 8;
+
+/// FNV-1a, fast enough to check sources that have only been touched
+uint64_t hashBytes(const char* data, std::size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+struct Source {
+    uint64_t size = 0;
+    int64_t time = 0;
+    /// Only read when the entry can't be validated by size and time
+    std::optional<std::string> contents;
+
+    bool read(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        contents = ss.str();
+        return true;
+    }
+
+    uint64_t hash() const {
+        return hashBytes(contents->data(), contents->size());
+    }
+};
+
+bool statSource(const std::filesystem::path& path, Source& source) {
+    std::error_code ec;
+    source.size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    source.time = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+/// Builds the body of an entry as a sequence of aligned arrays
+class EntryWriter {
+public:
+    template <class T>
+    void array(const T* data, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto count32 = static_cast<uint32_t>(count);
+        append(&count32, sizeof(count32));
+        align();
+        append(data, sizeof(T) * count);
+        align();
+    }
+
+    template <class T>
+    void array(const std::vector<T>& data) {
+        array(data.data(), data.size());
+    }
+
+    StringRef string(const std::string& value) {
+        StringRef ref{static_cast<uint32_t>(strings_.size()),
+                      static_cast<uint32_t>(value.size())};
+        strings_ += value;
+        return ref;
+    }
+
+    /// Writes the header, body and string table to path, replacing it only
+    /// once the whole entry has been written
+    bool write(const std::filesystem::path& path, const EntryHeader& header) {
+        array(strings_.data(), strings_.size());
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        auto temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+            if (!file) {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+private:
+    void append(const void* data, std::size_t size) {
+        const auto bytes = static_cast<const char*>(data);
+        data_.insert(data_.end(), bytes, bytes + size);
+    }
+
+    void align() {
+        data_.resize((data_.size() + kAlignment - 1) / kAlignment * kAlignment);
+    }
+
+    std::vector<char> data_;
+    std::string strings_;
+};
+
+/// Reads the arrays of a mapped entry in the order they were written
+class EntryReader {
+public:
+    EntryReader(std::shared_ptr<const char[]> mapping, std::size_t size)
+        : mapping_(std::move(mapping)), size_(size) {
+    }
+
+    const EntryHeader* header() const {
+        if (size_ < sizeof(EntryHeader)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const EntryHeader*>(mapping_.get());
+    }
+
+    template <class T>
+    const T* array(uint32_t& count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        count = 0;
+        if (!take(sizeof(uint32_t))) {
+            return nullptr;
+        }
+        std::memcpy(&count, mapping_.get() + offset_ - sizeof(uint32_t),
+                    sizeof(uint32_t));
+        align();
+        const auto begin = offset_;
+        if (!take(sizeof(T) * count)) {
+            count = 0;
+            return nullptr;
+        }
+        align();
+        return reinterpret_cast<const T*>(mapping_.get() + begin);
+    }
+
+    /// Reads the string table, which must be the last array
+    bool strings() {
+        strings_ = array<char>(stringsSize_);
+        return strings_ != nullptr;
+    }
+
+    std::string string(const StringRef& ref) const {
+        if (ref.length == 0 ||
+            static_cast<uint64_t>(ref.offset) + ref.length > stringsSize_) {
+            return {};
+        }
+        return std::string(strings_ + ref.offset, ref.length);
+    }
+
+private:
+    bool take(std::size_t bytes) {
+        if (!valid_ || offset_ + bytes > size_) {
+            valid_ = false;
+            return false;
+        }
+        offset_ += bytes;
+        return true;
+    }
+
+    void align() {
+        offset_ = std::min(size_, (offset_ + kAlignment - 1) / kAlignment *
+                                      kAlignment);
+    }
+
+    std::shared_ptr<const char[]> mapping_;
+    std::size_t size_;
+    std::size_t offset_ = sizeof(EntryHeader);
+    bool valid_ = true;
+    const char* strings_ = nullptr;
+    uint32_t stringsSize_ = 0;
+};
+
+EntryHeader makeHeader(EntryKind kind, const Source& source) {
+    EntryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.kind = static_cast<uint32_t>(kind);
+    header.layout = layoutOf(kind);
+    header.sourceSize = source.size;
+    header.sourceTime = source.time;
+    header.sourceHash = source.hash();
+    return header;
+}
+
+/// Maps the entry if it was compiled from source, reading the source to
+/// compare its hash if it has a different time
+std::optional<EntryReader> openEntry(const std::filesystem::path& entry,
+                                     const std::filesystem::path& path,
+                                     EntryKind kind, Source& source) {
+    std::size_t size = 0;
+    auto mapping = mapFile(entry, size);
+    if (!mapping) {
+        return std::nullopt;
+    }
+
+    EntryReader reader(std::move(mapping), size);
+    const auto header = reader.header();
+    if (!header || std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+        header->version != kVersion ||
+        header->kind != static_cast<uint32_t>(kind) ||
+        header->layout != layoutOf(kind) || header->sourceSize != source.size) {
+        return std::nullopt;
+    }
+
+    if (header->sourceTime != source.time) {
+        if (!source.read(path) || source.hash() != header->sourceHash) {
+            return std::nullopt;
+        }
+
+        // Same contents, remember the new time so the source isn't hashed
+        // again next time
+        auto updated = *header;
+        updated.sourceTime = source.time;
+        std::fstream file(entry,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.write(reinterpret_cast<const char*>(&updated), sizeof(updated));
+    }
+
+    return reader;
+}
+
+/// Appends the entry's contents to ipl, or nothing if it's damaged
+bool readIPL(EntryReader& reader, LoaderIPL& ipl) {
+    uint32_t instanceCount = 0, zoneCount = 0;
+    const auto instances = reader.array<InstanceRecord>(instanceCount);
+    const auto zones = reader.array<ZoneRecord>(zoneCount);
+    if (!reader.strings()) {
+        return false;
+    }
+
+    ipl.m_instances.reserve(ipl.m_instances.size() + instanceCount);
+    for (uint32_t i = 0; i < instanceCount; ++i) {
+        const auto& r = instances[i];
+        ipl.m_instances.emplace_back(
+            r.id, reader.string(r.model),
+            glm::vec3(r.pos[0], r.pos[1], r.pos[2]),
+            glm::vec3(r.scale[0], r.scale[1], r.scale[2]),
+            glm::quat(r.rot[3], r.rot[0], r.rot[1], r.rot[2]));
+    }
+
+    for (uint32_t i = 0; i < zoneCount; ++i) {
+        const auto& r = zones[i];
+        ipl.zones.emplace_back(reader.string(r.name), r.type,
+                               glm::vec3(r.min[0], r.min[1], r.min[2]),
+                               glm::vec3(r.max[0], r.max[1], r.max[2]),
+                               r.island, 0u, 0u);
+    }
+
+    return true;
+}
+
+void writeIPL(EntryWriter& writer, const LoaderIPL& ipl) {
+    std::vector<InstanceRecord> instances;
+    instances.reserve(ipl.m_instances.size());
+    for (const auto& inst : ipl.m_instances) {
+        instances.push_back({inst.id,
+                             writer.string(inst.model),
+                             {inst.pos.x, inst.pos.y, inst.pos.z},
+                             {inst.scale.x, inst.scale.y, inst.scale.z},
+                             {inst.rot.x, inst.rot.y, inst.rot.z, inst.rot.w}});
+    }
+
+    std::vector<ZoneRecord> zones;
+    zones.reserve(ipl.zones.size());
+    for (const auto& zone : ipl.zones) {
+        zones.push_back({writer.string(zone.name),
+                         zone.type,
+                         {zone.min.x, zone.min.y, zone.min.z},
+                         {zone.max.x, zone.max.y, zone.max.z},
+                         zone.island});
+    }
+
+    writer.array(instances);
+    writer.array(zones);
+}
+
+/// Appends the entry's contents to col, or nothing if it's damaged
+bool readCOL(EntryReader& reader, LoaderCOL& col) {
+    uint32_t modelCount = 0, sphereCount = 0, boxCount = 0, vertexCount = 0,
+             faceCount = 0;
+    const auto models = reader.array<CollisionRecord>(modelCount);
+    const auto spheres = reader.array<CollisionModel::Sphere>(sphereCount);
+    const auto boxes = reader.array<CollisionModel::Box>(boxCount);
+    const auto vertices = reader.array<glm::vec3>(vertexCount);
+    const auto faces = reader.array<CollisionModel::Triangle>(faceCount);
+    if (!reader.strings()) {
+        return false;
+    }
+
+    uint64_t totalSpheres = 0, totalBoxes = 0, totalVertices = 0,
+             totalFaces = 0;
+    for (uint32_t i = 0; i < modelCount; ++i) {
+        totalSpheres += models[i].spheres;
+        totalBoxes += models[i].boxes;
+        totalVertices += models[i].vertices;
+        totalFaces += models[i].faces;
+    }
+    if (totalSpheres != sphereCount || totalBoxes != boxCount ||
+        totalVertices != vertexCount || totalFaces != faceCount) {
+        return false;
+    }
+
+    col.collisions.reserve(col.collisions.size() + modelCount);
+    auto s = spheres;
+    auto b = boxes;
+    auto v = vertices;
+    auto f = faces;
+    for (uint32_t i = 0; i < modelCount; ++i) {
+        const auto& r = models[i];
+        auto model = std::make_unique<CollisionModel>();
+        model->name = reader.string(r.name);
+        model->modelid = static_cast<uint16_t>(r.modelid);
+        model->boundingSphere = r.boundingSphere;
+        model->boundingBox = r.boundingBox;
+        model->spheres.assign(s, s + r.spheres);
+        model->boxes.assign(b, b + r.boxes);
+        model->vertices.assign(v, v + r.vertices);
+        model->faces.assign(f, f + r.faces);
+        s += r.spheres;
+        b += r.boxes;
+        v += r.vertices;
+        f += r.faces;
+        col.collisions.push_back(std::move(model));
+    }
+
+    return true;
+}
+
+void writeCOL(EntryWriter& writer, const LoaderCOL& col) {
+    std::vector<CollisionRecord> models;
+    std::vector<CollisionModel::Sphere> spheres;
+    std::vector<CollisionModel::Box> boxes;
+    std::vector<glm::vec3> vertices;
+    std::vector<CollisionModel::Triangle> faces;
+
+    models.reserve(col.collisions.size());
+    for (const auto& model : col.collisions) {
+        models.push_back({writer.string(model->name), model->modelid,
+                          model->boundingSphere, model->boundingBox,
+                          static_cast<uint32_t>(model->spheres.size()),
+                          static_cast<uint32_t>(model->boxes.size()),
+                          static_cast<uint32_t>(model->vertices.size()),
+                          static_cast<uint32_t>(model->faces.size())});
+        spheres.insert(spheres.end(), model->spheres.begin(),
+                       model->spheres.end());
+        boxes.insert(boxes.end(), model->boxes.begin(), model->boxes.end());
+        vertices.insert(vertices.end(), model->vertices.begin(),
+                        model->vertices.end());
+        faces.insert(faces.end(), model->faces.begin(), model->faces.end());
+    }
+
+    writer.array(models);
+    writer.array(spheres);
+    writer.array(boxes);
+    writer.array(vertices);
+    writer.array(faces);
+}
+
+/// Adds the entry's contents to ide, or nothing if it's damaged
+bool readIDE(EntryReader& reader, const PedStatsList& stats, LoaderIDE& ide) {
+    uint32_t simpleCount = 0, pathCount = 0, nodeCount = 0, clumpCount = 0,
+             vehicleCount = 0, pedCount = 0;
+    const auto simples = reader.array<SimpleModelRecord>(simpleCount);
+    const auto paths = reader.array<PathRecord>(pathCount);
+    const auto nodes = reader.array<PathNode>(nodeCount);
+    const auto clumps = reader.array<ClumpModelRecord>(clumpCount);
+    const auto vehicles = reader.array<VehicleModelRecord>(vehicleCount);
+    const auto peds = reader.array<PedModelRecord>(pedCount);
+    if (!reader.strings()) {
+        return false;
+    }
+
+    uint64_t totalPaths = 0, totalNodes = 0;
+    for (uint32_t i = 0; i < simpleCount; ++i) {
+        if (simples[i].numAtomics > 3) {
+            return false;
+        }
+        totalPaths += simples[i].paths;
+    }
+    for (uint32_t i = 0; i < pathCount; ++i) {
+        totalNodes += paths[i].nodes;
+    }
+    if (totalPaths != pathCount || totalNodes != nodeCount) {
+        return false;
+    }
+
+    std::map<ModelID, std::unique_ptr<BaseModelInfo>> objects;
+    auto p = paths;
+    auto n = nodes;
+    for (uint32_t i = 0; i < simpleCount; ++i) {
+        const auto& r = simples[i];
+        auto info = std::make_unique<SimpleModelInfo>();
+        info->setModelID(static_cast<ModelID>(r.id));
+        info->name = reader.string(r.name);
+        info->textureslot = reader.string(r.textureslot);
+        info->setNumAtomics(static_cast<int>(r.numAtomics));
+        for (uint32_t a = 0; a < r.numAtomics; ++a) {
+            info->setLodDistance(static_cast<int>(a), r.lodDistances[a]);
+        }
+        info->determineFurthest();
+        info->flags = r.flags;
+        info->timeOn = r.timeOn;
+        info->timeOff = r.timeOff;
+        for (uint32_t j = 0; j < r.paths; ++j, ++p) {
+            PathData path;
+            path.type = static_cast<PathData::PathType>(p->type);
+            path.ID = static_cast<uint16_t>(p->id);
+            path.modelName = reader.string(p->modelName);
+            path.nodes.assign(n, n + p->nodes);
+            n += p->nodes;
+            info->paths.push_back(std::move(path));
+        }
+        objects.emplace(info->id(), std::move(info));
+    }
+
+    for (uint32_t i = 0; i < clumpCount; ++i) {
+        const auto& r = clumps[i];
+        auto info = std::make_unique<ClumpModelInfo>();
+        info->setModelID(static_cast<ModelID>(r.id));
+        info->name = reader.string(r.name);
+        info->textureslot = reader.string(r.textureslot);
+        objects.emplace(info->id(), std::move(info));
+    }
+
+    for (uint32_t i = 0; i < vehicleCount; ++i) {
+        const auto& r = vehicles[i];
+        auto info = std::make_unique<VehicleModelInfo>();
+        info->setModelID(static_cast<ModelID>(r.id));
+        info->name = reader.string(r.name);
+        info->textureslot = reader.string(r.textureslot);
+        info->vehicletype_ = static_cast<VehicleModelInfo::VehicleType>(r.type);
+        info->handling_ = reader.string(r.handling);
+        info->vehiclename_ = reader.string(r.vehicleName);
+        info->vehicleclass_ =
+            static_cast<VehicleModelInfo::VehicleClass>(r.vehicleClass);
+        info->frequency_ = r.frequency;
+        info->level_ = r.level;
+        info->componentrules_ = r.componentRules;
+        info->wheelmodel_ = static_cast<ModelID>(r.wheelModel);
+        info->wheelscale_ = r.wheelScale;
+        objects.emplace(info->id(), std::move(info));
+    }
+
+    for (uint32_t i = 0; i < pedCount; ++i) {
+        const auto& r = peds[i];
+        auto info = std::make_unique<PedModelInfo>();
+        info->setModelID(static_cast<ModelID>(r.id));
+        info->name = reader.string(r.name);
+        info->textureslot = reader.string(r.textureslot);
+        info->pedtype_ = static_cast<PedModelInfo::PedType>(r.type);
+        info->statindex_ = LoaderIDE::findPedStats(stats, reader.string(r.stats));
+        info->animgroup_ = reader.string(r.animGroup);
+        info->carsmask_ = r.carsMask;
+        objects.emplace(info->id(), std::move(info));
+    }
+
+    ide.objects.merge(objects);
+    return true;
+}
+
+void writeIDE(EntryWriter& writer, const PedStatsList& stats,
+              const LoaderIDE& ide) {
+    auto statsName = [&](int id) {
+        auto it = std::find_if(stats.begin(), stats.end(),
+                               [&](const PedStats& s) { return s.id_ == id; });
+        return it == stats.end() ? std::string() : it->name_;
+    };
+
+    std::vector<SimpleModelRecord> simples;
+    std::vector<PathRecord> paths;
+    std::vector<PathNode> nodes;
+    std::vector<ClumpModelRecord> clumps;
+    std::vector<VehicleModelRecord> vehicles;
+    std::vector<PedModelRecord> peds;
+
+    for (const auto& [id, object] : ide.objects) {
+        switch (object->type()) {
+            case ModelDataType::SimpleInfo: {
+                const auto& info =
+                    static_cast<const SimpleModelInfo&>(*object);
+                SimpleModelRecord r{};
+                r.id = id;
+                r.name = writer.string(info.name);
+                r.textureslot = writer.string(info.textureslot);
+                r.numAtomics = static_cast<uint32_t>(info.getNumAtomics());
+                for (int a = 0; a < info.getNumAtomics(); ++a) {
+                    r.lodDistances[a] = info.getLodDistance(a);
+                }
+                r.flags = info.flags;
+                r.timeOn = info.timeOn;
+                r.timeOff = info.timeOff;
+                r.paths = static_cast<uint32_t>(info.paths.size());
+                for (const auto& path : info.paths) {
+                    paths.push_back({path.type, path.ID,
+                                     writer.string(path.modelName),
+                                     static_cast<uint32_t>(path.nodes.size())});
+                    nodes.insert(nodes.end(), path.nodes.begin(),
+                                 path.nodes.end());
+                }
+                simples.push_back(r);
+                break;
+            }
+            case ModelDataType::ClumpInfo:
+                clumps.push_back({id, writer.string(object->name),
+                                  writer.string(object->textureslot)});
+                break;
+            case ModelDataType::VehicleInfo: {
+                const auto& info =
+                    static_cast<const VehicleModelInfo&>(*object);
+                // Only cars have wheels, the rest are left unset
+                const bool car = info.vehicletype_ == VehicleModelInfo::CAR;
+                vehicles.push_back(
+                    {id, writer.string(info.name),
+                     writer.string(info.textureslot), info.vehicletype_,
+                     writer.string(info.handling_),
+                     writer.string(info.vehiclename_), info.vehicleclass_,
+                     info.frequency_, info.level_,
+                     static_cast<uint32_t>(info.componentrules_),
+                     car ? info.wheelmodel_ : 0, car ? info.wheelscale_ : 0.f});
+                break;
+            }
+            case ModelDataType::PedInfo: {
+                const auto& info = static_cast<const PedModelInfo&>(*object);
+                peds.push_back({id, writer.string(info.name),
+                                writer.string(info.textureslot), info.pedtype_,
+                                writer.string(statsName(info.statindex_)),
+                                writer.string(info.animgroup_),
+                                info.carsmask_});
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    writer.array(simples);
+    writer.array(paths);
+    writer.array(nodes);
+    writer.array(clumps);
+    writer.array(vehicles);
+    writer.array(peds);
+}
+
+}  // namespace
+
+LevelCache::LevelCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {
+}
+
+std::filesystem::path LevelCache::getEntryPath(
+    const std::filesystem::path& source) const {
+    const auto key = source.generic_string();
+    std::ostringstream name;
+    name << source.filename().string() << '-' << std::hex << std::setw(16)
+         << std::setfill('0') << hashBytes(key.data(), key.size()) << ".bin";
+    return directory_ / name.str();
+}
+
+bool LevelCache::loadIDE(const std::filesystem::path& path,
+                         const PedStatsList& stats, LoaderIDE& ide) {
+    if (!isEnabled()) {
+        stats_.misses++;
+        return ide.load(path.string(), stats);
+    }
+
+    Source source;
+    if (!statSource(path, source)) {
+        return false;
+    }
+
+    const auto entry = getEntryPath(path);
+    if (auto reader = openEntry(entry, path, EntryKind::IDE, source)) {
+        if (readIDE(*reader, stats, ide)) {
+            stats_.hits++;
+            return true;
+        }
+    }
+
+    stats_.misses++;
+    if (!source.contents && !source.read(path)) {
+        return false;
+    }
+
+    LoaderIDE parsed;
+    std::istringstream stream(*source.contents);
+    if (!parsed.load(stream, stats)) {
+        return false;
+    }
+
+    EntryWriter writer;
+    writeIDE(writer, stats, parsed);
+    writer.write(entry, makeHeader(EntryKind::IDE, source));
+
+    ide.objects.merge(parsed.objects);
+    return true;
+}
+
+bool LevelCache::loadIPL(const std::filesystem::path& path, LoaderIPL& ipl) {
+    if (!isEnabled()) {
+        stats_.misses++;
+        return ipl.load(path.string());
+    }
+
+    Source source;
+    if (!statSource(path, source)) {
+        return false;
+    }
+
+    const auto entry = getEntryPath(path);
+    if (auto reader = openEntry(entry, path, EntryKind::IPL, source)) {
+        if (readIPL(*reader, ipl)) {
+            stats_.hits++;
+            return true;
+        }
+    }
+
+    stats_.misses++;
+    if (!source.contents && !source.read(path)) {
+        return false;
+    }
+
+    LoaderIPL parsed;
+    std::istringstream stream(*source.contents);
+    if (!parsed.load(stream)) {
+        return false;
+    }
+
+    EntryWriter writer;
+    writeIPL(writer, parsed);
+    writer.write(entry, makeHeader(EntryKind::IPL, source));
+
+    ipl.m_instances.insert(ipl.m_instances.end(), parsed.m_instances.begin(),
+                           parsed.m_instances.end());
+    ipl.zones.insert(ipl.zones.end(), parsed.zones.begin(), parsed.zones.end());
+    return true;
+}
+
+bool LevelCache::loadCOL(const std::filesystem::path& path, LoaderCOL& col) {
+    if (!isEnabled()) {
+        stats_.misses++;
+        return col.load(path.string());
+    }
+
+    Source source;
+    if (!statSource(path, source)) {
+        return false;
+    }
+
+    const auto entry = getEntryPath(path);
+    if (auto reader = openEntry(entry, path, EntryKind::COL, source)) {
+        if (readCOL(*reader, col)) {
+            stats_.hits++;
+            return true;
+        }
+    }
+
+    stats_.misses++;
+    if (!source.contents && !source.read(path)) {
+        return false;
+    }
+
+    LoaderCOL parsed;
+    if (!parsed.load(source.contents->data(), source.contents->size(),
+                     path.string())) {
+        return false;
+    }
+
+    EntryWriter writer;
+    writeCOL(writer, parsed);
+    writer.write(entry, makeHeader(EntryKind::COL, source));
+
+    std::move(parsed.collisions.begin(), parsed.collisions.end(),
+              std::back_inserter(col.collisions));
+    return true;
+}
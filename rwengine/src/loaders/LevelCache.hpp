@@ -0,0 +1,90 @@
+#ifndef _RWENGINE_LEVELCACHE_HPP_
+#define _RWENGINE_LEVELCACHE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+
+#include <data/PedData.hpp>
+
+class LoaderCOL;
+class LoaderIDE;
+class LoaderIPL;
+
+/**
+ * @brief Compiled copies of parsed IDE, IPL and COL files, so that they
+ * don't need to be parsed on every start
+ *
+ * Each source file is compiled to its own file in the cache directory. The
+ * file holds the parsed data as flat arrays, which are memory mapped and
+ * copied out when loaded.
+ *
+ * An entry is used while its source has the same size and modification
+ * time. If only the time has changed, the entry is still used when the
+ * contents hash the same. Otherwise the source is parsed again and the
+ * entry replaced.
+ *
+ * The cache is disabled without a directory, and the files are parsed
+ * every time.
+ */
+class LevelCache {
+public:
+    /// Counted atomically, files can be loaded from several threads
+    struct Statistics {
+        /// Files loaded from the cache
+        std::atomic<std::size_t> hits{0};
+        /// Files parsed, and compiled if the cache is enabled
+        std::atomic<std::size_t> misses{0};
+    };
+
+    LevelCache() = default;
+
+    explicit LevelCache(std::filesystem::path directory);
+
+    void setDirectory(std::filesystem::path directory) {
+        directory_ = std::move(directory);
+    }
+
+    const std::filesystem::path& getDirectory() const {
+        return directory_;
+    }
+
+    bool isEnabled() const {
+        return !directory_.empty();
+    }
+
+    /**
+     * Loads the IDE file at path into ide, from the cache if possible
+     *
+     * Peds refer to their stats by name in the cache, so that they are
+     * matched against the current stats.
+     */
+    bool loadIDE(const std::filesystem::path& path, const PedStatsList& stats,
+                 LoaderIDE& ide);
+
+    /**
+     * Loads the IPL file at path into ipl, from the cache if possible
+     */
+    bool loadIPL(const std::filesystem::path& path, LoaderIPL& ipl);
+
+    /**
+     * Loads the COL file at path into col, from the cache if possible
+     */
+    bool loadCOL(const std::filesystem::path& path, LoaderCOL& col);
+
+    const Statistics& getStatistics() const {
+        return stats_;
+    }
+
+    /**
+     * @return the path of the cache entry compiled from source
+     */
+    std::filesystem::path getEntryPath(
+        const std::filesystem::path& source) const;
+
+private:
+    std::filesystem::path directory_;
+    Statistics stats_;
+};
+
+#endif
@@ -30,10 +30,15 @@ bool LoaderCOL::load(const std::string& path) {
     file.seekg(0);
 
     std::vector<char> buffer(length);
-    auto d = buffer.data();
-    file.read(d, length);
+    file.read(buffer.data(), length);
 
-    while (d < buffer.data() + length) {
+    return load(buffer.data(), length, path);
+}
+
+bool LoaderCOL::load(const char* data, std::size_t length,
+                     const std::string& path) {
+    auto d = data;
+    while (d < data + length) {
         ColHeader head;
         std::memcpy(&head, d, sizeof(head));
         d += sizeof(head);
@@ -48,17 +53,17 @@ bool LoaderCOL::load(const std::string& path) {
         model->modelid = head.modelid;
 
         auto readFloat = [&]() {
-            auto f = reinterpret_cast<float*>(d);
+            auto f = reinterpret_cast<const float*>(d);
             d += sizeof(float);
             return *f;
         };
         auto readU8 = [&]() {
-            auto f = reinterpret_cast<uint8_t*>(d);
+            auto f = reinterpret_cast<const uint8_t*>(d);
             d += sizeof(uint8_t);
             return *f;
         };
         auto readU32 = [&]() {
-            auto f = reinterpret_cast<uint32_t*>(d);
+            auto f = reinterpret_cast<const uint32_t*>(d);
             d += sizeof(uint32_t);
             return *f;
         };
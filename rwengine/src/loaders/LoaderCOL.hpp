@@ -1,6 +1,7 @@
 #ifndef _RWENGINE_LOADERCOL_HPP_
 #define _RWENGINE_LOADERCOL_HPP_
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,6 +18,9 @@ public:
     /// Load the COL data into memory
     bool load(const std::string& file);
 
+    /// Load the COL data from a buffer, path is only used in errors
+    bool load(const char* data, std::size_t length, const std::string& path);
+
     std::vector<std::unique_ptr<CollisionModel>> collisions;
 };
 
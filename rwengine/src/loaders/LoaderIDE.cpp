@@ -19,17 +19,17 @@ bool LoaderIDE::load(const std::string &filename, const PedStatsList &stats) {
     return load(str, stats);
 }
 
-bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
-    auto find_stat_id = [&](const std::string &name) {
-        auto it =
-            std::find_if(stats.begin(), stats.end(),
-                         [&](const PedStats &a) { return a.name_ == name; });
-        if (it == stats.end()) {
-            return -1;
-        }
-        return it->id_;
-    };
+int LoaderIDE::findPedStats(const PedStatsList& stats,
+                            const std::string& name) {
+    auto it = std::find_if(stats.begin(), stats.end(),
+                           [&](const PedStats &a) { return a.name_ == name; });
+    if (it == stats.end()) {
+        return -1;
+    }
+    return it->id_;
+}
 
+bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
     SectionTypes section = NONE;
     while (!str.eof()) {
         std::string line;
@@ -168,7 +168,7 @@ bool LoaderIDE::load(std::istream& str, const PedStatsList& stats) {
 
                     std::string behaviour;
                     getline(strstream, behaviour, ',');
-                    peds->statindex_ = find_stat_id(behaviour);
+                    peds->statindex_ = findPedStats(stats, behaviour);
                     getline(strstream, peds->animgroup_, ',');
 
                     getline(strstream, buff, ',');
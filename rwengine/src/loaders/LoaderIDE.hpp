@@ -26,6 +26,11 @@ public:
 
     bool load(std::istream& data, const PedStatsList& stats);
 
+    /**
+     * @return the id of the ped stats called name, or -1 if there are none
+     */
+    static int findPedStats(const PedStatsList& stats, const std::string& name);
+
     /**
      * @brief objects loaded during the call to load()
      */
@@ -4,41 +4,64 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <memory>
 
+namespace {
+constexpr float kQuantizeScale = 32767.f;
+
+int16_t quantizeComponent(float v) {
+    return static_cast<int16_t>(
+        std::lround(glm::clamp(v, -1.f, 1.f) * kQuantizeScale));
+}
+
+template <class T>
+std::size_t vectorBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+}  // namespace
+
 bool findKeyframes(float t, AnimationBone* bone, AnimationKeyframe& f1,
                    AnimationKeyframe& f2, float& alpha) {
-    for (size_t f = 0; f < bone->frames.size(); ++f) {
-        if (t <= bone->frames[f].starttime) {
-            f2 = bone->frames[f];
-
-            if (f == 0) {
-                if (bone->frames.size() != 1) {
-                    f1 = bone->frames.back();
-                } else {
-                    f1 = f2;
-                }
-            } else {
-                f1 = bone->frames[f - 1];
-            }
-
-            float tdiff = (f2.starttime - f1.starttime);
-            if (tdiff == 0.f) {
-                alpha = 1.f;
-            } else {
-                alpha = glm::clamp((t - f1.starttime) / tdiff, 0.f, 1.f);
-            }
+    // The first frame at or after t
+    const auto next = std::lower_bound(
+        bone->frames.begin(), bone->frames.end(), t,
+        [](const AnimationKeyframe& frame, float time) {
+            return frame.starttime < time;
+        });
+    if (next == bone->frames.end()) {
+        return false;
+    }
 
-            return true;
+    f2 = *next;
+    if (next == bone->frames.begin()) {
+        if (bone->frames.size() != 1) {
+            f1 = bone->frames.back();
+        } else {
+            f1 = f2;
         }
+    } else {
+        f1 = *(next - 1);
     }
-    return false;
+
+    float tdiff = (f2.starttime - f1.starttime);
+    if (tdiff == 0.f) {
+        alpha = 1.f;
+    } else {
+        alpha = glm::clamp((t - f1.starttime) / tdiff, 0.f, 1.f);
+    }
+
+    return true;
 }
 
 AnimationKeyframe AnimationBone::getInterpolatedKeyframe(float time) {
     AnimationKeyframe f1, f2;
     float alpha;
 
+    if (frames.empty()) {
+        return {};
+    }
+
     if (findKeyframes(time, this, f1, f2, alpha)) {
         return {glm::normalize(glm::slerp(f1.rotation, f2.rotation, alpha)),
                 glm::mix(f1.position, f2.position, alpha),
@@ -55,14 +78,285 @@ AnimationKeyframe AnimationBone::getKeyframe(float time) {
             return frame;
         }
     }
-    return frames.back();
+    return frames.empty() ? AnimationKeyframe{} : frames.back();
+}
+
+void AnimationTracks::build(
+    const std::unordered_map<std::string, AnimationBone> &bones,
+    bool quantize) {
+    names.clear();
+    for (const auto &[name, bone] : bones) {
+        if (!bone.frames.empty()) {
+            names.push_back(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    std::size_t keys = 0;
+    std::size_t translations = 0;
+    for (const auto &name : names) {
+        const auto &bone = bones.at(name);
+        keys += bone.frames.size();
+        if (bone.type != AnimationBone::R00) {
+            translations += bone.frames.size();
+        }
+    }
+
+    quantized = quantize;
+    first.clear();
+    translationFirst.clear();
+    times.clear();
+    for (auto v : {&rotationX, &rotationY, &rotationZ, &rotationW, &positionX,
+                   &positionY, &positionZ}) {
+        v->clear();
+    }
+    for (auto v : {&packedRotationX, &packedRotationY, &packedRotationZ,
+                   &packedRotationW}) {
+        v->clear();
+    }
+
+    times.reserve(keys);
+    if (quantized) {
+        for (auto v : {&packedRotationX, &packedRotationY, &packedRotationZ,
+                       &packedRotationW}) {
+            v->reserve(keys);
+        }
+    } else {
+        for (auto v : {&rotationX, &rotationY, &rotationZ, &rotationW}) {
+            v->reserve(keys);
+        }
+    }
+    for (auto v : {&positionX, &positionY, &positionZ}) {
+        v->reserve(translations);
+    }
+
+    for (const auto &name : names) {
+        const auto &bone = bones.at(name);
+        const bool translated = bone.type != AnimationBone::R00;
+        first.push_back(static_cast<uint32_t>(times.size()));
+        translationFirst.push_back(
+            translated ? static_cast<uint32_t>(positionX.size())
+                       : kNoTranslation);
+        for (const auto &frame : bone.frames) {
+            times.push_back(frame.starttime);
+            if (quantized) {
+                packedRotationX.push_back(quantizeComponent(frame.rotation.x));
+                packedRotationY.push_back(quantizeComponent(frame.rotation.y));
+                packedRotationZ.push_back(quantizeComponent(frame.rotation.z));
+                packedRotationW.push_back(quantizeComponent(frame.rotation.w));
+            } else {
+                rotationX.push_back(frame.rotation.x);
+                rotationY.push_back(frame.rotation.y);
+                rotationZ.push_back(frame.rotation.z);
+                rotationW.push_back(frame.rotation.w);
+            }
+            if (translated) {
+                positionX.push_back(frame.position.x);
+                positionY.push_back(frame.position.y);
+                positionZ.push_back(frame.position.z);
+            }
+        }
+    }
+    first.push_back(static_cast<uint32_t>(times.size()));
+}
+
+uint32_t AnimationTracks::find(const std::string &name) const {
+    const auto it = std::lower_bound(names.begin(), names.end(), name);
+    if (it == names.end() || *it != name) {
+        return static_cast<uint32_t>(size());
+    }
+    return static_cast<uint32_t>(it - names.begin());
+}
+
+uint32_t AnimationTracks::findNextKey(uint32_t track, float time,
+                                      uint32_t *cursor) const {
+    auto lo = first[track];
+    auto hi = first[track + 1];
+
+    if (cursor && *cursor >= lo && *cursor <= hi) {
+        auto key = *cursor;
+        if (key > lo && times[key - 1] >= time) {
+            // Seeking backwards, the key is before the cursor
+            hi = key - 1;
+        } else {
+            // Playing forwards only moves a key or two each sample
+            const auto limit = std::min(hi, key + kCursorSteps);
+            while (key < limit && times[key] < time) {
+                ++key;
+            }
+            if (key < limit || key == hi) {
+                *cursor = key;
+                return key;
+            }
+            lo = key;
+        }
+    }
+
+    const auto next = std::lower_bound(times.begin() + lo,
+                                       times.begin() + hi, time);
+    const auto key = static_cast<uint32_t>(next - times.begin());
+    if (cursor) {
+        *cursor = key;
+    }
+    return key;
+}
+
+void AnimationTracks::sample(float time, const uint32_t *tracks,
+                             std::size_t count, glm::quat *rotations,
+                             glm::vec3 *translations,
+                             uint32_t *cursors) const {
+    // Keyframe indices either side of time and the blend between them
+    uint32_t key1[kBatchSize];
+    uint32_t key2[kBatchSize];
+    float alpha[kBatchSize];
+    // Index of key1's translation, key2's follows it
+    uint32_t translation[kBatchSize];
+    bool translated[kBatchSize];
+
+    float q1[4][kBatchSize], q2[4][kBatchSize];
+    float p1[3][kBatchSize], p2[3][kBatchSize];
+    float q[4][kBatchSize], p[3][kBatchSize];
+
+    for (std::size_t b = 0; b < count; b += kBatchSize) {
+        const auto lanes = std::min(kBatchSize, count - b);
+
+        for (std::size_t l = 0; l < kBatchSize; ++l) {
+            // Spare lanes repeat the first track, their results are ignored
+            const auto track = tracks[b + (l < lanes ? l : 0)];
+            const auto cursor =
+                cursors && l < lanes ? &cursors[b + l] : nullptr;
+            const auto begin = first[track];
+            const auto end = first[track + 1];
+
+            // Matches findKeyframes, the first key at or after time
+            const auto next = findNextKey(track, time, cursor);
+            if (next == end || next == begin) {
+                const auto k = next == end ? end - 1 : begin;
+                key1[l] = key2[l] = k;
+                alpha[l] = 1.f;
+            } else {
+                key2[l] = next;
+                key1[l] = next - 1;
+                const float tdiff = times[key2[l]] - times[key1[l]];
+                alpha[l] = tdiff == 0.f
+                               ? 1.f
+                               : glm::clamp((time - times[key1[l]]) / tdiff,
+                                            0.f, 1.f);
+            }
+
+            translated[l] = translationFirst[track] != kNoTranslation;
+            translation[l] =
+                translated[l] ? translationFirst[track] + (key1[l] - begin)
+                              : 0;
+        }
+
+        if (quantized) {
+            constexpr float kScale = 1.f / kQuantizeScale;
+            for (std::size_t l = 0; l < kBatchSize; ++l) {
+                q1[0][l] = packedRotationX[key1[l]] * kScale;
+                q1[1][l] = packedRotationY[key1[l]] * kScale;
+                q1[2][l] = packedRotationZ[key1[l]] * kScale;
+                q1[3][l] = packedRotationW[key1[l]] * kScale;
+                q2[0][l] = packedRotationX[key2[l]] * kScale;
+                q2[1][l] = packedRotationY[key2[l]] * kScale;
+                q2[2][l] = packedRotationZ[key2[l]] * kScale;
+                q2[3][l] = packedRotationW[key2[l]] * kScale;
+            }
+        } else {
+            for (std::size_t l = 0; l < kBatchSize; ++l) {
+                q1[0][l] = rotationX[key1[l]];
+                q1[1][l] = rotationY[key1[l]];
+                q1[2][l] = rotationZ[key1[l]];
+                q1[3][l] = rotationW[key1[l]];
+                q2[0][l] = rotationX[key2[l]];
+                q2[1][l] = rotationY[key2[l]];
+                q2[2][l] = rotationZ[key2[l]];
+                q2[3][l] = rotationW[key2[l]];
+            }
+        }
+
+        for (std::size_t l = 0; l < kBatchSize; ++l) {
+            if (!translated[l]) {
+                for (int c = 0; c < 3; ++c) {
+                    p1[c][l] = p2[c][l] = 0.f;
+                }
+                continue;
+            }
+            const auto t1 = translation[l];
+            const auto t2 = t1 + (key2[l] - key1[l]);
+            p1[0][l] = positionX[t1];
+            p1[1][l] = positionY[t1];
+            p1[2][l] = positionZ[t1];
+            p2[0][l] = positionX[t2];
+            p2[1][l] = positionY[t2];
+            p2[2][l] = positionZ[t2];
+        }
+
+        // Branch free so that all lanes are interpolated together
+        for (std::size_t l = 0; l < kBatchSize; ++l) {
+            const float dot = q1[0][l] * q2[0][l] + q1[1][l] * q2[1][l] +
+                              q1[2][l] * q2[2][l] + q1[3][l] * q2[3][l];
+            // Take the shortest path, as glm::slerp does
+            const float w1 = 1.f - alpha[l];
+            const float w2 = dot < 0.f ? -alpha[l] : alpha[l];
+
+            float length = 0.f;
+            for (int c = 0; c < 4; ++c) {
+                q[c][l] = q1[c][l] * w1 + q2[c][l] * w2;
+                length += q[c][l] * q[c][l];
+            }
+            const float scale = 1.f / std::sqrt(length);
+            for (int c = 0; c < 4; ++c) {
+                q[c][l] *= scale;
+            }
+
+            for (int c = 0; c < 3; ++c) {
+                p[c][l] = p1[c][l] * w1 + p2[c][l] * alpha[l];
+            }
+        }
+
+        for (std::size_t l = 0; l < lanes; ++l) {
+            rotations[b + l] = glm::quat(q[3][l], q[0][l], q[1][l], q[2][l]);
+            translations[b + l] = glm::vec3(p[0][l], p[1][l], p[2][l]);
+        }
+    }
 }
 
-bool LoaderIFP::loadFromMemory(char* data) {
+std::size_t AnimationTracks::getMemoryUsage() const {
+    std::size_t bytes = vectorBytes(first) + vectorBytes(translationFirst) +
+                        vectorBytes(times);
+    for (auto v : {&rotationX, &rotationY, &rotationZ, &rotationW, &positionX,
+                   &positionY, &positionZ}) {
+        bytes += vectorBytes(*v);
+    }
+    for (auto v : {&packedRotationX, &packedRotationY, &packedRotationZ,
+                   &packedRotationW}) {
+        bytes += vectorBytes(*v);
+    }
+    return bytes;
+}
+
+void Animation::packTracks() {
+    std::call_once(tracksBuilt, [this] { tracks.build(bones, true); });
+    for (auto &[name, bone] : bones) {
+        bone.frames.clear();
+        bone.frames.shrink_to_fit();
+    }
+}
+
+std::size_t Animation::getMemoryUsage() const {
+    std::size_t bytes = tracks.getMemoryUsage();
+    for (const auto &[name, bone] : bones) {
+        bytes += vectorBytes(bone.frames);
+    }
+    return bytes;
+}
+
+bool LoaderIFP::loadFromMemory(const char* data, bool packTracks) {
     size_t data_offs = 0;
     size_t* dataI = &data_offs;
 
-    ANPK* fileRoot = read<ANPK>(data, dataI);
+    const ANPK* fileRoot = read<ANPK>(data, dataI);
     std::string listname = readString(data, dataI);
 
     animations.reserve(fileRoot->info.entries);
@@ -77,15 +371,15 @@ bool LoaderIFP::loadFromMemory(char* data) {
         animation->name = animname;
 
         size_t animstart = data_offs + 8;
-        DGAN* animroot = read<DGAN>(data, dataI);
+        const DGAN* animroot = read<DGAN>(data, dataI);
         std::string infoname = readString(data, dataI);
 
         animation->bones.reserve(animroot->info.entries);
 
         for (auto c = 0u; c < animroot->info.entries; ++c) {
             size_t start = data_offs;
-            CPAN* cpan = read<CPAN>(data, dataI);
-            ANIM* frames = read<ANIM>(data, dataI);
+            const CPAN* cpan = read<CPAN>(data, dataI);
+            const ANIM* frames = read<ANIM>(data, dataI);
 
             AnimationBone boneData{};
             boneData.name = frames->name;
@@ -93,7 +387,7 @@ bool LoaderIFP::loadFromMemory(char* data) {
 
             data_offs += ((8 + frames->base.size) - sizeof(ANIM));
 
-            KFRM* frame = read<KFRM>(data, dataI);
+            const KFRM* frame = read<KFRM>(data, dataI);
             std::string type(frame->base.magic, 4);
 
             float time = 0.f;
@@ -142,6 +436,10 @@ bool LoaderIFP::loadFromMemory(char* data) {
 
         data_offs = animstart + animroot->base.size;
 
+        if (packTracks) {
+            animation->packTracks();
+        }
+
         std::transform(animname.begin(), animname.end(), animname.begin(),
                        ::tolower);
         animations.emplace(animname, animation);
@@ -150,7 +448,7 @@ bool LoaderIFP::loadFromMemory(char* data) {
     return true;
 }
 
-std::string LoaderIFP::readString(char* data, size_t* ofs) {
+std::string LoaderIFP::readString(const char* data, size_t* ofs) {
     size_t b = *ofs;
     for (size_t o = *ofs; (o = *ofs);) {
         *ofs += 4;
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -60,6 +61,87 @@ struct AnimationBone {
     AnimationKeyframe getKeyframe(float time);
 };
 
+/**
+ * @brief The keyframes of every bone in an Animation, stored by component
+ *
+ * Each bone is a track, identified by its index. Keeping the components in
+ * separate arrays lets sample() interpolate a batch of tracks with one loop
+ * that the compiler can vectorise.
+ *
+ * Quantized tracks store each rotation component in 16 bits. Translations
+ * are only stored for tracks of bones that have them.
+ */
+struct AnimationTracks {
+    /// Tracks interpolated by each iteration of sample()
+    static constexpr std::size_t kBatchSize = 8;
+    /// Marks tracks without translations in translationFirst
+    static constexpr uint32_t kNoTranslation = UINT32_MAX;
+    /// Keys a cursor steps over before sample() searches instead
+    static constexpr uint32_t kCursorSteps = 4;
+
+    /// Bone name of each track, sorted
+    std::vector<std::string> names;
+    /// The keyframes of track t are [first[t], first[t + 1])
+    std::vector<uint32_t> first;
+
+    std::vector<float> times;
+    /// Rotation components, empty when quantized
+    std::vector<float> rotationX;
+    std::vector<float> rotationY;
+    std::vector<float> rotationZ;
+    std::vector<float> rotationW;
+    /// Quantized rotation components, scaled to the range of int16_t
+    std::vector<int16_t> packedRotationX;
+    std::vector<int16_t> packedRotationY;
+    std::vector<int16_t> packedRotationZ;
+    std::vector<int16_t> packedRotationW;
+    /// Index of each track's first translation, or kNoTranslation
+    std::vector<uint32_t> translationFirst;
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> positionZ;
+
+    bool quantized = false;
+
+    void build(const std::unordered_map<std::string, AnimationBone>& bones,
+               bool quantize = false);
+
+    std::size_t size() const {
+        return names.size();
+    }
+
+    /**
+     * @return the track of the named bone, or size() if there is none
+     */
+    uint32_t find(const std::string& name) const;
+
+    /**
+     * Interpolates count tracks at time, the same way as
+     * AnimationBone::getInterpolatedKeyframe but using nlerp for rotations
+     *
+     * @param tracks indices of the tracks to sample
+     * @param rotations receives the rotation of each track
+     * @param translations receives the translation of each track
+     * @param cursors optional keyframe of each track found by the previous
+     * sample, so that playback only has to step forward a key or two
+     */
+    void sample(float time, const uint32_t* tracks, std::size_t count,
+                glm::quat* rotations, glm::vec3* translations,
+                uint32_t* cursors = nullptr) const;
+
+    /**
+     * @return the number of bytes used by the keyframes
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+    /**
+     * @return the first key of track at or after time, starting from the
+     * cursor when there is one
+     */
+    uint32_t findNextKey(uint32_t track, float time, uint32_t* cursor) const;
+};
+
 /**
  * @brief Animation data object, stores bones.
  *
@@ -72,21 +154,46 @@ struct Animation {
     ~Animation() = default;
 
     float duration;
+
+    /**
+     * @return the bones as tracks, built on first use so bones must not be
+     * changed after that
+     */
+    const AnimationTracks& getTracks() {
+        std::call_once(tracksBuilt, [this] { tracks.build(bones); });
+        return tracks;
+    }
+
+    /**
+     * Builds quantized tracks and frees the keyframes of the bones, after
+     * which the animation can only be sampled through getTracks()
+     */
+    void packTracks();
+
+    /**
+     * @return the number of bytes used by the keyframes of the bones and
+     * the tracks
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+    AnimationTracks tracks;
+    std::once_flag tracksBuilt;
 };
 
 class LoaderIFP {
     template <class T>
-    T* read(char* data, size_t* ofs) {
+    const T* read(const char* data, size_t* ofs) {
         size_t b = *ofs;
         *ofs += sizeof(T);
-        return reinterpret_cast<T*>(data + b);
+        return reinterpret_cast<const T*>(data + b);
     }
     template <class T>
-    T* peek(char* data, const size_t* ofs) {
-        return reinterpret_cast<T*>(data + *ofs);
+    const T* peek(const char* data, const size_t* ofs) {
+        return reinterpret_cast<const T*>(data + *ofs);
     }
 
-    std::string readString(char* data, size_t* ofs);
+    std::string readString(const char* data, size_t* ofs);
 
 public:
     struct BASE {
@@ -138,7 +245,11 @@ public:
 
     AnimationSet animations;
 
-    bool loadFromMemory(char* data);
+    /**
+     * @param packTracks quantize the keyframes of each animation with
+     * Animation::packTracks()
+     */
+    bool loadFromMemory(const char* data, bool packTracks = false);
 };
 
 #endif
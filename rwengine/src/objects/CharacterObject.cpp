@@ -243,9 +243,15 @@ glm::vec3 CharacterObject::updateMovementAnimation(float dt) {
     if (movementAnimation != animations->animation(AnimCycle::Idle) &&
         !modelroot->getChildren().empty()) {
         const auto& root = modelroot->getChildren()[0];
-        auto it = movementAnimation->bones.find(root->getName());
-        if (it != movementAnimation->bones.end()) {
-            auto& rootBone = it->second;
+        const auto& tracks = movementAnimation->getTracks();
+        const auto track = tracks.find(root->getName());
+        if (track < tracks.size()) {
+            auto rootPosition = [&](float time) {
+                glm::quat rotation;
+                glm::vec3 position;
+                tracks.sample(time, &track, 1, &rotation, &position);
+                return position;
+            };
             float step = dt;
             RW_CHECK(
                 animator->getAnimation(AnimIndexMovement),
@@ -258,26 +264,22 @@ glm::vec3 CharacterObject::updateMovementAnimation(float dt) {
             // Handle any remaining transformation before the end of the
             // keyframes
             if ((animTime + step) > duration) {
-                glm::vec3 a =
-                    rootBone.getInterpolatedKeyframe(animTime).position;
-                glm::vec3 b =
-                    rootBone.getInterpolatedKeyframe(duration).position;
+                glm::vec3 a = rootPosition(animTime);
+                glm::vec3 b = rootPosition(duration);
                 glm::vec3 d = (b - a);
                 animTranslate.y += d.y;
                 step -= (duration - animTime);
                 animTime = 0.f;
             }
 
-            glm::vec3 a = rootBone.getInterpolatedKeyframe(animTime).position;
-            glm::vec3 b =
-                rootBone.getInterpolatedKeyframe(animTime + step).position;
+            glm::vec3 a = rootPosition(animTime);
+            glm::vec3 b = rootPosition(animTime + step);
             glm::vec3 d = (b - a);
             animTranslate.y += d.y;
 
-            // Kludge: Drop y component of root bone
-            auto t = glm::vec3(root->getTransform()[3]);
-            t.y = 0.f;
-            root->setTranslation(t);
+            // The motion is applied to the character, so it's dropped from
+            // the root bone when the pose is sampled
+            dropRootMotion = true;
         }
     }
 
@@ -285,6 +287,8 @@ glm::vec3 CharacterObject::updateMovementAnimation(float dt) {
 }
 
 void CharacterObject::tick(float dt) {
+    dropRootMotion = false;
+
     if (controller) {
         controller->update(dt);
 
@@ -294,7 +298,7 @@ void CharacterObject::tick(float dt) {
         }
     }
 
-    animator->tick(dt);
+    animator->advance(dt);
     updateCharacter(dt);
 
     // Ensure the character doesn't need to be reset
@@ -303,6 +307,22 @@ void CharacterObject::tick(float dt) {
     }
 }
 
+void CharacterObject::updatePose() {
+    if (animator) {
+        animator->sample();
+    }
+
+    if (dropRootMotion) {
+        // Kludge: Drop y component of root bone
+        const auto& root = getClump()->getFrame()->getChildren()[0];
+        auto t = glm::vec3(root->getTransform()[3]);
+        t.y = 0.f;
+        root->setTranslation(t);
+    }
+
+    updateFrameTransforms();
+}
+
 void CharacterObject::tickPhysics(float dt) {
     if (physCharacter) {
         auto s = currenteMovementStep * dt;
@@ -381,7 +401,7 @@ void CharacterObject::updateCharacter(float dt) {
 
         auto Pos =
             physCharacter->getGhostObject()->getWorldTransform().getOrigin();
-        position = glm::vec3(Pos.x(), Pos.y(), Pos.z());
+        updatePosition(glm::vec3(Pos.x(), Pos.y(), Pos.z()));
         getClump()->getFrame()->setTranslation(position);
 
         // Handle above waist height water.
@@ -436,7 +456,7 @@ void CharacterObject::setPosition(const glm::vec3& pos) {
         btVector3 bpos(realPos.x, realPos.y, realPos.z);
         physCharacter->warp(bpos);
     }
-    position = realPos;
+    updatePosition(realPos);
     getClump()->getFrame()->setTranslation(pos);
 }
 
@@ -75,6 +75,8 @@ private:
 
     glm::vec3 updateMovementAnimation(float dt);
     glm::vec3 currenteMovementStep{};
+    /// Set when the movement animation moves the character this tick
+    bool dropRootMotion = false;
 
     AnimCycle cycle_ = AnimCycle::Idle;
 
@@ -107,6 +109,8 @@ public:
 
     void tick(float dt) override;
 
+    void updatePose() override;
+
     void tickPhysics(float dt);
 
     const CharacterState& getCurrentState() const {
@@ -19,7 +19,7 @@ CutsceneObject::CutsceneObject(GameWorld *engine, const glm::vec3 &pos,
 }
 
 void CutsceneObject::tick(float dt) {
-    animator->tick(dt);
+    animator->advance(dt);
 }
 
 void CutsceneObject::setParentActor(GameObject *parent, ModelFrame *bone) {
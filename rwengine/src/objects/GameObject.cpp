@@ -7,18 +7,37 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "engine/Animator.hpp"
+#include "engine/SpatialGrid.hpp"
 
 const AtomicPtr GameObject::NullAtomic;
 const ClumpPtr GameObject::NullClump;
 
 GameObject::~GameObject() {
+    if (grid_) {
+        grid_->remove(this);
+    }
     if (modelinfo_) {
         modelinfo_->removeReference();
     }
 }
 
 void GameObject::setPosition(const glm::vec3& pos) {
+    updatePosition(pos);
+}
+
+void GameObject::updatePosition(const glm::vec3& pos) {
     position = pos;
+    if (grid_) {
+        grid_->update(this);
+    }
+}
+
+void GameObject::setModel(const ClumpPtr& model) {
+    model_ = model;
+    // Queries have to reach further for a bigger model
+    if (grid_) {
+        grid_->updateRadius(this);
+    }
 }
 
 void GameObject::setRotation(const glm::quat& orientation) {
@@ -37,7 +56,7 @@ void GameObject::setHeading(float heading) {
 }
 
 void GameObject::updateTransform(const glm::vec3& pos, const glm::quat& rot) {
-    position = pos;
+    updatePosition(pos);
     rotation = rot;
 
     const auto& clump = getClump();
@@ -51,3 +70,19 @@ void GameObject::updateTransform(const glm::vec3& pos, const glm::quat& rot) {
         atomic->getFrame()->setTranslation(pos);
     }
 }
+
+void GameObject::updatePose() {
+    if (animator) {
+        animator->sample();
+    }
+    updateFrameTransforms();
+}
+
+void GameObject::updateFrameTransforms() const {
+    if (const auto& clump = getClump()) {
+        clump->updateTransforms();
+    }
+    if (const auto& atomic = getAtomic()) {
+        atomic->getFrame()->updateWorldTransform();
+    }
+}
@@ -1,6 +1,8 @@
 #ifndef _RWENGINE_GAMEOBJECT_HPP_
 #define _RWENGINE_GAMEOBJECT_HPP_
 
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <variant>
 
@@ -15,6 +17,7 @@
 #include <objects/ObjectTypes.hpp>
 
 class GameWorld;
+class SpatialGrid;
 
 /**
  * @brief Base data and interface for all world "objects" like vehicles, peds.
@@ -24,6 +27,8 @@ class GameWorld;
  */
 class GameObject {
     GameObjectID objectID = 0;
+    std::size_t worldIndex = std::numeric_limits<std::size_t>::max();
+    std::size_t missionIndex = std::numeric_limits<std::size_t>::max();
 
     BaseModelInfo* modelinfo_;
 
@@ -33,11 +38,21 @@ class GameObject {
     static const AtomicPtr NullAtomic;
     static const ClumpPtr NullClump;
 
+    friend class SpatialGrid;
+    /// The grid containing this object, and the cell it was last placed in
+    SpatialGrid* grid_ = nullptr;
+    uint64_t gridCell_ = 0;
+
 protected:
     void changeModelInfo(BaseModelInfo* next) {
         modelinfo_ = next;
     }
 
+    /**
+     * Sets position, moving the object between cells of its SpatialGrid
+     */
+    void updatePosition(const glm::vec3& pos);
+
 public:
     glm::vec3 position;
     glm::quat rotation;
@@ -78,6 +93,27 @@ public:
         objectID = id;
     }
 
+    std::size_t getWorldIndex() const {
+        return worldIndex;
+    }
+    /**
+     * Do not call this, GameWorld uses it to find the object in allObjects
+     */
+    void setWorldIndex(std::size_t index) {
+        worldIndex = index;
+    }
+
+    std::size_t getMissionIndex() const {
+        return missionIndex;
+    }
+    /**
+     * Do not call this, GameState uses it to find the object in
+     * missionObjects
+     */
+    void setMissionIndex(std::size_t index) {
+        missionIndex = index;
+    }
+
     int getScriptObjectID() const {
         return getGameObjectID();
     }
@@ -111,9 +147,7 @@ public:
         model_ = model;
     }
 
-    void setModel(const ClumpPtr& model) {
-        model_ = model;
-    }
+    void setModel(const ClumpPtr& model);
 
     /**
      * @brief Enumeration of possible object types.
@@ -219,6 +253,15 @@ public:
 
     virtual void tick(float dt) = 0;
 
+    /**
+     * Samples the object's animation and resolves its frame transforms, once
+     * tick() has been called for every object.
+     *
+     * Objects are updated in parallel, so this must only change the object's
+     * own model and not the world, physics or other objects.
+     */
+    virtual void updatePose();
+
     enum ObjectLifetime {
         /// lifetime has not been set
         UnknownLifetime,
@@ -251,6 +294,12 @@ public:
 
     void updateTransform(const glm::vec3& pos, const glm::quat& rot);
 
+    /**
+     * Resolves the world transforms of the model's frames, after which they
+     * can be read from other threads until the object is changed again
+     */
+    void updateFrameTransforms() const;
+
 private:
     ObjectLifetime lifetime = GameObject::UnknownLifetime;
 };
@@ -19,6 +19,7 @@
 #include "engine/Animator.hpp"
 #include "engine/GameData.hpp"
 #include "engine/GameWorld.hpp"
+#include "engine/StaticInstanceGrid.hpp"
 
 InstanceObject::InstanceObject(GameWorld* engine, const glm::vec3& pos,
                                const glm::quat& rot, const glm::vec3& scale,
@@ -62,7 +63,12 @@ InstanceObject::InstanceObject(GameWorld* engine, const glm::vec3& pos,
     }
 }
 
-InstanceObject::~InstanceObject() = default;
+InstanceObject::~InstanceObject() {
+    if (cellGrid_) {
+        cellGrid_->remove(this);
+    }
+    sleep();
+}
 
 void InstanceObject::tick(float dt) {
     RW_UNUSED(dt);
@@ -70,7 +76,55 @@ void InstanceObject::tick(float dt) {
 }
 
 void InstanceObject::tickPhysics(float dt) {
-    if (animator) animator->tick(dt);
+    updatePhysics(dt);
+
+    if (!needsPhysicsTick()) {
+        sleep();
+    }
+}
+
+void InstanceObject::wake() {
+    if (isAwake()) {
+        return;
+    }
+    auto& active = engine->activeInstances;
+    activeSlot_ = static_cast<uint32_t>(active.size());
+    active.push_back(this);
+}
+
+void InstanceObject::sleep() {
+    if (!isAwake()) {
+        return;
+    }
+    auto& active = engine->activeInstances;
+    active[activeSlot_] = active.back();
+    active[activeSlot_]->activeSlot_ = activeSlot_;
+    active.pop_back();
+    activeSlot_ = kAsleep;
+}
+
+bool InstanceObject::needsPhysicsTick() const {
+    if (animator || floating) {
+        return true;
+    }
+    if (!body || !dynamics) {
+        return false;
+    }
+    if (changeAtomic != -1) {
+        return true;
+    }
+
+    const auto bulletBody = body->getBulletBody();
+    // Uprooted, but not given its mass yet
+    if (usePhysics && dynamics->mass > 0.f && bulletBody->getInvMass() == 0.f) {
+        return true;
+    }
+    // Until Bullet deactivates it
+    return bulletBody->isActive();
+}
+
+void InstanceObject::updatePhysics(float dt) {
+    if (animator) animator->advance(dt);
 
     if (!body || !dynamics) {
         return;
@@ -83,32 +137,20 @@ void InstanceObject::tickPhysics(float dt) {
         changeAtomic = -1;
     }
 
-    if (usePhysics) {
+    // Re-adding the body is costly, so it's only done when the object is
+    // uprooted or its body has been replaced
+    if (usePhysics && dynamics->mass > 0.f &&
+        body->getBulletBody()->getInvMass() == 0.f) {
         body->changeMass(dynamics->mass);
+        body->getBulletBody()->activate(true);
     }
 
     // Only certain objects should float on water
     if (floating) {
         const glm::vec3& ws = getPosition();
-        auto wX = static_cast<int>((ws.x + WATER_WORLD_SIZE / 2.f) /
-                        (WATER_WORLD_SIZE / WATER_HQ_DATA_SIZE));
-        auto wY = static_cast<int>((ws.y + WATER_WORLD_SIZE / 2.f) /
-                        (WATER_WORLD_SIZE / WATER_HQ_DATA_SIZE));
         float vH = ws.z;  // - _collisionHeight/2.f;
-        float wH = 0.f;
-
-        if (wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 &&
-            wY < WATER_HQ_DATA_SIZE) {
-            int i = (wX * WATER_HQ_DATA_SIZE) + wY;
-            int hI = engine->data->realWater[i];
-            if (hI < NO_WATER_INDEX) {
-                wH = engine->data->waterHeights[hI];
-                wH += engine->data->getWaveHeightAt(ws);
-                inWater = vH <= wH;
-            } else {
-                inWater = false;
-            }
-        }
+        float wH = engine->data->getWaterHeightAt(ws);
+        inWater = vH <= wH;
         _lastHeight = ws.z;
 
         if (inWater) {
@@ -118,29 +160,20 @@ void InstanceObject::tickPhysics(float dt) {
             // Damper motion
             body->getBulletBody()->setDamping(0.95f, 0.9f);
 
-            auto wi = engine->data->getWaterIndexAt(ws);
-            if (wi != NO_WATER_INDEX) {
-                float h = engine->data->waterHeights[wi] + oZ;
-
-                // Calculate wave height
-                h += engine->data->getWaveHeightAt(ws);
-
-                if (ws.z <= h) {
-                    float x = (h - ws.z);
-                    float F =
-                        WATER_BUOYANCY_K * x +
-                        -WATER_BUOYANCY_C *
-                            body->getBulletBody()->getLinearVelocity().z();
-                    btVector3 forcePos = btVector3(0.f, 0.f, 2.f)
-                                             .rotate(body->getBulletBody()
-                                                         ->getOrientation()
-                                                         .getAxis(),
-                                                     body->getBulletBody()
-                                                         ->getOrientation()
-                                                         .getAngle());
-                    body->getBulletBody()->applyImpulse(btVector3(0.f, 0.f, F),
-                                                        forcePos);
-                }
+            float h = wH + oZ;
+
+            if (ws.z <= h) {
+                float x = (h - ws.z);
+                float F = WATER_BUOYANCY_K * x +
+                          -WATER_BUOYANCY_C *
+                              body->getBulletBody()->getLinearVelocity().z();
+                btVector3 forcePos =
+                    btVector3(0.f, 0.f, 2.f)
+                        .rotate(
+                            body->getBulletBody()->getOrientation().getAxis(),
+                            body->getBulletBody()->getOrientation().getAngle());
+                body->getBulletBody()->applyImpulse(btVector3(0.f, 0.f, F),
+                                                    forcePos);
             }
         }
     }
@@ -169,6 +202,10 @@ void InstanceObject::changeModel(BaseModelInfo* incoming, int atomicNumber) {
             atomic_ = atomic->clone(frame);
         }
 
+        if (cellGrid_) {
+            cellGrid_->invalidate(this);
+        }
+
         if (collision) {
             body = std::make_unique<CollisionInstance>();
             body->createPhysicsBody(this, collision, dynamics);
@@ -184,6 +221,9 @@ void InstanceObject::setPosition(const glm::vec3& pos) {
     if (atomic_) {
         atomic_->getFrame()->setTranslation(pos);
     }
+    if (cellGrid_) {
+        cellGrid_->invalidate(this);
+    }
     GameObject::setPosition(pos);
 }
 
@@ -198,6 +238,13 @@ void InstanceObject::setRotation(const glm::quat& r) {
     GameObject::setRotation(r);
 }
 
+void InstanceObject::setVisible(bool v) {
+    if (visible != v && cellGrid_) {
+        cellGrid_->invalidate(this);
+    }
+    visible = v;
+}
+
 void InstanceObject::setStatic(bool s) {
     int flags = body->getBulletBody()->getCollisionFlags();
 
@@ -209,6 +256,11 @@ void InstanceObject::setStatic(bool s) {
 
     body->getBulletBody()->setCollisionFlags(flags);
     static_ = s;
+
+    // Objects put back in the moving list can be pushed around again
+    if (!s) {
+        wake();
+    }
 }
 
 bool InstanceObject::takeDamage(const GameObject::DamageInfo& dmg) {
@@ -224,6 +276,7 @@ bool InstanceObject::takeDamage(const GameObject::DamageInfo& dmg) {
                 usePhysics = true;
             }
         }
+        wake();
 
         switch (effect) {
             case DynamicObjectData::Damage_ChangeModel:
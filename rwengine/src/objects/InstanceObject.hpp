@@ -5,11 +5,13 @@
 
 #include <rw/forward.hpp>
 
+#include <cstdint>
 #include <memory>
 
 class BaseModelInfo;
 class CollisionInstance;
 class GameWorld;
+class StaticInstanceGrid;
 
 /**
  * @struct InstanceObject
@@ -28,6 +30,25 @@ class InstanceObject final : public GameObject {
      */
     AtomicPtr atomic_;
 
+    friend class StaticInstanceGrid;
+    /// The grid containing this instance, its cell and place in the cell
+    StaticInstanceGrid* cellGrid_ = nullptr;
+    uint32_t cell_ = 0;
+    uint32_t cellSlot_ = 0;
+
+    static constexpr uint32_t kAsleep = UINT32_MAX;
+    /// Place in the world's activeInstances, or kAsleep
+    uint32_t activeSlot_ = kAsleep;
+
+    void updatePhysics(float dt);
+
+    /**
+     * @return true while the instance has to be given a physics tick
+     */
+    bool needsPhysicsTick() const;
+
+    void sleep();
+
 public:
     glm::vec3 scale;
     std::unique_ptr<CollisionInstance> body;
@@ -49,8 +70,22 @@ public:
 
     void tick(float dt) override;
 
+    /**
+     * Updates the instance for a physics tick, and takes it out of the
+     * world's active set once it has nothing left to do
+     */
     void tickPhysics(float dt);
 
+    /**
+     * Puts the instance in the world's active set after it has been
+     * disturbed, so that it is given physics ticks until it's idle again
+     */
+    void wake();
+
+    bool isAwake() const {
+        return activeSlot_ != kAsleep;
+    }
+
     void changeModel(BaseModelInfo* incoming, int atomicNumber = 0);
 
     void setPosition(const glm::vec3& pos) override;
@@ -67,16 +102,25 @@ public:
         return static_;
     }
 
-    void setVisible(bool v) {
-        visible = v;
+    /**
+     * @return true if the renderer finds this instance through the world's
+     * StaticInstanceGrid
+     */
+    bool isInCellGrid() const {
+        return cellGrid_ != nullptr;
     }
 
+    void setVisible(bool v);
+
     bool isVisible() const {
         return visible;
     }
 
     void setFloating(bool f) {
         floating = f;
+        if (floating) {
+            wake();
+        }
     }
 
     bool isFloating() const {
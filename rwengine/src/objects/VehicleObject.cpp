@@ -1,6 +1,7 @@
 #include "objects/VehicleObject.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>
 #include <limits>
@@ -323,7 +324,55 @@ void VehicleObject::tick(float dt) {
     // Moved to tickPhysics
 }
 
+bool VehicleObject::getWaterPoints(glm::vec3* points) const {
+    const auto& ws = getPosition();
+    if (!physVehicle || !engine->data->hasWaterAt(ws)) {
+        return false;
+    }
+
+    const auto floatPoints = getFloatPoints();
+    points[0] = ws;
+    for (auto i = 0u; i < floatPoints.size(); ++i) {
+        points[i + 1] = ws + floatPoints[i];
+    }
+    return true;
+}
+
+std::array<glm::vec3, 4> VehicleObject::getFloatPoints() const {
+    auto isBoat = getVehicle()->vehicletype_ == VehicleModelInfo::BOAT;
+
+    float bbZ = info->handling.dimensions.z / 2.f;
+
+    float oZ = -bbZ / 2.f + (bbZ * (info->handling.percentSubmerged / 120.f));
+
+    if (isBoat) {
+        oZ = 0.f;
+    }
+
+    // Boats, Buoyancy offset is affected by the orientation of the
+    // chassis.
+    // Vehicles, it isn't.
+    const auto& dimensions = info->handling.dimensions;
+    return {{getRotation() * glm::vec3(0.f, dimensions.y / 2.f, oZ),
+             getRotation() * glm::vec3(0.f, -dimensions.y / 2.f, oZ),
+             getRotation() * glm::vec3(dimensions.x / 2.f, 0.f, oZ),
+             getRotation() * glm::vec3(-dimensions.x / 2.f, 0.f, oZ)}};
+}
+
 void VehicleObject::tickPhysics(float dt) {
+    std::array<glm::vec3, kWaterPoints> points;
+    if (!getWaterPoints(points.data())) {
+        tickPhysics(dt, nullptr);
+        return;
+    }
+
+    std::array<float, kWaterPoints> waterHeights;
+    engine->data->getWaterHeightsAt(points.data(), points.size(),
+                                    waterHeights.data());
+    tickPhysics(dt, waterHeights.data());
+}
+
+void VehicleObject::tickPhysics(float dt, const float* waterHeights) {
     RW_UNUSED(dt);
 
     static constexpr float steeringWeight = 1.f/0.35f;
@@ -501,81 +550,43 @@ void VehicleObject::tickPhysics(float dt) {
             }
         }
 
-        const auto& ws = getPosition();
-        auto wX = static_cast<int>((ws.x + WATER_WORLD_SIZE / 2.f) /
-                        (WATER_WORLD_SIZE / WATER_HQ_DATA_SIZE));
-        auto wY = static_cast<int>((ws.y + WATER_WORLD_SIZE / 2.f) /
-                        (WATER_WORLD_SIZE / WATER_HQ_DATA_SIZE));
         btVector3 bbmin, bbmax;
         // This is in world space.
         collision->getBulletBody()->getAabb(bbmin, bbmax);
         float vH = bbmin.z();
-        float wH = 0.f;
-
-        if (wX >= 0 && wX < WATER_HQ_DATA_SIZE && wY >= 0 &&
-            wY < WATER_HQ_DATA_SIZE) {
-            int i = (wX * WATER_HQ_DATA_SIZE) + wY;
-            int hI = engine->data->realWater[i];
-            if (hI < NO_WATER_INDEX) {
-                wH = engine->data->waterHeights[hI];
-                wH += engine->data->getWaveHeightAt(ws);
-                // If the vehicle is currently underwater
-                if (vH <= wH) {
-                    // and was not underwater here in the last tick
-                    if (_lastHeight >= wH) {
-                        // we are for real, underwater
-                        inWater = true;
-                    }
-                } else {
-                    // The water is beneath us
-                    inWater = false;
-                }
-            } else {
-                inWater = false;
+
+        auto isBoat = getVehicle()->vehicletype_ == VehicleModelInfo::BOAT;
+
+        float wH = waterHeights ? waterHeights[0] : GameData::kNoWaterHeight;
+        // If the vehicle is currently underwater
+        if (vH <= wH) {
+            // and was not underwater here in the last tick
+            if (_lastHeight >= wH) {
+                // we are for real, underwater
+                inWater = true;
             }
+        } else {
+            // The water is beneath us, or there isn't any
+            inWater = false;
         }
 
-        auto isBoat = getVehicle()->vehicletype_ == VehicleModelInfo::BOAT;
         if (inWater) {
             // Ensure that vehicles don't fall asleep at the top of a wave.
             if (!collision->getBulletBody()->isActive()) {
                 collision->getBulletBody()->activate(true);
             }
 
-            float bbZ = info->handling.dimensions.z / 2.f;
-
-            float oZ =
-                -bbZ / 2.f + (bbZ * (info->handling.percentSubmerged / 120.f));
-
-            if (isBoat) {
-                oZ = 0.f;
-            } else {
+            if (!isBoat) {
                 // Damper motion
                 collision->getBulletBody()->setDamping(0.95f, 0.9f);
             }
 
-            // Boats, Buoyancy offset is affected by the orientation of the
-            // chassis.
-            // Vehicles, it isn't.
-            glm::vec3 vFwd =
-                          glm::vec3(0.f, info->handling.dimensions.y / 2.f, oZ),
-                      vBack = glm::vec3(0.f, -info->handling.dimensions.y / 2.f,
-                                        oZ);
-            glm::vec3 vRt =
-                          glm::vec3(info->handling.dimensions.x / 2.f, 0.f, oZ),
-                      vLeft = glm::vec3(-info->handling.dimensions.x / 2.f, 0.f,
-                                        oZ);
-
-            vFwd = getRotation() * vFwd;
-            vBack = getRotation() * vBack;
-            vRt = getRotation() * vRt;
-            vLeft = getRotation() * vLeft;
-
-            // This function will try to keep v* at the water level.
-            applyWaterFloat(vFwd);
-            applyWaterFloat(vBack);
-            applyWaterFloat(vRt);
-            applyWaterFloat(vLeft);
+            // This function will try to keep the float points at the water
+            // level.
+            const auto floatPoints = getFloatPoints();
+            for (auto i = 0u; i < floatPoints.size(); ++i) {
+                applyWaterFloat(floatPoints[i], waterHeights[i + 1]);
+            }
         } else {
             if (isBoat) {
                 collision->getBulletBody()->setDamping(0.1f, 0.8f);
@@ -796,23 +807,16 @@ void VehicleObject::setPartState(VehicleObject::Part* part,
     }
 }
 
-void VehicleObject::applyWaterFloat(const glm::vec3& relPt) {
+void VehicleObject::applyWaterFloat(const glm::vec3& relPt,
+                                    float waterHeight) {
     auto ws = getPosition() + relPt;
-    auto wi = engine->data->getWaterIndexAt(ws);
-    if (wi != NO_WATER_INDEX) {
-        float h = engine->data->waterHeights[wi];
-
-        // Calculate wave height
-        h += engine->data->getWaveHeightAt(ws);
-
-        if (ws.z <= h) {
-            float x = (h - ws.z);
-            float F = WATER_BUOYANCY_K * x +
-                      -WATER_BUOYANCY_C *
-                          collision->getBulletBody()->getLinearVelocity().z();
-            collision->getBulletBody()->applyImpulse(
-                btVector3(0.f, 0.f, F), btVector3(relPt.x, relPt.y, relPt.z));
-        }
+    if (ws.z <= waterHeight) {
+        float x = (waterHeight - ws.z);
+        float F = WATER_BUOYANCY_K * x +
+                  -WATER_BUOYANCY_C *
+                      collision->getBulletBody()->getLinearVelocity().z();
+        collision->getBulletBody()->applyImpulse(
+            btVector3(0.f, 0.f, F), btVector3(relPt.x, relPt.y, relPt.z));
     }
 }
 
@@ -1,6 +1,7 @@
 #ifndef _RWENGINE_VEHICLEOBJECT_HPP_
 #define _RWENGINE_VEHICLEOBJECT_HPP_
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -149,8 +150,25 @@ public:
 
     void tick(float dt) override;
 
+    /// The points tickPhysics() needs the water heights at
+    static constexpr std::size_t kWaterPoints = 5;
+
+    /**
+     * Fills points with the vehicle's position and its four float points,
+     * if there is water under the vehicle. Otherwise it can't float, and
+     * false is returned.
+     */
+    bool getWaterPoints(glm::vec3* points) const;
+
+    /// Looks up the water heights itself
     void tickPhysics(float dt);
 
+    /**
+     * @param waterHeights The water heights at the points from
+     * getWaterPoints(), or null if it returned false
+     */
+    void tickPhysics(float dt, const float* waterHeights);
+
     bool isFlipped() const;
 
     bool isUpright() const;
@@ -206,7 +224,14 @@ public:
 
     Part* getPart(const std::string& name);
 
-    void applyWaterFloat(const glm::vec3& relPt);
+    /**
+     * Pushes the point relPt, relative to the vehicle, up towards the water
+     * surface at waterHeight if it's below it
+     */
+    void applyWaterFloat(const glm::vec3& relPt, float waterHeight);
+
+    /// The float points relative to the vehicle: front, back, right, left
+    std::array<glm::vec3, 4> getFloatPoints() const;
 
     void setPrimaryColour(uint8_t color);
     void setSecondaryColour(uint8_t color);
@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <cstdint>
 #include <cmath>
+#include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <glm/gtc/constants.hpp>
@@ -12,8 +14,10 @@
 #include <glm/gtc/quaternion.hpp>
 
 #include <gl/TextureData.hpp>
+#include <rw/headless.hpp>
 #include <rw/types.hpp>
 
+#include "core/JobSystem.hpp"
 #include "core/Logger.hpp"
 #include "core/Profiler.hpp"
 #include "engine/GameData.hpp"
@@ -21,31 +25,22 @@
 #include "engine/GameWorld.hpp"
 #include "loaders/WeatherLoader.hpp"
 #include "objects/GameObject.hpp"
+#include "objects/InstanceObject.hpp"
 #include "render/ObjectRenderer.hpp"
 #include "render/GameShaders.hpp"
-#include "render/VisualFX.hpp"
 
 constexpr size_t skydomeSegments = 8, skydomeRows = 10;
 
-/// @todo collapse all of these into "VertPNC" etc.
-struct ParticleVert {
-    static const AttributeList vertex_attributes() {
-        return {{ATRS_Position, 2, sizeof(ParticleVert), 0ul},
-                {ATRS_TexCoord, 2, sizeof(ParticleVert), 2ul * sizeof(float)},
-                {ATRS_Colour, 3, sizeof(ParticleVert), 4ul * sizeof(float)}};
-    }
-
-    float x, y;
-    float u, v;
-    float r, g, b;
-};
-
-GameRenderer::GameRenderer(Logger* log, GameData* _data)
+GameRenderer::GameRenderer(Logger* log, GameData* _data,
+                           std::unique_ptr<Renderer> _renderer)
     : data(_data)
     , logger(log)
+    , renderer(std::move(_renderer))
     , map(*renderer, _data)
     , water(*this)
-    , text(*this) {
+    , particles(*this)
+    , text(*this)
+    , sprites(*this) {
     logger->info("Renderer", renderer->getIDString());
 
     worldProg =
@@ -53,17 +48,11 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
                                GameShaders::WorldObject::FragmentShader);
 
     renderer->setUniformTexture(worldProg.get(), "texture", 0);
+    renderer->setUniformTexture(worldProg.get(), "texArray",
+                                Renderer::kTextureArrayUnit);
     renderer->setProgramBlockBinding(worldProg.get(), "SceneData", 1);
     renderer->setProgramBlockBinding(worldProg.get(), "ObjectData", 2);
 
-    particleProg =
-        renderer->createShader(GameShaders::WorldObject::VertexShader,
-                               GameShaders::Particle::FragmentShader);
-
-    renderer->setUniformTexture(particleProg.get(), "texture", 0);
-    renderer->setProgramBlockBinding(particleProg.get(), "SceneData", 1);
-    renderer->setProgramBlockBinding(particleProg.get(), "ObjectData", 2);
-
     skyProg = renderer->createShader(GameShaders::Sky::VertexShader,
                                      GameShaders::Sky::FragmentShader);
 
@@ -73,37 +62,10 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
         renderer->createShader(GameShaders::DefaultPostProcess::VertexShader,
                                GameShaders::DefaultPostProcess::FragmentShader);
 
-    glGenVertexArrays(1, &vao);
-
-    glGenFramebuffers(1, &framebufferName);
-    glBindFramebuffer(GL_FRAMEBUFFER, framebufferName);
-    glGenTextures(2, fbTextures);
-
-    glBindTexture(GL_TEXTURE_2D, fbTextures[0]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 128, 128, 0, GL_RGBA,
-                 GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    glBindTexture(GL_TEXTURE_2D, fbTextures[1]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, 128, 128, 0, GL_RED, GL_FLOAT,
-                 nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                           fbTextures[0], 0);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D,
-                           fbTextures[1], 0);
-
-    // Give water renderer the data texture
-    water.setDataTexture(1, fbTextures[1]);
-
-    glGenRenderbuffers(1, fbRenderBuffers);
-    glBindRenderbuffer(GL_RENDERBUFFER, fbRenderBuffers[0]);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 128, 128);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
-                              GL_RENDERBUFFER, fbRenderBuffers[0]);
+    // Without a context the renderer only records what would be drawn
+    if (!isHeadless()) {
+        createFramebuffer();
+    }
 
     // Create the skydome
 
@@ -127,7 +89,6 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
     skyDbuff.addGeometry(&skyGbuff);
     skyDbuff.setFaceType(GL_TRIANGLES);
 
-    glGenBuffers(1, &skydomeIBO);
     std::vector<GLuint> skydomeIndBuff;
     skydomeIndBuff.resize(rows * segments * 6);
     for (size_t r = 0, i = 0; r < (rows - 1); ++r) {
@@ -140,36 +101,55 @@ GameRenderer::GameRenderer(Logger* log, GameData* _data)
             skydomeIndBuff[i++] = static_cast<GLuint>((r + 1) * segments + s);
         }
     }
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skydomeIBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 sizeof(GLuint) * skydomeIndBuff.size(), skydomeIndBuff.data(),
-                 GL_STATIC_DRAW);
-
-    glBindVertexArray(0);
-
-    particleGeom.uploadVertices<ParticleVert>(
-        {{0.5f, 0.5f, 1.f, 1.f, 1.f, 1.f, 1.f},
-         {-0.5f, 0.5f, 0.f, 1.f, 1.f, 1.f, 1.f},
-         {0.5f, -0.5f, 1.f, 0.f, 1.f, 1.f, 1.f},
-         {-0.5f, -0.5f, 0.f, 0.f, 1.f, 1.f, 1.f}});
-    particleDraw.addGeometry(&particleGeom);
-    particleDraw.setFaceType(GL_TRIANGLE_STRIP);
+    if (!isHeadless()) {
+        glGenBuffers(1, &skydomeIBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skydomeIBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                     sizeof(GLuint) * skydomeIndBuff.size(),
+                     skydomeIndBuff.data(), GL_STATIC_DRAW);
+
+        glBindVertexArray(0);
+    }
 
     ssRectGeom.uploadVertices<VertexP2>({{-1.f, -1.f}, {1.f, -1.f}, {-1.f, 1.f}, {1.f, 1.f}});
     ssRectDraw.addGeometry(&ssRectGeom);
     ssRectDraw.setFaceType(GL_TRIANGLE_STRIP);
-
-    ssRectProg =
-        renderer->createShader(GameShaders::ScreenSpaceRect::VertexShader,
-                               GameShaders::ScreenSpaceRect::FragmentShader);
-    renderer->setUniform(ssRectProg.get(), "texture", 0);
 }
 
 GameRenderer::~GameRenderer() {
-    glDeleteFramebuffers(1, &framebufferName);
+    if (framebufferName != 0) {
+        glDeleteFramebuffers(1, &framebufferName);
+    }
+}
+
+void GameRenderer::createFramebuffer() {
+    glGenVertexArrays(1, &vao);
+
+    glGenFramebuffers(1, &framebufferName);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebufferName);
+    glGenTextures(1, fbTextures);
+
+    glBindTexture(GL_TEXTURE_2D, fbTextures[0]);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 128, 128, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           fbTextures[0], 0);
+
+    glGenRenderbuffers(1, fbRenderBuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, fbRenderBuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 128, 128);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                              GL_RENDERBUFFER, fbRenderBuffers[0]);
 }
 
 void GameRenderer::setupRender() {
+    if (isHeadless()) {
+        return;
+    }
+
     // Set the viewport
     const glm::ivec2& vp = getRenderer().getViewport();
     glViewport(0, 0, vp.x, vp.y);
@@ -189,7 +169,9 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera& camera,
 
     setupRender();
 
-    glBindVertexArray(vao);
+    if (!isHeadless()) {
+        glBindVertexArray(vao);
+    }
 
     float tod = world->getHour() + world->getMinute() / 60.f;
 
@@ -237,15 +219,21 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera& camera,
 
     renderer->pushDebugGroup("Water");
 
-    water.render(*this, world);
+    water.render(*this, world, _camera);
 
     profWater = renderer->popDebugGroup();
 
+    world->staticInstances.updateBounds();
+    if (lodMeshes.update(world->staticInstances) > 0) {
+        renderer->invalidate();
+    }
     renderObjects(world);
 
     renderer->pushDebugGroup("Sky");
 
-    glBindVertexArray(vao);
+    if (!isHeadless()) {
+        glBindVertexArray(vao);
+    }
 
     Renderer::DrawParameters dp;
     dp.start = 0;
@@ -265,7 +253,9 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera& camera,
     renderEffects(world);
     profEffects = renderer->popDebugGroup();
 
-    glDisable(GL_DEPTH_TEST);
+    if (!isHeadless()) {
+        glDisable(GL_DEPTH_TEST);
+    }
 
     GLuint splashTexName = 0;
     const auto fc = world->state->fadeColour;
@@ -290,6 +280,7 @@ void GameRenderer::renderWorld(GameWorld* world, const ViewCamera& camera,
         renderLetterbox();
     }
 
+    flushScreenSpace();
     renderPostProcess();
 }
 
@@ -307,22 +298,164 @@ void GameRenderer::renderObjects(const GameWorld *world) {
     profObjects = renderer->popDebugGroup();
 }
 
+namespace {
+/// Earlier position in the array means earlier object's rendering
+/// Transparent objects should be sorted and rendered after opaque
+bool renderOrder(const Renderer::RenderInstruction &a,
+                 const Renderer::RenderInstruction &b) {
+    if (a.drawInfo.blendMode == BlendMode::BLEND_NONE && b.drawInfo.blendMode != BlendMode::BLEND_NONE)
+        return true;
+    if (a.drawInfo.blendMode != BlendMode::BLEND_NONE && b.drawInfo.blendMode == BlendMode::BLEND_NONE)
+        return false;
+    return (a.sortKey > b.sortKey);
+}
+}  // namespace
+
+void GameRenderer::gatherRenderObjects(const GameWorld *world,
+                                       RenderList &renderList) {
+    RW_PROFILE_SCOPE(__func__);
+    renderObjects_.clear();
+
+    ObjectRenderer objectRenderer(_renderWorld,
+                                  (cullOverride ? cullingCamera : _camera),
+                                  _renderAlpha);
+    objectRenderer.gatherVisibleInstances(world->staticInstances, &lodMeshes,
+                                          renderObjects_, renderList);
+    culled += objectRenderer.culled;
+    culledCells = objectRenderer.culledCells;
+    culledInstances = objectRenderer.culledInstances;
+    mergedCells = objectRenderer.mergedCells;
+
+    // Instances in the grid have been added above if their cell is visible
+    for (auto object : world->allObjects) {
+        if (object->type() == GameObject::Instance &&
+            static_cast<InstanceObject*>(object)->isInCellGrid()) {
+            continue;
+        }
+        renderObjects_.push_back(object);
+    }
+}
+
 RenderList GameRenderer::createObjectRenderList(const GameWorld *world) {
     RW_PROFILE_SCOPE(__func__);
-    // This is sequential at the moment, it should be easy to make it
-    // run in parallel with a good threading system.
+    if (jobs && parallelRenderList && jobs->getConcurrency() > 1) {
+        return createObjectRenderListParallel(world);
+    }
+
+    // Reference implementation for createObjectRenderListParallel
     RenderList renderList;
+    gatherRenderObjects(world, renderList);
     // Naive optimisation, assume 50% hitrate
-    renderList.reserve(static_cast<size_t>(world->allObjects.size() * 0.5f));
+    renderList.reserve(static_cast<size_t>(renderObjects_.size() * 0.5f));
 
     ObjectRenderer objectRenderer(_renderWorld,
                                   (cullOverride ? cullingCamera : _camera),
                                   _renderAlpha);
 
     // World Objects
-    for (auto object : world->allObjects) {
+    for (auto object : renderObjects_) {
         objectRenderer.buildRenderList(object, renderList);
     }
+    culled += objectRenderer.culled;
+
+    culled += buildSpecialRenderList(world, renderList);
+
+    RW_PROFILE_SCOPE("sortRenderList");
+    sort(renderList.begin(), renderList.end(), renderOrder);
+
+    return renderList;
+}
+
+RenderList GameRenderer::createObjectRenderListParallel(const GameWorld *world) {
+    const auto &objects = renderObjects_;
+    const auto &camera = cullOverride ? cullingCamera : _camera;
+
+    // One sorted chunk per job, plus one for the special models
+    const auto jobChunks = jobs->getConcurrency();
+    std::vector<RenderList> chunks(jobChunks + 1);
+    std::vector<size_t> chunkCulled(jobChunks, 0);
+
+    gatherRenderObjects(world, chunks.back());
+
+    // Frames may have been moved since the last tick, and resolving them
+    // lazily isn't safe once objects read each other's frames on the jobs
+    {
+        RW_PROFILE_SCOPE("updateFrameTransforms");
+        for (auto object : objects) {
+            object->updateFrameTransforms();
+        }
+    }
+
+    jobs->parallelFor(objects.size(), jobChunks,
+                      [&](size_t c, size_t begin, size_t end) {
+        RW_PROFILE_SCOPE("buildRenderListChunk");
+        auto &list = chunks[c];
+        // Naive optimisation, assume 50% hitrate
+        list.reserve((end - begin) / 2);
+
+        ObjectRenderer objectRenderer(_renderWorld, camera, _renderAlpha);
+        for (auto i = begin; i < end; ++i) {
+            objectRenderer.buildRenderList(objects[i], list);
+        }
+        chunkCulled[c] = objectRenderer.culled;
+
+        std::sort(list.begin(), list.end(), renderOrder);
+    });
+
+    for (auto c : chunkCulled) {
+        culled += c;
+    }
+
+    // Already holds the merged LOD meshes
+    auto &special = chunks.back();
+    culled += buildSpecialRenderList(world, special);
+    std::sort(special.begin(), special.end(), renderOrder);
+
+    RW_PROFILE_SCOPE("mergeRenderList");
+    // Concatenate the sorted chunks, then merge neighbouring runs in parallel
+    // until a single run is left
+    std::vector<size_t> runs{0};
+    size_t total = 0;
+    for (const auto &chunk : chunks) {
+        total += chunk.size();
+    }
+
+    RenderList renderList;
+    renderList.reserve(total);
+    for (auto &chunk : chunks) {
+        renderList.insert(renderList.end(),
+                          std::make_move_iterator(chunk.begin()),
+                          std::make_move_iterator(chunk.end()));
+        runs.push_back(renderList.size());
+    }
+
+    while (runs.size() > 2) {
+        const auto pairs = (runs.size() - 1) / 2;
+        jobs->parallelFor(pairs, pairs, [&](size_t p, size_t, size_t) {
+            auto first = renderList.begin() + runs[p * 2];
+            auto middle = renderList.begin() + runs[p * 2 + 1];
+            auto last = renderList.begin() + runs[p * 2 + 2];
+            std::inplace_merge(first, middle, last, renderOrder);
+        });
+
+        std::vector<size_t> merged;
+        for (size_t r = 0; r < runs.size(); r += 2) {
+            merged.push_back(runs[r]);
+        }
+        if (merged.back() != runs.back()) {
+            merged.push_back(runs.back());
+        }
+        runs = std::move(merged);
+    }
+
+    return renderList;
+}
+
+size_t GameRenderer::buildSpecialRenderList(const GameWorld *world,
+                                            RenderList &renderList) {
+    ObjectRenderer objectRenderer(_renderWorld,
+                                  (cullOverride ? cullingCamera : _camera),
+                                  _renderAlpha);
 
     // Area indicators
     auto sphereModel = getSpecialModel(ZoneCylinderA);
@@ -367,23 +500,8 @@ RenderList GameRenderer::createObjectRenderList(const GameWorld *world) {
         model = scale(model, glm::vec3(1.5f, 1.5f, 1.5f));
         objectRenderer.renderClump(arrowModel.get(), model, nullptr, renderList);
     }
-    culled += objectRenderer.culled;
-
-    RW_PROFILE_SCOPE("sortRenderList");
-    // Also parallelizable
-    // Earlier position in the array means earlier object's rendering
-    // Transparent objects should be sorted and rendered after opaque
-    sort(renderList.begin(), renderList.end(),
-         [](const Renderer::RenderInstruction &a,
-            const Renderer::RenderInstruction &b) {
-             if (a.drawInfo.blendMode == BlendMode::BLEND_NONE && b.drawInfo.blendMode != BlendMode::BLEND_NONE)
-                 return true;
-             if (a.drawInfo.blendMode != BlendMode::BLEND_NONE && b.drawInfo.blendMode == BlendMode::BLEND_NONE)
-                 return false;
-             return (a.sortKey > b.sortKey);
-         });
 
-    return renderList;
+    return objectRenderer.culled;
 }
 
 void GameRenderer::renderSplash(GameWorld* world, GLuint splashTexName, glm::u16vec3 fc) {
@@ -405,25 +523,17 @@ void GameRenderer::renderSplash(GameWorld* world, GLuint splashTexName, glm::u16
 
     glm::vec4 fadeNormed(fc.r / 255.f, fc.g / 255.f, fc.b / 255.f, a);
 
-    renderer->useProgram(ssRectProg.get());
-    renderer->setUniform(ssRectProg.get(), "colour", fadeNormed);
-    renderer->setUniform(ssRectProg.get(), "size", glm::vec2{1.f, 1.f});
-    renderer->setUniform(ssRectProg.get(), "offset", glm::vec2{0.f, 0.f});
-
-    Renderer::DrawParameters wdp;
-    wdp.depthMode = DepthMode::OFF;
-    wdp.blendMode = BlendMode::BLEND_ALPHA;
-    wdp.count = ssRectGeom.getCount();
-    wdp.textures = {{splashTexName}};
-
-    renderer->drawArrays(glm::mat4(1.0f), &ssRectDraw, wdp);
+    const glm::vec2 vp(renderer->getViewport());
+    sprites.drawRect({0.f, 0.f, vp.x, vp.y}, fadeNormed, splashTexName);
 }
 
 void GameRenderer::renderPostProcess() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glStencilMask(0xFF);
-    glClearStencil(0x00);
-    glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    if (!isHeadless()) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glStencilMask(0xFF);
+        glClearStencil(0x00);
+        glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    }
 
     renderer->useProgram(postProg.get());
 
@@ -437,124 +547,44 @@ void GameRenderer::renderPostProcess() {
 }
 
 void GameRenderer::renderEffects(GameWorld* world) {
-    renderer->useProgram(particleProg.get());
-
-    auto cpos = _camera.position;
-    auto cfwd = glm::normalize(glm::inverse(_camera.rotation) *
-                               glm::vec3(0.f, 1.f, 0.f));
-
-    auto& effects = world->effects;
-
-    std::sort(effects.begin(), effects.end(),
-              [&](const auto& a, const auto& b) {
-                  return glm::distance(a->position, cpos) >
-                         glm::distance(b->position, cpos);
-              });
-
-    for (auto& fx : effects) {
-        // Other effects not implemented yet
-        if (fx->getType() != Particle) continue;
-        auto particle = static_cast<ParticleFX*>(fx.get());
-
-        auto& p = particle->position;
-
-        // Figure the direction to the camera center.
-        auto amp = cpos - p;
-        glm::vec3 ptc = particle->up;
-
-        if (particle->orientation == ParticleFX::UpCamera) {
-            ptc = glm::normalize(amp - (glm::dot(amp, cfwd)) * cfwd);
-        } else if (particle->orientation == ParticleFX::Camera) {
-            ptc = amp;
-        }
-
-        ptc = glm::normalize(ptc);
-
-        glm::mat4 transformMat(1.f);
-
-        glm::mat4 lookMat = glm::lookAt(
-            glm::vec3(0.0f,0.0f,0.0f),
-            ptc,
-            glm::vec3(0.0f,0.0f,1.0f));
-
-        transformMat = glm::scale(glm::translate(transformMat,p),
-            glm::vec3(particle->size,1.0f)) * glm::inverse(lookMat);
-
-        Renderer::DrawParameters dp;
-        dp.textures = {{particle->texture->getName()}};
-        dp.ambient = 1.f;
-        dp.colour = glm::u8vec4(particle->colour * 255.f);
-        dp.start = 0;
-        dp.count = 4;
-        dp.blendMode = BlendMode::BLEND_ADDITIVE;
-        dp.diffuse = 1.f;
-
-        renderer->drawArrays(transformMat, &particleDraw, dp);
-    }
+    particles.render(*this, world, _camera);
 }
 
 void GameRenderer::drawTexture(TextureData* texture, glm::vec4 extents) {
-    drawRect({0.f, 0.f, 0.f, 1.f}, texture, extents);
+    sprites.drawRect(extents, {0.f, 0.f, 0.f, 1.f},
+                     texture ? texture->getName() : 0);
 }
 
 void GameRenderer::drawColour(const glm::vec4& colour, glm::vec4 extents) {
-    drawRect(colour, nullptr, extents);
-}
-
-void GameRenderer::drawRect(const glm::vec4& colour, TextureData* texture, glm::vec4& extents) {
-    // Move into NDC
-    extents.x /= renderer->getViewport().x;
-    extents.y /= renderer->getViewport().y;
-    extents.z /= renderer->getViewport().x;
-    extents.w /= renderer->getViewport().y;
-    extents.x += extents.z / 2.f;
-    extents.y += extents.w / 2.f;
-    extents.x -= .5f;
-    extents.y -= .5f;
-    extents *= glm::vec4(2.f, -2.f, 1.f, 1.f);
-
-    renderer->useProgram(ssRectProg.get());
-    renderer->setUniform(ssRectProg.get(), "colour", colour);
-    renderer->setUniform(ssRectProg.get(), "size", glm::vec2{extents.z, extents.w});
-    renderer->setUniform(ssRectProg.get(), "offset", glm::vec2{extents.x, extents.y});
-
-    Renderer::DrawParameters wdp;
-    wdp.depthMode = DepthMode::OFF;
-    wdp.blendMode = BlendMode::BLEND_ALPHA;
-    wdp.count = ssRectGeom.getCount();
-    wdp.textures = {{texture ? texture->getName() : 0}};
-
-    renderer->drawArrays(glm::mat4(1.0f), &ssRectDraw, wdp);
+    sprites.drawRect(extents, colour);
 }
 
 void GameRenderer::renderLetterbox() {
     constexpr float cinematicExperienceSize = 0.15f;
-    renderer->useProgram(ssRectProg.get());
-    renderer->setUniform(ssRectProg.get(), "colour", glm::vec4{0.f, 0.f, 0.f, 1.f});
-    renderer->setUniform(ssRectProg.get(), "size", glm::vec2{1.f, cinematicExperienceSize});
-    renderer->setUniform(ssRectProg.get(), "offset", glm::vec2{0.f,-1.f * (1.f - cinematicExperienceSize)});
-    Renderer::DrawParameters wdp;
-    wdp.depthMode = DepthMode::OFF;
-    wdp.blendMode = BlendMode::BLEND_NONE;
-    wdp.count = ssRectGeom.getCount();
-    wdp.textures = {{0}};
+    // The bars are opaque, so they can share the draw of the splash
+    const glm::vec2 vp(renderer->getViewport());
+    const float height = vp.y * cinematicExperienceSize;
+    const glm::vec4 black{0.f, 0.f, 0.f, 1.f};
+    sprites.drawRect({0.f, 0.f, vp.x, height}, black);
+    sprites.drawRect({0.f, vp.y - height, vp.x, height}, black);
+}
 
-    renderer->drawArrays(glm::mat4(1.0f), &ssRectDraw, wdp);
-    renderer->setUniform(ssRectProg.get(), "offset", glm::vec2{0.f, 1.f * (1.f - cinematicExperienceSize)});
-    renderer->drawArrays(glm::mat4(1.0f), &ssRectDraw, wdp);
+void GameRenderer::flushScreenSpace() {
+    text.flush();
+    sprites.flush();
 }
 
 void GameRenderer::setViewport(int w, int h) {
     auto& lastViewport = renderer->getViewport();
     if (lastViewport.x != w || lastViewport.y != h) {
         renderer->setViewport({w, h});
+        if (isHeadless()) {
+            return;
+        }
 
         glBindTexture(GL_TEXTURE_2D, fbTextures[0]);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, w, h, 0, GL_RGB,
                      GL_UNSIGNED_BYTE, nullptr);
-        glBindTexture(GL_TEXTURE_2D, fbTextures[1]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, w, h, 0, GL_RED, GL_FLOAT,
-                     nullptr);
 
         glBindRenderbuffer(GL_RENDERBUFFER, fbRenderBuffers[0]);
         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
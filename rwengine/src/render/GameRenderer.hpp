@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 #include <gl/DrawBuffer.hpp>
 #include <gl/GeometryBuffer.hpp>
@@ -10,13 +11,18 @@
 #include <rw/forward.hpp>
 
 #include <render/OpenGLRenderer.hpp>
+#include <render/LodCellMeshes.hpp>
 #include <render/MapRenderer.hpp>
+#include <render/ParticleRenderer.hpp>
+#include <render/SpriteRenderer.hpp>
 #include <render/TextRenderer.hpp>
 #include <render/ViewCamera.hpp>
 #include <render/WaterRenderer.hpp>
 
 class Logger;
 class GameData;
+class JobSystem;
+class GameObject;
 class GameWorld;
 class TextureData;
 
@@ -34,14 +40,14 @@ class GameRenderer {
     Logger* logger;
 
     /** The low-level drawing interface to use */
-    std::unique_ptr<Renderer> renderer = std::make_unique<OpenGLRenderer>();
+    std::unique_ptr<Renderer> renderer;
 
     // Temporary variables used during rendering
     float _renderAlpha{0.f};
     GameWorld* _renderWorld = nullptr;
 
     /** Internal non-descript VAOs */
-    GLuint vao;
+    GLuint vao = 0;
 
     /** Camera values passed to renderWorld() */
     ViewCamera _camera;
@@ -50,29 +56,43 @@ class GameRenderer {
 
     /** Number of culling events */
     size_t culled;
-
-    GLuint framebufferName;
-    GLuint fbTextures[2];
-    GLuint fbRenderBuffers[1];
+    /** Static instance cells rejected, and the instances in them */
+    size_t culledCells = 0;
+    size_t culledInstances = 0;
+    /** Cells drawn from their merged LOD mesh */
+    size_t mergedCells = 0;
+
+    /** Objects that weren't rejected by cell, reused between frames */
+    std::vector<GameObject*> renderObjects_;
+
+    GLuint framebufferName = 0;
+    GLuint fbTextures[1]{};
+    GLuint fbRenderBuffers[1]{};
     std::unique_ptr<Renderer::ShaderProgram> postProg;
 
-    GeometryBuffer particleGeom;
-    DrawBuffer particleDraw;
-
     GeometryBuffer ssRectGeom;
     DrawBuffer ssRectDraw;
 
+    /** Used to build the render list in parallel, if set */
+    JobSystem* jobs = nullptr;
+    bool parallelRenderList = true;
+
+    void createFramebuffer();
+
 public:
-    GameRenderer(Logger* log, GameData* data);
+    /**
+     * @param renderer The drawing interface, NullRenderer records the draws
+     * without a GL context
+     */
+    GameRenderer(Logger* log, GameData* data,
+                 std::unique_ptr<Renderer> renderer =
+                     std::make_unique<OpenGLRenderer>());
     ~GameRenderer();
 
     std::unique_ptr<Renderer::ShaderProgram> worldProg;
     std::unique_ptr<Renderer::ShaderProgram> skyProg;
-    std::unique_ptr<Renderer::ShaderProgram> particleProg;
 
-    std::unique_ptr<Renderer::ShaderProgram> ssRectProg;
-
-    GLuint skydomeIBO;
+    GLuint skydomeIBO = 0;
 
     DrawBuffer skyDbuff;
     GeometryBuffer skyGbuff;
@@ -85,6 +105,18 @@ public:
         return culled;
     }
 
+    size_t getCulledCellCount() const {
+        return culledCells;
+    }
+
+    size_t getCulledInstanceCount() const {
+        return culledInstances;
+    }
+
+    size_t getMergedCellCount() const {
+        return mergedCells;
+    }
+
     /**
      * Renders the world using the parameters of the passed Camera.
      * Note: The camera's near and far planes are overriden by weather effects.
@@ -113,6 +145,12 @@ public:
     /** Increases cinematic value */
     void renderLetterbox();
 
+    /**
+     * Draws the queued text and rectangles, before drawing anything in
+     * screen space that isn't queued with them
+     */
+    void flushScreenSpace();
+
     void setupRender();
     void renderPostProcess();
 
@@ -127,9 +165,33 @@ public:
         cullOverride = override;
     }
 
+    /**
+     * @brief setJobSystem Set the JobSystem used to build render lists
+     *
+     * The JobSystem must outlive the GameRenderer, or be unset first.
+     */
+    void setJobSystem(JobSystem* jobSystem) {
+        jobs = jobSystem;
+    }
+
+    /**
+     * Enables building the object render list on the JobSystem, otherwise
+     * it is built sequentially.
+     */
+    void setParallelRenderList(bool parallel) {
+        parallelRenderList = parallel;
+    }
+
+    bool isParallelRenderList() const {
+        return parallelRenderList;
+    }
+
     MapRenderer map;
     WaterRenderer water;
+    ParticleRenderer particles;
     TextRenderer text;
+    SpriteRenderer sprites;
+    LodCellMeshes lodMeshes;
 
     // Profiling data
     Renderer::ProfileInfo profObjects;
@@ -160,11 +222,18 @@ private:
         return specialmodels_[usage];
     }
 
-    void drawRect(const glm::vec4& colour, TextureData* texture, glm::vec4& extents);
-
     void renderObjects(const GameWorld *world);
 
+    /// Collects the objects to build the render list from into renderObjects_,
+    /// and adds the merged LOD meshes in view to renderList
+    void gatherRenderObjects(const GameWorld *world, RenderList &renderList);
+
     RenderList createObjectRenderList(const GameWorld *world);
+
+    RenderList createObjectRenderListParallel(const GameWorld *world);
+
+    /// Adds area indicators and blip arrows, returns the number culled
+    size_t buildSpecialRenderList(const GameWorld *world, RenderList &renderList);
 };
 
 #endif
@@ -7,7 +7,8 @@
 namespace GameShaders {
 
 /**
- * High Quality Projected-Grid water shader
+ * Water shader for the instanced grid patches, raised to the height of the
+ * water table
  */
 struct WaterHQ {
     static constexpr char const* VertexShader =
@@ -15,6 +16,8 @@ struct WaterHQ {
             #version 330
 
             layout(location = 0) in vec2 position;
+            layout(location = 4) in vec3 patch;
+            out vec2 WorldPos;
             out vec2 TexCoords;
 
             layout(std140) uniform SceneData {
@@ -28,92 +31,46 @@ struct WaterHQ {
                 float fogEnd;
             };
 
-            uniform mat4 inverseVP;
-
             uniform float time;
             uniform vec2 waveParams;
+            uniform float worldSize;
             uniform sampler2D data;
 
-            vec3 waterNormal = vec3(0.0, 0.0, 1.0);
-
-            vec3 planeIntercept( vec3 start, vec3 dir, float height ) {
-                float dist = (height - dot(waterNormal, start)) / dot(dir, waterNormal);
-                if( dist < 0.0 ) {
-                    return start + dir * dist;
-                }
-                else {
-                    // uh oh
-                    return vec3(0.0);
-                }
-            }
-
             void main() {
-                TexCoords = position * vec2(0.5,0.5) + vec2(0.5);
-
-                mat4 vp = projection * view;
-                mat4 projector = inverseVP;
-
-                mat3 rot = mat3(view);
-                vec3 ray = vec3(-position.x, -position.y, projection[0][0] ) * rot;
-
-                float plane = texture( data, TexCoords ).r;
-
-                vec3 ws = planeIntercept( campos.xyz, ray, plane );
-
-                ws.z = ws.z + (-1.0+(sin(time + (ws.x + ws.y) * waveParams.x)) * waveParams.y);
-                TexCoords = ws.xy / 5.0;
-                gl_Position = vp * vec4(ws, 1.0);
+                vec2 ws = patch.xy + position * patch.z;
+                vec2 table = ws / worldSize + vec2(0.5);
+
+                // Vertices on the edge of a tile take the higher neighbour
+                vec2 texel = 0.01 / vec2(textureSize(data, 0));
+                float h = max(
+                    max(texture(data, table + vec2(-texel.x, -texel.y)).r,
+                        texture(data, table + vec2(texel.x, -texel.y)).r),
+                    max(texture(data, table + vec2(-texel.x, texel.y)).r,
+                        texture(data, table + vec2(texel.x, texel.y)).r));
+
+                // The same waves as GameData::getWaterHeightsAt()
+                float z = h + (1.0 + sin(time + (ws.x + ws.y) * waveParams.x)) *
+                                  waveParams.y;
+                WorldPos = ws;
+                TexCoords = ws / 5.0;
+                gl_Position = projection * view * vec4(ws, z, 1.0);
             })";
     static constexpr char const* FragmentShader =
         R"(
             #version 330
 
-            in vec3 Normal;
+            in vec2 WorldPos;
             in vec2 TexCoords;
             uniform sampler2D tex;
-            out vec4 outColour;
-            in vec3 test;
-            void main() {
-                vec4 c = texture(tex, TexCoords);
-                outColour = c;
-            })";
-};
-
-/**
- * Simple 3D masking shader
- */
-struct Mask3D {
-    static constexpr char const* VertexShader =
-        R"(
-            #version 330
-
-            layout(location = 0) in vec3 position;
-
-            layout(std140) uniform SceneData {
-                mat4 projection;
-                mat4 view;
-                vec4 ambient;
-                vec4 dynamic;
-                vec4 fogColor;
-                vec4 campos;
-                float fogStart;
-                float fogEnd;
-            };
-
-            out vec3 pp;
-
-            void main() {
-                pp = position;
-                gl_Position = projection * view * vec4(position, 1.0);
-            })";
-    static constexpr char const* FragmentShader =
-        R"(
-            #version 330
-
-            in vec3 pp;
+            uniform sampler2D data;
+            uniform float worldSize;
             out vec4 outColour;
             void main() {
-                outColour = vec4(pp.z, 0.0, 0.0, 1.0);
+                // Patches can cover tiles without water
+                if (texture(data, WorldPos / worldSize + vec2(0.5)).g < 0.5) {
+                    discard;
+                }
+                outColour = texture(tex, TexCoords);
             })";
 };
 
@@ -180,19 +137,39 @@ struct WorldObject {
                 float fogEnd;
             };
 
-            layout(std140) uniform ObjectData {
+            struct ObjectInfo {
                 mat4 model;
                 vec4 colour;
                 float diffusefac;
                 float ambientfac;
                 float visibility;
+                float layer;
+            };
+
+            // Must match OpenGLRenderer::kMaxBatchObjects
+            layout(std140) uniform ObjectData {
+                ObjectInfo objects[128];
             };
 
+            // Index of the first instance's data in objects
+            uniform int objectBase;
+
+            flat out vec4 ObjectColour;
+            flat out float AmbientFac;
+            flat out float Visibility;
+            flat out float Layer;
+
             void main() {
+                ObjectInfo object = objects[objectBase + gl_InstanceID];
+                ObjectColour = object.colour;
+                AmbientFac = object.ambientfac;
+                Visibility = object.visibility;
+                Layer = object.layer;
+
                 Normal = normal;
                 TexCoords = texCoords;
                 Colour = _colour;
-                vec4 worldspace = model * vec4(position, 1.0);
+                vec4 worldspace = object.model * vec4(position, 1.0);
                 vec4 viewspace = view * worldspace;
                 gl_Position = projection * viewspace;
 
@@ -206,7 +183,12 @@ struct WorldObject {
             in vec2 TexCoords;
             in vec4 Colour;
             in vec4 WorldSpace;
+            flat in vec4 ObjectColour;
+            flat in float AmbientFac;
+            flat in float Layer;
             uniform sampler2D tex;
+            // Packed textures are sampled from a layer of texArray
+            uniform sampler2DArray texArray;
             out vec4 fragOut;
 
             layout(std140) uniform SceneData {
@@ -220,39 +202,41 @@ struct WorldObject {
                 float fogEnd;
             };
 
-            layout(std140) uniform ObjectData {
-                mat4 model;
-                vec4 colour;
-                float diffusefac;
-                float ambientfac;
-                float visibility;
-            };
-
             float alphaThreshold = (1.0/255.0);
 
             void main() {
                 // Only the visibility parameter invokes the screen door.
                 vec4 diffuse = Colour;
-                diffuse.rgb += ambient.rgb*ambientfac;
-                diffuse *= colour;
-                diffuse *= texture(tex, TexCoords);
+                diffuse.rgb += ambient.rgb*AmbientFac;
+                diffuse *= ObjectColour;
+                if (Layer >= 0.0) {
+                    diffuse *= texture(texArray, vec3(TexCoords, Layer));
+                } else {
+                    diffuse *= texture(tex, TexCoords);
+                }
                 if(diffuse.a <= alphaThreshold) discard;
                 float fog = 1.0 - clamp( (fogEnd-WorldSpace.w)/(fogEnd-fogStart), 0.0, 1.0 );
                 fragOut = vec4(mix(diffuse.rgb, fogColor.rgb, fog), diffuse.a);
             })";
 };
 
-/** @brief Particle effect shaders, uses WorldObject::VertexShader */
+/** @brief Particle effect shaders, drawn as instances of a quad */
 struct Particle {
-    static constexpr char const* FragmentShader =
+    static constexpr char const* VertexShader =
         R"(
             #version 330
 
-            in vec3 Normal;
-            in vec2 TexCoords;
-            in vec4 Colour;
-            uniform sampler2D tex;
-            out vec4 outColour;
+            layout(location = 0) in vec2 corner;
+            layout(location = 2) in vec4 _colour;
+            layout(location = 3) in vec2 texCoords;
+            // Must match ParticleRenderer::Instance
+            layout(location = 4) in vec4 centre;
+            layout(location = 5) in vec3 up;
+            layout(location = 6) in vec2 size;
+            layout(location = 7) in vec4 tint;
+            out vec3 Normal;
+            out vec2 TexCoords;
+            out vec4 Colour;
 
             layout(std140) uniform SceneData {
                 mat4 projection;
@@ -265,61 +249,72 @@ struct Particle {
                 float fogEnd;
             };
 
-            layout(std140) uniform ObjectData {
-                mat4 model;
-                vec4 colour;
-                float diffusefac;
-                float ambientfac;
-                float visibility;
-            };
+            uniform vec3 cameraForward;
 
-            #define ALPHA_DISCARD_THRESHOLD 0.01
+            flat out vec4 ObjectColour;
+            flat out float Visibility;
 
-            void main() {
-                vec4 c = texture(tex, TexCoords);
-                c.a = clamp(0, length(c.rgb/length(vec3(1,1,1))), 1);
-                if(c.a <= ALPHA_DISCARD_THRESHOLD) discard;
-                float fogZ = (gl_FragCoord.z / gl_FragCoord.w);
-                float fogfac = clamp( (fogStart-fogZ)/(fogEnd-fogStart), 0.0, 1.0 );
-                vec4 tint = vec4(colour.rgb, visibility);
-                outColour = c * tint;
-            })";
-};
+            // ParticleFX::Orientation, stored in centre.w
+            const int Camera = 1;
+            const int UpCamera = 2;
 
-/**
- * @brief The ScreenSpaceRect shader
- *
- * Used to draw black bars, splash screens, fading etc.
- */
-struct ScreenSpaceRect {
-    static constexpr char const* VertexShader =
-        R"(
-            #version 330
+            void main() {
+                vec3 toCamera = campos.xyz - centre.xyz;
+                vec3 facing = up;
+                int orientation = int(centre.w);
+                if (orientation == UpCamera) {
+                    facing = toCamera - dot(toCamera, cameraForward) * cameraForward;
+                } else if (orientation == Camera) {
+                    facing = toCamera;
+                }
+                facing = normalize(facing);
 
-            layout(location = 0) in vec2 position;
-            out vec2 TexCoords;
-            out vec4 Colour;
-            uniform vec2 size;
-            uniform vec2 offset;
+                // The quad's axes, as glm::lookAt would build them
+                vec3 side = normalize(cross(facing, vec3(0.0, 0.0, 1.0)));
+                vec3 above = cross(side, facing);
+                vec3 offset = corner.x * side + corner.y * above;
+                vec3 worldspace = centre.xyz + vec3(size, 1.0) * offset;
+                gl_Position = projection * view * vec4(worldspace, 1.0);
 
-            void main() {
-                TexCoords = position * vec2(0.5,-0.5) + vec2(0.5);
-                gl_Position = vec4(offset + position * size, 0.0, 1.0);
+                Normal = -facing;
+                TexCoords = texCoords;
+                Colour = _colour;
+                ObjectColour = tint;
+                Visibility = 1.0;
             })";
     static constexpr char const* FragmentShader =
         R"(
             #version 330
 
+            in vec3 Normal;
             in vec2 TexCoords;
             in vec4 Colour;
-            uniform vec4 colour;
+            flat in vec4 ObjectColour;
+            flat in float Visibility;
             uniform sampler2D tex;
             out vec4 outColour;
 
+            layout(std140) uniform SceneData {
+                mat4 projection;
+                mat4 view;
+                vec4 ambient;
+                vec4 dynamic;
+                vec4 fogColor;
+                vec4 campos;
+                float fogStart;
+                float fogEnd;
+            };
+
+            #define ALPHA_DISCARD_THRESHOLD 0.01
+
             void main() {
                 vec4 c = texture(tex, TexCoords);
-                // Set colour to 0, 0, 0, 1 for textured mode.
-                outColour = vec4(colour.rgb + c.rgb, colour.a * c.a);
+                c.a = clamp(0, length(c.rgb/length(vec3(1,1,1))), 1);
+                if(c.a <= ALPHA_DISCARD_THRESHOLD) discard;
+                float fogZ = (gl_FragCoord.z / gl_FragCoord.w);
+                float fogfac = clamp( (fogStart-fogZ)/(fogEnd-fogStart), 0.0, 1.0 );
+                vec4 tint = vec4(ObjectColour.rgb, Visibility);
+                outColour = c * tint;
             })";
 };
 
@@ -0,0 +1,268 @@
+#include "render/LodCellMeshes.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include <data/Clump.hpp>
+#include <gl/TextureData.hpp>
+#include <rw/headless.hpp>
+#include <rw/types.hpp>
+
+#include "core/Profiler.hpp"
+#include "data/ModelData.hpp"
+#include "objects/InstanceObject.hpp"
+
+namespace {
+/// The same parameters ObjectRenderer::renderGeometry uses for the subgeometry
+Renderer::DrawParameters materialParameters(const Geometry& geometry,
+                                            const SubGeometry& subgeom,
+                                            const SimpleModelInfo& modelinfo) {
+    Renderer::DrawParameters dp;
+    dp.colour = {255, 255, 255, 255};
+    dp.textures = {{0}};
+    dp.visibility = 1.f;
+    dp.depthWrite = !(modelinfo.flags & SimpleModelInfo::NO_ZBUFFER_WRITE);
+
+    bool isTransparent = false;
+    if (geometry.materials.size() > subgeom.material) {
+        const auto& mat = geometry.materials[subgeom.material];
+
+        if (!mat.textures.empty() && mat.textures[0].texture) {
+            const auto tex = mat.textures[0].texture;
+            isTransparent = tex->isTransparent();
+            dp.textures = {{tex->getName()}};
+            dp.textureArray = tex->getArrayName();
+            dp.layer = static_cast<float>(tex->getLayer());
+        }
+
+        if ((geometry.flags & RW::BSGeometry::ModuleMaterialColor) ==
+            RW::BSGeometry::ModuleMaterialColor) {
+            dp.colour = mat.colour;
+        }
+
+        if (dp.colour.a < 255) {
+            isTransparent = true;
+        }
+
+        dp.diffuse = mat.diffuseIntensity;
+        dp.ambient = mat.ambientIntensity;
+    }
+
+    dp.blendMode =
+        isTransparent ? BlendMode::BLEND_ALPHA : BlendMode::BLEND_NONE;
+    return dp;
+}
+
+bool sameMaterial(const Renderer::DrawParameters& a,
+                  const Renderer::DrawParameters& b) {
+    return a.textures == b.textures && a.textureArray == b.textureArray &&
+           a.layer == b.layer && a.colour == b.colour &&
+           a.blendMode == b.blendMode && a.depthWrite == b.depthWrite &&
+           a.diffuse == b.diffuse && a.ambient == b.ambient;
+}
+
+/// Appends the subgeometry's triangles, turning strips into lists
+void appendTriangles(const Geometry& geometry, const SubGeometry& subgeom,
+                     uint32_t base, std::vector<uint32_t>& out) {
+    const auto& indices = subgeom.indices;
+    if (geometry.facetype == Geometry::Triangles) {
+        for (auto index : indices) {
+            out.push_back(base + index);
+        }
+        return;
+    }
+
+    for (std::size_t i = 2; i < indices.size(); ++i) {
+        auto a = indices[i - 2], b = indices[i - 1];
+        const auto c = indices[i];
+        // Strips are joined by repeating indices
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+        // Every other triangle in a strip has the opposite winding
+        if (i % 2 == 1) {
+            std::swap(a, b);
+        }
+        out.insert(out.end(), {base + a, base + b, base + c});
+    }
+}
+}  // namespace
+
+LodCellMeshes::CellMesh::~CellMesh() {
+    if (ebo) {
+        glDeleteBuffers(1, &ebo);
+    }
+}
+
+bool LodCellMeshes::canMerge(const InstanceObject& instance) {
+    const auto modelinfo = instance.getModelInfo<SimpleModelInfo>();
+    return modelinfo->isBigBuilding() && modelinfo->getNumAtomics() == 1 &&
+           modelinfo->timeOn == 0 && modelinfo->timeOff == 24 &&
+           instance.isVisible() && instance.getAtomic();
+}
+
+bool LodCellMeshes::MeshBuilder::add(const Geometry& geometry,
+                                     const glm::mat4& transform,
+                                     const SimpleModelInfo& modelinfo) {
+    if (geometry.vertices.empty()) {
+        return false;
+    }
+
+    const glm::mat3 rotation(transform);
+    const auto base = static_cast<uint32_t>(vertices.size());
+    for (const auto& v : geometry.vertices) {
+        const glm::vec3 position(transform * glm::vec4(v.position, 1.f));
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+        vertices.emplace_back(position, rotation * v.normal, v.texcoord,
+                              v.colour);
+    }
+
+    for (const auto& subgeom : geometry.subgeom) {
+        const auto dp = materialParameters(geometry, subgeom, modelinfo);
+        auto group = std::find_if(
+            groups.begin(), groups.end(),
+            [&](const Group& g) { return sameMaterial(g.dp, dp); });
+        if (group == groups.end()) {
+            group = groups.insert(groups.end(), Group{dp, {}});
+        }
+        appendTriangles(geometry, subgeom, base, group->indices);
+    }
+    return true;
+}
+
+void LodCellMeshes::MeshBuilder::build(
+    std::vector<uint32_t>& indices,
+    std::vector<Renderer::DrawParameters>& draws) const {
+    for (const auto& group : groups) {
+        if (group.indices.empty()) {
+            continue;
+        }
+        auto dp = group.dp;
+        dp.start = indices.size();
+        dp.count = group.indices.size();
+        indices.insert(indices.end(), group.indices.begin(),
+                       group.indices.end());
+        draws.push_back(dp);
+    }
+}
+
+std::size_t LodCellMeshes::update(const StaticInstanceGrid& grid) {
+    if (!isEnabled()) {
+        return 0;
+    }
+
+    const auto& cells = grid.getCells();
+    cells_.resize(cells.size());
+
+    std::size_t built = 0;
+    for (std::size_t c = 0; c < cells.size(); ++c) {
+        auto& entry = cells_[c];
+        if (entry.version == cells[c].version) {
+            if (entry.built) {
+                continue;
+            }
+            // The model may never load, so don't try every frame
+            if (entry.waitingFor && !entry.waitingFor->isLoaded()) {
+                continue;
+            }
+        }
+
+        RW_PROFILE_SCOPE("buildLodCellMesh");
+        if (entry.mesh) {
+            stats_.meshes--;
+            stats_.instances -= entry.mesh->merged;
+            stats_.vertices -= static_cast<std::size_t>(
+                entry.mesh->gbuff.getCount());
+        }
+        if (build(cells[c], entry) && entry.mesh) {
+            stats_.meshes++;
+            stats_.instances += entry.mesh->merged;
+            stats_.vertices += static_cast<std::size_t>(
+                entry.mesh->gbuff.getCount());
+            built++;
+        }
+    }
+    return built;
+}
+
+void LodCellMeshes::clear() {
+    cells_.clear();
+    stats_ = {};
+}
+
+bool LodCellMeshes::build(const StaticInstanceGrid::Cell& cell, Entry& entry) {
+    entry.mesh.reset();
+    entry.version = cell.version;
+    entry.waitingFor = nullptr;
+
+    std::vector<InstanceObject*> merged;
+    std::vector<InstanceObject*> others;
+    for (auto instance : cell.instances) {
+        if (!canMerge(*instance)) {
+            others.push_back(instance);
+            continue;
+        }
+        const auto modelinfo = instance->getModelInfo<SimpleModelInfo>();
+        const auto atomic = modelinfo->getAtomic(0);
+        if (!modelinfo->isLoaded() || !atomic || !atomic->getGeometry()) {
+            entry.built = false;
+            entry.waitingFor = modelinfo;
+            return false;
+        }
+        merged.push_back(instance);
+    }
+
+    entry.built = true;
+    if (merged.empty()) {
+        return true;
+    }
+
+    auto mesh = std::make_unique<CellMesh>();
+    MeshBuilder builder;
+    for (auto instance : merged) {
+        const auto modelinfo = instance->getModelInfo<SimpleModelInfo>();
+        const auto& geometry = *modelinfo->getAtomic(0)->getGeometry();
+        const auto& transform =
+            instance->getAtomic()->getFrame()->getWorldTransform();
+
+        // Models loaded before they were known to be big buildings
+        if (!builder.add(geometry, transform, *modelinfo)) {
+            others.push_back(instance);
+            continue;
+        }
+
+        mesh->merged++;
+        mesh->lodDistance =
+            std::max(mesh->lodDistance, modelinfo->getLargestLodDistance());
+    }
+
+    mesh->others = std::move(others);
+    if (mesh->merged == 0) {
+        return true;
+    }
+
+    std::vector<uint32_t> indices;
+    builder.build(indices, mesh->draws);
+
+    mesh->center = (builder.getMin() + builder.getMax()) * 0.5f;
+    mesh->radius = glm::length(builder.getMax() - builder.getMin()) * 0.5f;
+
+    mesh->gbuff.uploadVertices(builder.getVertices());
+    mesh->dbuff.setFaceType(GL_TRIANGLES);
+    mesh->dbuff.addGeometry(&mesh->gbuff);
+
+    // Bound to the draw buffer's vertex array
+    if (!isHeadless()) {
+        glGenBuffers(1, &mesh->ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                     static_cast<GLsizeiptr>(sizeof(uint32_t) * indices.size()),
+                     indices.data(), GL_STATIC_DRAW);
+    }
+
+    entry.mesh = std::move(mesh);
+    return true;
+}
@@ -0,0 +1,184 @@
+#ifndef _RWENGINE_LODCELLMESHES_HPP_
+#define _RWENGINE_LODCELLMESHES_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <gl/DrawBuffer.hpp>
+#include <gl/GeometryBuffer.hpp>
+#include <gl/gl_core_3_3.h>
+
+#include <render/OpenGLRenderer.hpp>
+
+#include <engine/StaticInstanceGrid.hpp>
+
+class InstanceObject;
+class SimpleModelInfo;
+struct Geometry;
+struct GeometryVertex;
+
+/**
+ * @brief Merged meshes of the big buildings in each StaticInstanceGrid cell
+ *
+ * Most of the distant skyline is drawn with the LOD models of big
+ * buildings, which costs a draw for each instance. For every cell, the LOD
+ * geometry of those instances is moved into world space and merged into
+ * one mesh with a draw for each material. Beyond the merge distance the
+ * renderer draws the cell's mesh instead of its big building instances.
+ *
+ * A cell's mesh is built again when its instances change, once every model
+ * it needs has been loaded. Until then its instances are drawn one by one.
+ * The meshes are built from the vertices big building models keep on the
+ * CPU, see GameData::keepsModelVertices.
+ */
+class LodCellMeshes {
+public:
+    static constexpr float kDefaultDistance = 600.f;
+
+    struct CellMesh {
+        GeometryBuffer gbuff;
+        DrawBuffer dbuff;
+        GLuint ebo = 0;
+        /// One draw for each material
+        std::vector<Renderer::DrawParameters> draws;
+        /// The cell's instances that aren't part of the mesh
+        std::vector<InstanceObject*> others;
+        std::size_t merged = 0;
+        /// Largest LOD distance of the merged instances' models
+        float lodDistance = 0.f;
+        glm::vec3 center{};
+        float radius = 0.f;
+
+        CellMesh() = default;
+        ~CellMesh();
+
+        CellMesh(const CellMesh&) = delete;
+        CellMesh& operator=(const CellMesh&) = delete;
+    };
+
+    struct Statistics {
+        std::size_t meshes = 0;
+        std::size_t instances = 0;
+        std::size_t vertices = 0;
+    };
+
+    /**
+     * @brief Merges geometry into world space vertices and indices
+     *
+     * Triangles are grouped by material, strips are turned into lists.
+     */
+    class MeshBuilder {
+    public:
+        /**
+         * Adds the geometry placed by transform
+         *
+         * @return false if the geometry's vertices aren't on the CPU
+         */
+        bool add(const Geometry& geometry, const glm::mat4& transform,
+                 const SimpleModelInfo& modelinfo);
+
+        /**
+         * Writes the indices of every material in turn, with a draw for each
+         */
+        void build(std::vector<uint32_t>& indices,
+                   std::vector<Renderer::DrawParameters>& draws) const;
+
+        const std::vector<GeometryVertex>& getVertices() const {
+            return vertices;
+        }
+
+        const glm::vec3& getMin() const {
+            return min;
+        }
+
+        const glm::vec3& getMax() const {
+            return max;
+        }
+
+    private:
+        struct Group {
+            Renderer::DrawParameters dp;
+            std::vector<uint32_t> indices;
+        };
+
+        std::vector<Group> groups;
+        std::vector<GeometryVertex> vertices;
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+    };
+
+    /**
+     * Sets the distance from the camera beyond which cells are drawn from
+     * their meshes, 0 disables the meshes
+     */
+    void setDistance(float distance) {
+        distance_ = distance;
+        if (!isEnabled()) {
+            clear();
+        }
+    }
+
+    float getDistance() const {
+        return distance_;
+    }
+
+    bool isEnabled() const {
+        return distance_ > 0.f;
+    }
+
+    /**
+     * Builds the meshes of the cells that have changed since they were last
+     * built. This uses the GL directly, the renderer's state must be
+     * invalidated afterwards.
+     *
+     * @return the number of meshes built
+     */
+    std::size_t update(const StaticInstanceGrid& grid);
+
+    /**
+     * @return the current mesh of the cell at index in the grid's cells, or
+     * nullptr if it has none
+     */
+    CellMesh* getMesh(std::size_t index) const {
+        return index < cells_.size() ? cells_[index].mesh.get() : nullptr;
+    }
+
+    void clear();
+
+    const Statistics& getStatistics() const {
+        return stats_;
+    }
+
+    /**
+     * @return true if the instance is drawn with a single LOD model at all
+     * times, so its geometry can be merged
+     */
+    static bool canMerge(const InstanceObject& instance);
+
+private:
+    struct Entry {
+        std::unique_ptr<CellMesh> mesh;
+        uint32_t version = 0;
+        bool built = false;
+        /// The model the cell is waiting on, it isn't tried again until this
+        /// has loaded or the cell changes
+        const SimpleModelInfo* waitingFor = nullptr;
+    };
+
+    /**
+     * @return false if the cell has to wait for a model to load
+     */
+    bool build(const StaticInstanceGrid::Cell& cell, Entry& entry);
+
+    std::vector<Entry> cells_;
+    float distance_ = kDefaultDistance;
+    Statistics stats_;
+};
+
+#endif
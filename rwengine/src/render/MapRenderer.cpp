@@ -1,7 +1,10 @@
 #include "render/MapRenderer.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
+#include <limits>
+#include <string>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -10,6 +13,7 @@
 
 #include <gl/gl_core_3_3.h>
 #include <gl/TextureData.hpp>
+#include <rw/headless.hpp>
 
 #include "engine/GameData.hpp"
 #include "engine/GameState.hpp"
@@ -45,6 +49,48 @@ void main() {
     vec4 c = texture(spriteTexture, TexCoord*0.99);
     outColour = vec4(colour.rgb + c.rgb, colour.a * c.a);
 })";
+
+constexpr char const* MapBatchVertexShader = R"(
+#version 330
+
+layout(location = 0) in vec2 position;
+layout(location = 2) in vec4 colour;
+layout(location = 3) in vec2 texcoord;
+out vec2 TexCoord;
+out vec4 Colour;
+
+uniform mat4 proj;
+
+void main() {
+    gl_Position = proj * vec4(position, 0.0, 1.0);
+    TexCoord = texcoord;
+    Colour = colour;
+})";
+
+constexpr char const* MapBatchFragmentShader = R"(
+#version 330
+
+in vec2 TexCoord;
+in vec4 Colour;
+uniform sampler2D spriteTexture;
+out vec4 outColour;
+
+void main() {
+    vec4 c = texture(spriteTexture, TexCoord);
+    outColour = vec4(Colour.rgb + c.rgb, Colour.a * c.a);
+})";
+
+constexpr float kMapSize = 4000.f;
+/// The radar is 8 by 8 tiles, radar00 is at -x, +y then they increase in X,
+/// then Y
+constexpr int kMapBlockLine = 8;
+
+/// Blip texture coordinates are pulled in to avoid sampling the opposite edge
+constexpr float kBlipTexCoordScale = 0.99f;
+
+std::string radarTileName(int m) {
+    return "radar" + std::string(m < 10 ? "0" : "") + std::to_string(m);
+}
 }  // namespace
 
 MapRenderer::MapRenderer(Renderer &renderer, GameData* _data)
@@ -66,13 +112,97 @@ MapRenderer::MapRenderer(Renderer &renderer, GameData* _data)
     circle.setFaceType(GL_TRIANGLE_FAN);
 
     rectProg = renderer.createShader(MapVertexShader, MapFragmentShader);
+    batchProg =
+        renderer.createShader(MapBatchVertexShader, MapBatchFragmentShader);
 
     renderer.setUniform(rectProg.get(), "colour", glm::vec4(1.f));
+
+    batchDraw.setFaceType(GL_TRIANGLES);
+    outlineDraw.setFaceType(GL_LINES);
 }
 
-#define GAME_MAP_SIZE 4000
+MapRenderer::~MapRenderer() {
+    if (radarAtlas != 0) {
+        glDeleteTextures(1, &radarAtlas);
+    }
+}
+
+void MapRenderer::loadRadarAtlas() {
+    if (isHeadless()) {
+        return;
+    }
+
+    std::vector<TextureData*> tiles(MAP_BLOCK_SIZE, nullptr);
+    glm::ivec2 tileSize{0};
+    for (int m = 0; m < MAP_BLOCK_SIZE; ++m) {
+        const auto name = radarTileName(m);
+        tiles[m] = data->findSlotTexture(name, name);
+        if (tiles[m] && tileSize.x == 0) {
+            tileSize = tiles[m]->getSize();
+        }
+    }
+    if (tileSize.x == 0) {
+        return;
+    }
+
+    if (radarAtlas == 0) {
+        glGenTextures(1, &radarAtlas);
+    }
+    const auto atlasSize = tileSize * kMapBlockLine;
+    glBindTexture(GL_TEXTURE_2D, radarAtlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasSize.x, atlasSize.y, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Blit each tile into place, scaling any that are a different size
+    GLint lastRead = 0, lastDraw = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &lastRead);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &lastDraw);
+
+    GLuint framebuffers[2];
+    glGenFramebuffers(2, framebuffers);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, radarAtlas, 0);
+    // Missing tiles are left transparent
+    const GLfloat clear[] = {0.f, 0.f, 0.f, 0.f};
+    glClearBufferfv(GL_COLOR, 0, clear);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+    for (int m = 0; m < MAP_BLOCK_SIZE; ++m) {
+        if (!tiles[m]) {
+            continue;
+        }
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, tiles[m]->getName(), 0);
+        const auto& size = tiles[m]->getSize();
+        const auto x = (m % kMapBlockLine) * tileSize.x;
+        const auto y = (m / kMapBlockLine) * tileSize.y;
+        glBlitFramebuffer(0, 0, size.x, size.y, x, y, x + tileSize.x,
+                          y + tileSize.y, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(lastRead));
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(lastDraw));
+    glDeleteFramebuffers(2, framebuffers);
+
+    // The tiles are contiguous, so the mip levels can cross them
+    glBindTexture(GL_TEXTURE_2D, radarAtlas);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    /// @TODO migrate to using the renderer
+    renderer.invalidate();
+}
 
 void MapRenderer::draw(GameWorld* world, const MapInfo& mi) {
+    if (radarAtlas == 0) {
+        loadRadarAtlas();
+    }
+
     renderer.pushDebugGroup("Map");
     renderer.useProgram(rectProg.get());
 
@@ -81,15 +211,11 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi) {
     dp.blendMode = BlendMode::BLEND_ALPHA;
     dp.depthWrite = false;
 
-    // World out the number of units per tile
-    glm::vec2 worldSize(GAME_MAP_SIZE);
-    const int mapBlockLine = 8;
-    glm::vec2 tileSize = worldSize / static_cast<float>(mapBlockLine);
     // Determine the scale to show the right number of world units on the screen
     float worldScale = mi.screenSize / mi.worldSize;
 
     auto proj = renderer.get2DProjection();
-    glm::mat4 view{1.0f}, model{1.0f};
+    glm::mat4 view{1.0f};
     renderer.setUniform(rectProg.get(), "proj", proj);
     renderer.setUniform(rectProg.get(), "model", glm::mat4(1.0f));
     renderer.setUniform(rectProg.get(), "colour", glm::vec4(0.f, 0.f, 0.f, 1.f));
@@ -114,66 +240,25 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi) {
     view = glm::rotate(view, mi.rotation, glm::vec3(0.f, 0.f, 1.f));
     view = glm::translate(
         view, glm::vec3(glm::vec2(-1.f, 1.f) * mi.worldCenter, 0.f));
-    renderer.setUniform(rectProg.get(), "view", view);
-
-    // radar00 = -x, +y
-    // incrementing in X, then Y
-
-    int initX = -(mapBlockLine / 2);
-    int initY = -(mapBlockLine / 2);
-
-    for (int m = 0; m < MAP_BLOCK_SIZE; ++m) {
-        std::string num = (m < 10 ? "0" : "");
-        std::string name = "radar" + num + std::to_string(m);
-        auto texturePtr = world->data->findSlotTexture(name, name);
-        dp.textures = {{texturePtr->getName()}};
-
-        dp.count = 4;
-
-        int mX = initX + (m % mapBlockLine);
-        int mY = initY + (m / mapBlockLine);
-
-        auto tc = glm::vec2(mX, mY) * tileSize + glm::vec2(tileSize / 2.f);
-
-        glm::mat4 tilemodel = model;
-        tilemodel = glm::translate(tilemodel, glm::vec3(tc, 0.f));
-        tilemodel = glm::scale(tilemodel, glm::vec3(tileSize, 1.f));
-
-        renderer.setUniform(rectProg.get(), "model", tilemodel);
-
-        renderer.drawArrays(glm::mat4(1.0f), &rect, dp);
-    }
-
-    // From here on out we will work in screenspace
-    renderer.setUniform(rectProg.get(), "view", glm::mat4(1.0f));
 
-    if (mi.clipToSize) {
-        glDisable(GL_STENCIL_TEST);
-        // We only need the outer ring if we're clipping.
-        glBlendFuncSeparate(GL_DST_COLOR, GL_ZERO, GL_ONE, GL_ZERO);
-        auto radarDiscTexPtr = data->findSlotTexture("hud", "radardisc");
-        dp.textures = {{radarDiscTexPtr->getName()}};
+    batchVertices.clear();
+    blipQuads.clear();
+    outlineVertices.clear();
 
-        glm::mat4 model{1.0f};
-        model = glm::translate(model, glm::vec3(mi.screenPosition, 0.0f));
-        model = glm::scale(model, glm::vec3(mi.screenSize * 1.07f));
-        renderer.setUniform(rectProg.get(), "model", model);
-        renderer.drawArrays(glm::mat4(1.0f), &rect, dp);
-        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
-                            GL_ZERO);
-    }
+    addTiles(view, mi);
+    const auto tileCount = batchVertices.size();
 
     // Draw the player blip
     auto player = world->pedestrianPool.find(world->state->playerObject);
     if (player) {
         glm::vec2 plyblip(player->getPosition());
         float hdg = glm::roll(player->getRotation());
-        drawBlip(plyblip, view, mi, "radar_centre",
-                 glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), defaultBlipSize, mi.rotation - hdg);
+        addBlip(plyblip, view, mi, "radar_centre",
+                glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), defaultBlipSize, mi.rotation - hdg);
     }
 
-    drawBlip(mi.worldCenter + glm::vec2(0.f, mi.worldSize), view, mi,
-             "radar_north", glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), radarNorthBlipSize);
+    addBlip(mi.worldCenter + glm::vec2(0.f, mi.worldSize), view, mi,
+            "radar_north", glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), radarNorthBlipSize);
 
     for (auto& radarBlip : world->state->radarBlips) {
         const auto& blip = radarBlip.second;
@@ -193,8 +278,8 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi) {
 
         const auto& texture = blip.texture;
         if (!texture.empty()) {
-            drawBlip(blippos, view, mi, texture,
-                     glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), defaultBlipSize);
+            addBlip(blippos, view, mi, texture,
+                    glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), defaultBlipSize);
         } else {
             // Colours from http://www.gtamodding.com/wiki/0165 (colors not
             // specific to that opcode!)
@@ -232,18 +317,145 @@ void MapRenderer::draw(GameWorld* world, const MapInfo& mi) {
                              1.0f  // Note: Alpha is not controlled by blip
                              );
 
-            drawBlip(blippos, view, mi, colour, blip.size * hudScale * 2.0f);
+            addBlip(blippos, view, mi, colour, blip.size * hudScale * 2.0f);
         }
     }
 
+    // Blips sharing a texture are drawn together, in the order they were
+    // added
+    std::stable_sort(blipQuads.begin(), blipQuads.end(),
+                     [](const BlipQuad& a, const BlipQuad& b) {
+                         return a.texture < b.texture;
+                     });
+    for (const auto& quad : blipQuads) {
+        batchVertices.insert(batchVertices.end(), quad.vertices.begin(),
+                             quad.vertices.end());
+    }
+    const auto outlineStart = batchVertices.size();
+    batchVertices.insert(batchVertices.end(), outlineVertices.begin(),
+                         outlineVertices.end());
+
+    if (batchVertices.empty()) {
+        if (mi.clipToSize) {
+            glDisable(GL_STENCIL_TEST);
+        }
+        renderer.invalidate();
+        renderer.popDebugGroup();
+        return;
+    }
+
+    batchGeom.streamVertices(batchVertices);
+    batchDraw.addGeometryOnce({&batchGeom});
+    outlineDraw.addGeometryOnce({&batchGeom});
+
+    renderer.useProgram(batchProg.get());
+    renderer.setUniform(batchProg.get(), "proj", proj);
+    renderer.setUniformTexture(batchProg.get(), "spriteTexture", 0);
+
+    if (tileCount > 0) {
+        dp.start = 0;
+        dp.count = tileCount;
+        dp.textures = {{radarAtlas}};
+        renderer.drawArrays(glm::mat4(1.0f), &batchDraw, dp);
+    }
+
+    if (mi.clipToSize) {
+        glDisable(GL_STENCIL_TEST);
+        // We only need the outer ring if we're clipping.
+        renderer.useProgram(rectProg.get());
+        renderer.setUniform(rectProg.get(), "view", glm::mat4(1.0f));
+        glBlendFuncSeparate(GL_DST_COLOR, GL_ZERO, GL_ONE, GL_ZERO);
+        auto radarDiscTexPtr = data->findSlotTexture("hud", "radardisc");
+        dp.textures = {{radarDiscTexPtr->getName()}};
+        dp.start = 0;
+        dp.count = 4;
+
+        glm::mat4 model{1.0f};
+        model = glm::translate(model, glm::vec3(mi.screenPosition, 0.0f));
+        model = glm::scale(model, glm::vec3(mi.screenSize * 1.07f));
+        renderer.setUniform(rectProg.get(), "model", model);
+        renderer.drawArrays(glm::mat4(1.0f), &rect, dp);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                            GL_ZERO);
+
+        renderer.useProgram(batchProg.get());
+    }
+
+    for (std::size_t i = 0; i < blipQuads.size();) {
+        auto end = i + 1;
+        while (end < blipQuads.size() &&
+               blipQuads[end].texture == blipQuads[i].texture) {
+            ++end;
+        }
+        dp.start = tileCount + i * 6;
+        dp.count = (end - i) * 6;
+        dp.textures = {{blipQuads[i].texture}};
+        renderer.drawArrays(glm::mat4(1.0f), &batchDraw, dp);
+        i = end;
+    }
+
+    if (!outlineVertices.empty()) {
+        dp.start = outlineStart;
+        dp.count = outlineVertices.size();
+        dp.textures = {{0}};
+        renderer.drawArrays(glm::mat4(1.0f), &outlineDraw, dp);
+    }
+
     /// @TODO migrate to using the renderer
     renderer.invalidate();
     renderer.popDebugGroup();
 }
 
-void MapRenderer::prepareBlip(const glm::vec2& coord, const glm::mat4& view,
-                              const MapInfo& mi, const std::string& texture,
-                              glm::vec4 colour, float size, float heading) {
+void MapRenderer::addTiles(const glm::mat4& view, const MapInfo& mi) {
+    if (radarAtlas == 0) {
+        return;
+    }
+
+    // The part of the screen the map covers
+    glm::vec2 screenMin{0.f};
+    glm::vec2 screenMax{renderer.getViewport()};
+    if (mi.clipToSize) {
+        screenMin = mi.screenPosition - glm::vec2(mi.screenSize / 2.f);
+        screenMax = mi.screenPosition + glm::vec2(mi.screenSize / 2.f);
+    }
+
+    // Find its bounds on the map, which is the world with Y flipped
+    const auto screenToMap = glm::inverse(view);
+    glm::vec2 mapMin{std::numeric_limits<float>::max()};
+    glm::vec2 mapMax{std::numeric_limits<float>::lowest()};
+    for (const auto& corner :
+         {screenMin, glm::vec2(screenMax.x, screenMin.y), screenMax,
+          glm::vec2(screenMin.x, screenMax.y)}) {
+        glm::vec2 p(screenToMap * glm::vec4(corner, 0.f, 1.f));
+        mapMin = glm::min(mapMin, p);
+        mapMax = glm::max(mapMax, p);
+    }
+
+    // Cover the visible tiles
+    const float tileSize = kMapSize / kMapBlockLine;
+    const auto half = kMapSize / 2.f;
+    mapMin = glm::max(glm::floor(mapMin / tileSize) * tileSize, glm::vec2(-half));
+    mapMax = glm::min(glm::ceil(mapMax / tileSize) * tileSize, glm::vec2(half));
+    if (mapMin.x >= mapMax.x || mapMin.y >= mapMax.y) {
+        return;
+    }
+
+    const glm::vec4 colour{0.f, 0.f, 0.f, 1.f};
+    auto vertex = [&](float x, float y) {
+        glm::vec2 screen(view * glm::vec4(x, y, 0.f, 1.f));
+        glm::vec2 uv = (glm::vec2(x, y) + half) / kMapSize;
+        return MapVertex{screen, uv, colour};
+    };
+    const auto v0 = vertex(mapMin.x, mapMin.y);
+    const auto v1 = vertex(mapMax.x, mapMin.y);
+    const auto v2 = vertex(mapMax.x, mapMax.y);
+    const auto v3 = vertex(mapMin.x, mapMax.y);
+    batchVertices.insert(batchVertices.end(), {v0, v1, v2, v0, v2, v3});
+}
+
+void MapRenderer::addBlip(const glm::vec2& coord, const glm::mat4& view,
+                          const MapInfo& mi, const std::string& texture,
+                          glm::vec4 colour, float size, float heading) {
     glm::vec2 adjustedCoord = coord;
     if (mi.clipToSize) {
         float maxDist = mi.worldSize / 2.f;
@@ -254,40 +466,47 @@ void MapRenderer::prepareBlip(const glm::vec2& coord, const glm::mat4& view,
         }
     }
 
-    glm::vec3 viewPos(
+    glm::vec2 viewPos(
         view * glm::vec4(glm::vec2(1.f, -1.f) * adjustedCoord, 0.f, 1.f));
     glm::mat4 model{1.0f};
-    model = glm::translate(model, viewPos);
+    model = glm::translate(model, glm::vec3(viewPos, 0.f));
     model = glm::scale(model, glm::vec3(size));
     model = glm::rotate(model, heading, glm::vec3(0.f, 0.f, 1.f));
-    renderer.setUniform(rectProg.get(), "model", model);
 
     GLuint tex = 0;
     if (!texture.empty()) {
         auto spriteTexPtr = data->findSlotTexture("hud", texture);
         tex = spriteTexPtr->getName();
     }
-    renderer.setUniform(rectProg.get(), "colour", colour);
-
-    glBindTexture(GL_TEXTURE_2D, tex);
 
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-}
+    std::array<MapVertex, 4> corners;
+    const glm::vec2 offsets[] = {
+        {-.5f, -.5f}, {.5f, -.5f}, {.5f, .5f}, {-.5f, .5f}};
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+        corners[i] = MapVertex{
+            glm::vec2(model * glm::vec4(offsets[i], 0.f, 1.f)),
+            (offsets[i] + glm::vec2(.5f)) * kBlipTexCoordScale, colour};
+    }
 
-void MapRenderer::drawBlip(const glm::vec2& coord, const glm::mat4& view,
-                           const MapInfo& mi, const std::string& texture,
-                           glm::vec4 colour, float size, float heading) {
-    prepareBlip(coord, view, mi, texture, colour, size, heading);
-    glBindVertexArray(rect.getVAOName());
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    blipQuads.push_back({tex,
+                         {corners[0], corners[1], corners[2], corners[0],
+                          corners[2], corners[3]}});
 }
 
-void MapRenderer::drawBlip(const glm::vec2& coord, const glm::mat4& view,
-                           const MapInfo& mi, glm::vec4 colour, float size) {
-    drawBlip(coord, view, mi, "", colour, size);
-    // Draw outline
-    renderer.setUniform(rectProg.get(), "colour", glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-    glDrawArrays(GL_LINE_LOOP, 0, 4);
+void MapRenderer::addBlip(const glm::vec2& coord, const glm::mat4& view,
+                          const MapInfo& mi, glm::vec4 colour, float size) {
+    addBlip(coord, view, mi, "", colour, size);
+
+    // Outline the quad that was just added
+    const auto& quad = blipQuads.back().vertices;
+    const glm::vec4 black{0.0f, 0.0f, 0.0f, 1.0f};
+    const MapVertex* corners[] = {&quad[0], &quad[1], &quad[2], &quad[5]};
+    for (std::size_t i = 0; i < 4; ++i) {
+        const auto& a = *corners[i];
+        const auto& b = *corners[(i + 1) % 4];
+        outlineVertices.emplace_back(a.position, a.texcoord, black);
+        outlineVertices.emplace_back(b.position, b.texcoord, black);
+    }
 }
 
 void MapRenderer::scaleHUD(const float scale) {
@@ -1,8 +1,11 @@
 #ifndef _RWENGINE_MAPRENDERER_HPP_
 #define _RWENGINE_MAPRENDERER_HPP_
 
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <gl/DrawBuffer.hpp>
 #include <gl/GeometryBuffer.hpp>
@@ -16,6 +19,10 @@ class GameWorld;
 
 /**
  * Utility class for rendering the world map, in the menu and radar.
+ *
+ * The radar tiles are copied into a single atlas texture, so the visible part
+ * of the map is drawn as one quad. The map and its blips are written to one
+ * vertex buffer each frame and drawn with a call per blip texture.
  */
 class MapRenderer {
 public:
@@ -35,14 +42,54 @@ public:
     };
 
     MapRenderer(Renderer& renderer, GameData* data);
+    ~MapRenderer();
+
+    MapRenderer(const MapRenderer&) = delete;
+    MapRenderer& operator=(const MapRenderer&) = delete;
+
+    /**
+     * Copies the loaded radar tiles into the atlas. Called once the radar
+     * texture dictionaries are loaded, otherwise the first draw() builds it.
+     */
+    void loadRadarAtlas();
 
     void draw(GameWorld* world, const MapInfo& mi);
     void scaleHUD(const float scale);
 
 private:
+    struct MapVertex {
+        glm::vec2 position;
+        glm::vec2 texcoord;
+        glm::vec4 colour;
+
+        MapVertex(glm::vec2 _position, glm::vec2 _texcoord,
+                  glm::vec4 _colour)
+            : position(_position), texcoord(_texcoord), colour(_colour) {
+        }
+
+        MapVertex() = default;
+
+        static const AttributeList vertex_attributes() {
+            return {
+                {ATRS_Position, 2, sizeof(MapVertex), 0ul},
+                {ATRS_TexCoord, 2, sizeof(MapVertex),
+                 0ul + sizeof(glm::vec2)},
+                {ATRS_Colour, 4, sizeof(MapVertex),
+                 0ul + sizeof(glm::vec2) * 2},
+            };
+        }
+    };
+
+    struct BlipQuad {
+        GLuint texture;
+        std::array<MapVertex, 6> vertices;
+    };
+
     GameData* data;
     Renderer& renderer;
 
+    GLuint radarAtlas = 0;
+
     GeometryBuffer rectGeom;
     DrawBuffer rect;
 
@@ -54,15 +101,26 @@ private:
     float hudScale = 1.f;
 
     std::unique_ptr<Renderer::ShaderProgram> rectProg;
-
-    void prepareBlip(const glm::vec2& coord, const glm::mat4& view,
-                     const MapInfo& mi, const std::string& texture,
-                     glm::vec4 colour, float size, float heading);
-    void drawBlip(const glm::vec2& coord, const glm::mat4& view,
-                  const MapInfo& mi, const std::string& texture,
-                  glm::vec4 colour, float size, float heading = 0.0f);
-    void drawBlip(const glm::vec2& coord, const glm::mat4& view,
-                  const MapInfo& mi, glm::vec4 colour, float size);
+    std::unique_ptr<Renderer::ShaderProgram> batchProg;
+
+    /// Map tiles, blips and blip outlines, in screen space
+    std::vector<MapVertex> batchVertices;
+    std::vector<BlipQuad> blipQuads;
+    std::vector<MapVertex> outlineVertices;
+    GeometryBuffer batchGeom;
+    DrawBuffer batchDraw;
+    DrawBuffer outlineDraw;
+
+    /**
+     * Adds a quad covering the radar tiles that are visible on the map
+     */
+    void addTiles(const glm::mat4& view, const MapInfo& mi);
+
+    void addBlip(const glm::vec2& coord, const glm::mat4& view,
+                 const MapInfo& mi, const std::string& texture,
+                 glm::vec4 colour, float size, float heading = 0.0f);
+    void addBlip(const glm::vec2& coord, const glm::mat4& view,
+                 const MapInfo& mi, glm::vec4 colour, float size);
 };
 
 #endif
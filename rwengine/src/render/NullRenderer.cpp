@@ -0,0 +1,308 @@
+#include "render/NullRenderer.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <utility>
+
+#include <core/Profiler.hpp>
+
+namespace {
+const char* blendModeName(BlendMode mode) {
+    switch (mode) {
+        case BlendMode::BLEND_NONE:
+            return "none";
+        case BlendMode::BLEND_ALPHA:
+            return "alpha";
+        case BlendMode::BLEND_ADDITIVE:
+            return "additive";
+    }
+    return "unknown";
+}
+
+const char* depthModeName(DepthMode mode) {
+    switch (mode) {
+        case DepthMode::OFF:
+            return "off";
+        case DepthMode::LESS:
+            return "less";
+    }
+    return "unknown";
+}
+}  // namespace
+
+NullRenderer::NullRenderer() {
+    swap();
+}
+
+std::string NullRenderer::getIDString() const {
+    return "Null Renderer";
+}
+
+std::unique_ptr<Renderer::ShaderProgram> NullRenderer::createShader(
+    const std::string&, const std::string&) {
+    auto program = std::make_unique<NullShaderProgram>(++programCount);
+    record("createShader " + std::to_string(program->id));
+    return program;
+}
+
+void NullRenderer::setProgramBlockBinding(Renderer::ShaderProgram* p,
+                                          const std::string& name,
+                                          GLint point) {
+    auto program = static_cast<NullShaderProgram*>(p);
+    record("blockBinding " + std::to_string(program->id) + " " + name + " " +
+           std::to_string(point));
+}
+
+void NullRenderer::setUniformTexture(Renderer::ShaderProgram* p,
+                                     const std::string& name, GLint tex) {
+    useProgram(p);
+    stats.stateChanges++;
+    record("uniformTexture " + name + " " + std::to_string(tex));
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram* p,
+                              const std::string& name, const glm::mat4&) {
+    useProgram(p);
+    stats.stateChanges++;
+    record("uniform " + name);
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram* p,
+                              const std::string& name, const glm::vec4&) {
+    useProgram(p);
+    stats.stateChanges++;
+    record("uniform " + name);
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram* p,
+                              const std::string& name, const glm::vec3&) {
+    useProgram(p);
+    stats.stateChanges++;
+    record("uniform " + name);
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram* p,
+                              const std::string& name, const glm::vec2&) {
+    useProgram(p);
+    stats.stateChanges++;
+    record("uniform " + name);
+}
+
+void NullRenderer::setUniform(Renderer::ShaderProgram* p,
+                              const std::string& name, float) {
+    useProgram(p);
+    stats.stateChanges++;
+    record("uniform " + name);
+}
+
+void NullRenderer::useProgram(Renderer::ShaderProgram* p) {
+    if (p != currentProgram) {
+        currentProgram = static_cast<NullShaderProgram*>(p);
+        stats.stateChanges++;
+        if (recording) {
+            record("useProgram " + std::to_string(currentProgram->id));
+        }
+    }
+}
+
+void NullRenderer::clear(const glm::vec4&, bool clearColour, bool clearDepth) {
+    std::string command = "clear";
+    if (clearColour) {
+        command += " colour";
+    }
+    if (clearDepth) {
+        command += " depth";
+    }
+    record(std::move(command));
+}
+
+void NullRenderer::setSceneParameters(const Renderer::SceneUniformData& data) {
+    uploadUniforms(sizeof(SceneUniformData));
+    lastSceneData = data;
+    record("scene");
+}
+
+void NullRenderer::useDrawBuffer(DrawBuffer* dbuff) {
+    if (dbuff != currentDbuff) {
+        currentDbuff = dbuff;
+        bufferCounter++;
+        stats.bufferBinds++;
+        stats.stateChanges++;
+    }
+}
+
+void NullRenderer::useTexture(GLuint unit, GLuint tex) {
+    if (currentTextures[unit] != tex) {
+        currentTextures[unit] = tex;
+        textureCounter++;
+        stats.textureBinds++;
+    }
+}
+
+void NullRenderer::setDrawParameters(DrawBuffer* draw,
+                                     const Renderer::DrawParameters& p) {
+    useDrawBuffer(draw);
+
+    if (p.textureArray != 0) {
+        useTexture(kTextureArrayUnit, p.textureArray);
+    } else {
+        for (GLuint u = 0; u < p.textures.size(); ++u) {
+            useTexture(u, p.textures[u]);
+        }
+    }
+
+    if (p.blendMode != blendMode) {
+        blendMode = p.blendMode;
+        stats.stateChanges++;
+    }
+    if (p.depthWrite != depthWriteEnabled) {
+        depthWriteEnabled = p.depthWrite;
+        stats.stateChanges++;
+    }
+    if (p.depthMode != depthMode) {
+        depthMode = p.depthMode;
+        stats.stateChanges++;
+    }
+}
+
+void NullRenderer::uploadUniforms(std::size_t bytes) {
+    stats.uniformUploads++;
+    stats.uniformBytes += bytes;
+}
+
+void NullRenderer::submitDraw(const char* command, DrawBuffer* draw,
+                              const Renderer::DrawParameters& p,
+                              std::size_t instances) {
+    drawCounter++;
+    stats.draws++;
+    stats.instances += instances;
+    stats.primitives += p.count * instances;
+
+    if (!recording) {
+        return;
+    }
+
+    std::ostringstream ss;
+    ss << command << " buffer=" << getBufferID(draw) << " start=" << p.start
+       << " count=" << p.count << " instances=" << instances
+       << " textures=" << p.textures[0] << "," << p.textures[1]
+       << " array=" << p.textureArray << " layer=" << p.layer
+       << " blend=" << blendModeName(p.blendMode)
+       << " depth=" << depthModeName(p.depthMode)
+       << " write=" << p.depthWrite << " colour="
+       << static_cast<int>(p.colour.r) << "," << static_cast<int>(p.colour.g)
+       << "," << static_cast<int>(p.colour.b) << ","
+       << static_cast<int>(p.colour.a) << " visibility=" << p.visibility;
+    commands.push_back(ss.str());
+}
+
+void NullRenderer::draw(const glm::mat4&, DrawBuffer* draw,
+                        const Renderer::DrawParameters& p) {
+    setDrawParameters(draw, p);
+    uploadUniforms(sizeof(ObjectUniformData));
+    submitDraw("draw", draw, p, 1);
+}
+
+void NullRenderer::drawArrays(const glm::mat4&, DrawBuffer* draw,
+                              const Renderer::DrawParameters& p) {
+    setDrawParameters(draw, p);
+    uploadUniforms(sizeof(ObjectUniformData));
+    submitDraw("drawArrays", draw, p, 1);
+}
+
+void NullRenderer::drawArraysInstanced(DrawBuffer* draw,
+                                       const Renderer::DrawParameters& p,
+                                       std::size_t instances) {
+    setDrawParameters(draw, p);
+    submitDraw("drawArraysInstanced", draw, p, instances);
+}
+
+void NullRenderer::drawBatched(const RenderList& list) {
+    RW_PROFILE_SCOPE(__func__);
+    stats.renderListLength += list.size();
+
+    // Batched the same way as OpenGLRenderer, so the counts match
+    constexpr auto kBatchSize = OpenGLRenderer::kMaxBatchObjects;
+    for (std::size_t b = 0; b < list.size(); b += kBatchSize) {
+        const auto end = std::min(list.size(), b + kBatchSize);
+
+        uploadUniforms((end - b) * sizeof(ObjectUniformData));
+        if (recording) {
+            record("uploadObjects " + std::to_string(end - b));
+        }
+
+        for (auto i = b; i < end;) {
+            const auto& ri = list[i];
+            std::size_t instances = 1;
+            while (i + instances < end && canInstance(ri, list[i + instances])) {
+                instances++;
+            }
+
+            setDrawParameters(ri.dbuff, ri.drawInfo);
+            submitDraw("drawInstanced", ri.dbuff, ri.drawInfo, instances);
+
+            i += instances;
+        }
+    }
+}
+
+void NullRenderer::invalidate() {
+    currentDbuff = nullptr;
+    currentProgram = nullptr;
+    currentTextures.clear();
+    blendMode = BlendMode::BLEND_NONE;
+    depthMode = DepthMode::OFF;
+    record("invalidate");
+}
+
+void NullRenderer::pushDebugGroup(const std::string& title) {
+    debugGroups.push_back(stats);
+    record("push " + title);
+}
+
+const Renderer::ProfileInfo& NullRenderer::popDebugGroup() {
+    if (debugGroups.empty()) {
+        return lastProfile;
+    }
+
+    const auto& start = debugGroups.back();
+    lastProfile = {};
+    lastProfile.draws = static_cast<unsigned int>(stats.draws - start.draws);
+    lastProfile.primitives =
+        static_cast<unsigned int>(stats.primitives - start.primitives);
+    lastProfile.textures =
+        static_cast<unsigned int>(stats.textureBinds - start.textureBinds);
+    lastProfile.buffers =
+        static_cast<unsigned int>(stats.bufferBinds - start.bufferBinds);
+    lastProfile.uploads =
+        static_cast<unsigned int>(stats.uniformUploads - start.uniformUploads);
+    debugGroups.pop_back();
+
+    record("pop");
+    return lastProfile;
+}
+
+void NullRenderer::setRecording(bool record) {
+    if (record && !recording) {
+        commands.clear();
+        bufferIDs.clear();
+    }
+    recording = record;
+}
+
+void NullRenderer::dumpCommands(std::ostream& out) const {
+    for (const auto& command : commands) {
+        out << command << '\n';
+    }
+}
+
+void NullRenderer::record(std::string command) {
+    if (recording) {
+        commands.push_back(std::move(command));
+    }
+}
+
+std::size_t NullRenderer::getBufferID(DrawBuffer* dbuff) {
+    return bufferIDs.emplace(dbuff, bufferIDs.size() + 1).first->second;
+}
@@ -0,0 +1,166 @@
+#ifndef _RWENGINE_NULLRENDERER_HPP_
+#define _RWENGINE_NULLRENDERER_HPP_
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <render/OpenGLRenderer.hpp>
+
+/**
+ * @brief Renderer that makes no GL calls
+ *
+ * Keeps the same state cache as OpenGLRenderer and counts the work it would
+ * have sent to the GPU, so that building, sorting and batching render lists
+ * can be measured without a context.
+ *
+ * The commands can also be recorded as text, one line each, to compare the
+ * frames produced by two versions.
+ */
+class NullRenderer final : public Renderer {
+public:
+    /**
+     * Totals since the last call to resetStatistics()
+     */
+    struct Statistics {
+        /// Draw calls, an instanced draw only counts once
+        std::size_t draws = 0;
+        /// Objects drawn by all draw calls
+        std::size_t instances = 0;
+        /// Indices drawn, including each instance
+        std::size_t primitives = 0;
+        /// Program, buffer, blend and depth changes
+        std::size_t stateChanges = 0;
+        /// Vertex array changes, also counted as state changes
+        std::size_t bufferBinds = 0;
+        std::size_t textureBinds = 0;
+        std::size_t uniformUploads = 0;
+        std::size_t uniformBytes = 0;
+        /// Instructions passed to drawBatched()
+        std::size_t renderListLength = 0;
+    };
+
+    class NullShaderProgram final : public ShaderProgram {
+    public:
+        explicit NullShaderProgram(std::size_t id) : id(id) {
+        }
+
+        /// Identifies the program in recorded commands
+        const std::size_t id;
+    };
+
+    NullRenderer();
+
+    ~NullRenderer() override = default;
+
+    std::string getIDString() const override;
+
+    std::unique_ptr<ShaderProgram> createShader(const std::string& vert,
+                                                const std::string& frag) override;
+    void setProgramBlockBinding(ShaderProgram* p, const std::string& name,
+                                GLint point) override;
+    void setUniformTexture(ShaderProgram* p, const std::string& name,
+                           GLint tex) override;
+    void setUniform(ShaderProgram* p, const std::string& name,
+                    const glm::mat4& m) override;
+    void setUniform(ShaderProgram* p, const std::string& name,
+                    const glm::vec4& m) override;
+    void setUniform(ShaderProgram* p, const std::string& name,
+                    const glm::vec3& m) override;
+    void setUniform(ShaderProgram* p, const std::string& name,
+                    const glm::vec2& m) override;
+    void setUniform(ShaderProgram* p, const std::string& name,
+                    float f) override;
+    void useProgram(ShaderProgram* p) override;
+
+    void clear(const glm::vec4& colour, bool clearColour = true,
+               bool clearDepth = true) override;
+
+    void setSceneParameters(const SceneUniformData& data) override;
+
+    void draw(const glm::mat4& model, DrawBuffer* draw,
+              const DrawParameters& p) override;
+    void drawArrays(const glm::mat4& model, DrawBuffer* draw,
+                    const DrawParameters& p) override;
+    void drawArraysInstanced(DrawBuffer* draw, const DrawParameters& p,
+                             std::size_t instances) override;
+
+    void drawBatched(const RenderList& list) override;
+
+    void invalidate() override;
+
+    void pushDebugGroup(const std::string& title) override;
+
+    const ProfileInfo& popDebugGroup() override;
+
+    const Statistics& getStatistics() const {
+        return stats;
+    }
+
+    void resetStatistics() {
+        stats = {};
+    }
+
+    /**
+     * Starts or stops recording commands, starting clears the previous
+     * recording
+     */
+    void setRecording(bool record);
+
+    bool isRecording() const {
+        return recording;
+    }
+
+    const std::vector<std::string>& getCommands() const {
+        return commands;
+    }
+
+    /**
+     * Writes the recorded commands, one per line
+     */
+    void dumpCommands(std::ostream& out) const;
+
+private:
+    void useDrawBuffer(DrawBuffer* dbuff);
+
+    void useTexture(GLuint unit, GLuint tex);
+
+    void setDrawParameters(DrawBuffer* draw, const DrawParameters& p);
+
+    void uploadUniforms(std::size_t bytes);
+
+    /// Counts and records a draw of instances objects
+    void submitDraw(const char* command, DrawBuffer* draw,
+                    const DrawParameters& p, std::size_t instances);
+
+    void record(std::string command);
+
+    /// Numbers draw buffers in the order they are first seen, so that
+    /// recordings don't depend on addresses
+    std::size_t getBufferID(DrawBuffer* dbuff);
+
+    Statistics stats;
+
+    // State Cache
+    DrawBuffer* currentDbuff = nullptr;
+    NullShaderProgram* currentProgram = nullptr;
+    BlendMode blendMode = BlendMode::BLEND_NONE;
+    DepthMode depthMode = DepthMode::OFF;
+    bool depthWriteEnabled = false;
+    std::unordered_map<GLuint, GLuint> currentTextures;
+
+    std::size_t programCount = 0;
+
+    bool recording = false;
+    std::vector<std::string> commands;
+    std::unordered_map<DrawBuffer*, std::size_t> bufferIDs;
+
+    /// Statistics when each open debug group was pushed
+    std::vector<Statistics> debugGroups;
+    ProfileInfo lastProfile;
+};
+
+#endif
@@ -1,8 +1,11 @@
 #include "render/ObjectRenderer.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 #include <BulletDynamics/Vehicle/btRaycastVehicle.h>
+#include <glm/common.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <data/Clump.hpp>
@@ -12,6 +15,8 @@
 #include "engine/GameData.hpp"
 #include "engine/GameState.hpp"
 #include "engine/GameWorld.hpp"
+#include "engine/StaticInstanceGrid.hpp"
+#include "render/LodCellMeshes.hpp"
 #include "render/ViewCamera.hpp"
 
 // Objects that we know how to turn into renderlist entries
@@ -35,9 +40,12 @@ constexpr float kMagicLODDistance = 330.f;
 constexpr float kVehicleLODDistance = 70.f;
 constexpr float kVehicleDrawDistance = 280.f;
 
-RenderKey createKey(float normalizedDepth, Renderer::Textures& textures) {
+RenderKey createKey(float normalizedDepth,
+                    const Renderer::DrawParameters& dp) {
+    const auto texture =
+        dp.textureArray != 0 ? dp.textureArray : dp.textures[0];
     return (uint32_t(0x7FFFFF * normalizedDepth) << 8 |
-            uint8_t(0xFF & (!textures.empty() ? textures[0] : 0)));
+            uint8_t(0xFF & texture));
 }
 
 void ObjectRenderer::renderGeometry(Geometry* geom,
@@ -70,6 +78,8 @@ void ObjectRenderer::renderGeometry(Geometry* geom,
                         isTransparent = true;
                     }
                     dp.textures = {{tex->getName()}};
+                    dp.textureArray = tex->getArrayName();
+                    dp.layer = static_cast<float>(tex->getLayer());
                 }
             }
 
@@ -105,7 +115,7 @@ void ObjectRenderer::renderGeometry(Geometry* geom,
         float distance = glm::length(m_camera.position - position);
         float depth = (distance - m_camera.frustum.near) /
                       (m_camera.frustum.far - m_camera.frustum.near);
-        outList.emplace_back(createKey(depth * depth, dp.textures), modelMatrix,
+        outList.emplace_back(createKey(depth * depth, dp), modelMatrix,
                              &geom->dbuff, dp);
     }
 }
@@ -362,3 +372,69 @@ void ObjectRenderer::buildRenderList(GameObject* object, RenderList& outList) {
             break;
     }
 }
+
+void ObjectRenderer::gatherVisibleInstances(const StaticInstanceGrid& grid,
+                                            const LodCellMeshes* lods,
+                                            std::vector<GameObject*>& objects,
+                                            RenderList& outList) {
+    // Closer than this, big buildings may be replaced by their detailed
+    // models, see renderInstance
+    const auto mergeDistance =
+        lods && lods->isEnabled()
+            ? std::max(lods->getDistance(),
+                       kMagicLODDistance * kDrawDistanceFactor)
+            : std::numeric_limits<float>::max();
+
+    const auto& cells = grid.getCells();
+    for (std::size_t c = 0; c < cells.size(); ++c) {
+        const auto& cell = cells[c];
+        if (cell.instances.empty()) {
+            continue;
+        }
+
+        // Every instance is at least as far away as the closest point of the
+        // box around their positions, see renderInstance
+        const auto closest = glm::clamp(m_camera.position, cell.min, cell.max);
+        const auto distance = glm::length(closest - m_camera.position);
+        if (distance > cell.lodDistance * kDrawDistanceFactor ||
+            !m_camera.frustum.intersects(cell.center, cell.radius)) {
+            culledCells++;
+            culledInstances += cell.instances.size();
+            culled += cell.instances.size();
+            continue;
+        }
+
+        auto mesh = distance > mergeDistance ? lods->getMesh(c) : nullptr;
+        if (!mesh) {
+            objects.insert(objects.end(), cell.instances.begin(),
+                           cell.instances.end());
+            continue;
+        }
+
+        mergedCells++;
+        objects.insert(objects.end(), mesh->others.begin(),
+                       mesh->others.end());
+        renderCellMesh(*mesh, distance, outList);
+    }
+}
+
+void ObjectRenderer::renderCellMesh(LodCellMeshes::CellMesh& mesh,
+                                    float distance, RenderList& outList) {
+    // The same draw distance as renderInstance gives the merged instances
+    if (distance / kDrawDistanceFactor > mesh.lodDistance) {
+        culled += mesh.merged;
+        return;
+    }
+    if (!m_camera.frustum.intersects(mesh.center, mesh.radius)) {
+        culled += mesh.merged;
+        return;
+    }
+
+    const auto centerDistance = glm::length(m_camera.position - mesh.center);
+    const auto depth = (centerDistance - m_camera.frustum.near) /
+                       (m_camera.frustum.far - m_camera.frustum.near);
+    for (auto dp : mesh.draws) {
+        outList.emplace_back(createKey(depth * depth, dp),
+                             glm::mat4(1.0f), &mesh.dbuff, dp);
+    }
+}
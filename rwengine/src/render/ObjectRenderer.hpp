@@ -2,7 +2,9 @@
 #define _RWENGINE_OBJECTRENDERER_HPP_
 
 #include <cstddef>
+#include <vector>
 
+#include "render/LodCellMeshes.hpp"
 #include "render/OpenGLRenderer.hpp"
 
 class Atomic;
@@ -14,6 +16,7 @@ class GameWorld;
 class InstanceObject;
 class PickupObject;
 class ProjectileObject;
+class StaticInstanceGrid;
 class VehicleObject;
 class ViewCamera;
 struct Geometry;
@@ -41,6 +44,25 @@ public:
     size_t culled = 0;
     void buildRenderList(GameObject* object, RenderList& outList);
 
+    size_t culledCells = 0;
+    size_t culledInstances = 0;
+    size_t mergedCells = 0;
+
+    /**
+     * @brief Adds the instances of every cell that may be in view to objects
+     *
+     * Cells beyond the largest draw distance of their instances, or outside
+     * of the frustum, are skipped and counted in culledCells and
+     * culledInstances.
+     *
+     * Cells with a merged LOD mesh beyond its distance add the mesh to
+     * outList, and only their instances that aren't part of it to objects.
+     */
+    void gatherVisibleInstances(const StaticInstanceGrid& grid,
+                                const LodCellMeshes* lods,
+                                std::vector<GameObject*>& objects,
+                                RenderList& outList);
+
     void renderGeometry(Geometry* geom, const glm::mat4& modelMatrix,
                         GameObject* object, RenderList& outList);
 
@@ -66,6 +88,8 @@ private:
     float m_renderAlpha;
 
     void renderInstance(InstanceObject* instance, RenderList& outList);
+    void renderCellMesh(LodCellMeshes::CellMesh& mesh, float distance,
+                        RenderList& outList);
     void renderCharacter(CharacterObject* pedestrian, RenderList& outList);
     void renderVehicle(VehicleObject* vehicle, RenderList& outList);
     void renderPickup(PickupObject* pickup, RenderList& outList);
@@ -1,5 +1,6 @@
 #include "render/OpenGLRenderer.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 
@@ -13,6 +14,8 @@
 namespace {
 constexpr GLuint kUBOIndexScene = 1;
 constexpr GLuint kUBOIndexDraw = 2;
+/// Large enough that the object buffer is rarely orphaned mid-frame
+constexpr GLsizei kObjectBufferSize = 1024 * 1024;
 }
 
 GLuint compileShader(GLenum type, const char* source) {
@@ -125,6 +128,16 @@ const Renderer::SceneUniformData& Renderer::getSceneData() const {
     return lastSceneData;
 }
 
+bool Renderer::canInstance(const RenderInstruction& a,
+                           const RenderInstruction& b) {
+    const auto& pa = a.drawInfo;
+    const auto& pb = b.drawInfo;
+    return a.dbuff == b.dbuff && pa.start == pb.start && pa.count == pb.count &&
+           pa.textures == pb.textures && pa.textureArray == pb.textureArray &&
+           pa.blendMode == pb.blendMode &&
+           pa.depthMode == pb.depthMode && pa.depthWrite == pb.depthWrite;
+}
+
 void OpenGLRenderer::useDrawBuffer(DrawBuffer* dbuff) {
     if (dbuff != currentDbuff) {
         glBindVertexArray(dbuff->getVAOName());
@@ -138,13 +151,13 @@ void OpenGLRenderer::useDrawBuffer(DrawBuffer* dbuff) {
     }
 }
 
-void OpenGLRenderer::useTexture(GLuint unit, GLuint tex) {
+void OpenGLRenderer::useTexture(GLuint unit, GLuint tex, GLenum target) {
     if (currentTextures[unit] != tex) {
         if (currentUnit != unit) {
             glActiveTexture(GL_TEXTURE0 + unit);
             currentUnit = unit;
         }
-        glBindTexture(GL_TEXTURE_2D, tex);
+        glBindTexture(target, tex);
         currentTextures[unit] = tex;
         textureCounter++;
 #ifdef RW_GRAPHICS_STATS
@@ -211,13 +224,20 @@ OpenGLRenderer::OpenGLRenderer() {
 
     glGenQueries(1, &debugQuery);
 
-    createUBO(UBOScene, sizeof(SceneUniformData), sizeof(SceneUniformData));
+    createUBO(UBOScene, sizeof(SceneUniformData), sizeof(SceneUniformData),
+              sizeof(SceneUniformData));
     glBindBufferBase(GL_UNIFORM_BUFFER, kUBOIndexScene, UBOScene.name);
 
+    // The whole ObjectData array is bound for every draw
+    constexpr GLsizei objectBlockSize =
+        kMaxBatchObjects * sizeof(ObjectUniformData);
     GLint MaxUBOSize;
     glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &MaxUBOSize);
+    RW_ASSERT(MaxUBOSize >= objectBlockSize);
 
-    createUBO(UBOObject, MaxUBOSize, sizeof(ObjectUniformData));
+    createUBO(UBOObject, kObjectBufferSize, sizeof(ObjectUniformData),
+              objectBlockSize);
+    batchData.reserve(kMaxBatchObjects);
 
     swap();
 }
@@ -317,23 +337,43 @@ void OpenGLRenderer::setSceneParameters(
     lastSceneData = data;
 }
 
-void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw,
-                                  const Renderer::DrawParameters& p) {
+void OpenGLRenderer::setDrawParameters(DrawBuffer* draw,
+                                       const Renderer::DrawParameters& p) {
     useDrawBuffer(draw);
 
-    for (GLuint u = 0; u < p.textures.size(); ++u) {
-        useTexture(u, p.textures[u]);
+    // Every texture of a packed slot is a layer of the same array, so the 2D
+    // units are left alone
+    if (p.textureArray != 0) {
+        useTexture(kTextureArrayUnit, p.textureArray, GL_TEXTURE_2D_ARRAY);
+    } else {
+        for (GLuint u = 0; u < p.textures.size(); ++u) {
+            useTexture(u, p.textures[u]);
+        }
     }
 
     setBlend(p.blendMode);
     setDepthWrite(p.depthWrite);
     setDepthMode(p.depthMode);
+}
+
+void OpenGLRenderer::setObjectBase(GLint base) {
+    if (currentProgram && currentProgram->objectBaseLocation != -1 &&
+        currentProgram->objectBase != base) {
+        glUniform1i(currentProgram->objectBaseLocation, base);
+        currentProgram->objectBase = base;
+    }
+}
+
+void OpenGLRenderer::setDrawState(const glm::mat4& model, DrawBuffer* draw,
+                                  const Renderer::DrawParameters& p) {
+    setDrawParameters(draw, p);
 
     ObjectUniformData objectData{model,
                              glm::vec4(p.colour.r / 255.f, p.colour.g / 255.f,
                                        p.colour.b / 255.f, p.colour.a / 255.f),
-                             1.f, 1.f, p.visibility};
+                             1.f, 1.f, p.visibility, p.layer};
     uploadUBO(UBOObject, objectData);
+    setObjectBase(0);
 
     drawCounter++;
 #ifdef RW_GRAPHICS_STATS
@@ -360,55 +400,78 @@ void OpenGLRenderer::drawArrays(const glm::mat4& model, DrawBuffer* draw,
     glDrawArrays(draw->getFaceType(), static_cast<GLint>(p.start), static_cast<GLsizei>(p.count));
 }
 
+void OpenGLRenderer::drawArraysInstanced(DrawBuffer* draw,
+                                         const Renderer::DrawParameters& p,
+                                         size_t instances) {
+    setDrawParameters(draw, p);
+
+    glDrawArraysInstanced(draw->getFaceType(), static_cast<GLint>(p.start),
+                          static_cast<GLsizei>(p.count),
+                          static_cast<GLsizei>(instances));
+
+    drawCounter++;
+#ifdef RW_GRAPHICS_STATS
+    if (currentDebugDepth > 0) {
+        profileInfo[currentDebugDepth - 1].draws++;
+        profileInfo[currentDebugDepth - 1].primitives += p.count * instances;
+    }
+#endif
+}
+
 void OpenGLRenderer::drawBatched(const RenderList& list) {
     RW_PROFILE_SCOPE(__func__);
-#if 0  // Needs shader changes
-	// Determine how many batches we need to process the entire list
-	auto entries = list.size();
-	glBindBuffer(GL_UNIFORM_BUFFER, UBOObject);
-	for (int b = 0; b < entries; b += maxObjectEntries)
-	{
-		auto toConsume = std::min((GLuint)entries, b + maxObjectEntries) - b;
-		std::vector<ObjectUniformData> uploadBuffer;
-		uploadBuffer.resize(toConsume);
-		for (int d = 0; d < toConsume; ++d)
-		{
-			auto& draw = list[b+d];
-			uploadBuffer[d] = {
-				draw.model,
-				glm::vec4(draw.drawInfo.colour.r/255.f,
-				draw.drawInfo.colour.g/255.f,
-				draw.drawInfo.colour.b/255.f, 1.f),
-				1.f,
-				1.f,
-				draw.drawInfo.colour.a/255.f
-			};
-		}
-		glBufferData(GL_UNIFORM_BUFFER,
-					 toConsume * sizeof(ObjectUniformData),
-					 uploadBuffer.data(),
-					 GL_STREAM_DRAW);
-
-		// Dispatch individual draws
-		for (int d = 0; d < toConsume; ++d)
-		{
-			auto& draw = list[b+d];
-			useDrawBuffer(draw.dbuff);
-
-			for( GLuint u = 0; u < draw.drawInfo.textures.size(); ++u )
-			{
-				useTexture(u, draw.drawInfo.textures[u]);
-			}
-
-			glDrawElements(draw.dbuff->getFaceType(), draw.drawInfo.count, GL_UNSIGNED_INT,
-                           reinterpret_cast<void*>(sizeof(RenderIndex) * draw.drawInfo.start));
-		}
-	}
-#else
-    for (auto& ri : list) {
-        draw(ri.model, ri.dbuff, ri.drawInfo);
-    }
+    // Upload the object data for up to kMaxBatchObjects instructions at a
+    // time, then draw consecutive instructions that share their geometry and
+    // state as instances of a single draw.
+    for (size_t b = 0; b < list.size(); b += kMaxBatchObjects) {
+        const auto end = std::min(list.size(), b + kMaxBatchObjects);
+
+        batchData.clear();
+        for (auto i = b; i < end; ++i) {
+            const auto& p = list[i].drawInfo;
+            batchData.push_back({list[i].model,
+                                 glm::vec4(p.colour.r / 255.f,
+                                           p.colour.g / 255.f,
+                                           p.colour.b / 255.f,
+                                           p.colour.a / 255.f),
+                                 1.f, 1.f, p.visibility, p.layer});
+        }
+        uploadUBOEntry(UBOObject, batchData.data(),
+                       batchData.size() * sizeof(ObjectUniformData));
+#ifdef RW_GRAPHICS_STATS
+        if (currentDebugDepth > 0) {
+            profileInfo[currentDebugDepth - 1].uploads++;
+        }
 #endif
+
+        for (auto i = b; i < end;) {
+            const auto& ri = list[i];
+            auto instances = 1u;
+            while (i + instances < end && canInstance(ri, list[i + instances])) {
+                instances++;
+            }
+
+            setDrawParameters(ri.dbuff, ri.drawInfo);
+            setObjectBase(static_cast<GLint>(i - b));
+
+            glDrawElementsInstanced(
+                ri.dbuff->getFaceType(),
+                static_cast<GLsizei>(ri.drawInfo.count), GL_UNSIGNED_INT,
+                reinterpret_cast<void*>(sizeof(RenderIndex) *
+                                        ri.drawInfo.start),
+                static_cast<GLsizei>(instances));
+
+            drawCounter++;
+#ifdef RW_GRAPHICS_STATS
+            if (currentDebugDepth > 0) {
+                profileInfo[currentDebugDepth - 1].draws++;
+                profileInfo[currentDebugDepth - 1].primitives +=
+                    ri.drawInfo.count * instances;
+            }
+#endif
+            i += instances;
+        }
+    }
 }
 
 void OpenGLRenderer::invalidate() {
@@ -420,7 +483,8 @@ void OpenGLRenderer::invalidate() {
     setDepthMode(DepthMode::OFF);
 }
 
-bool OpenGLRenderer::createUBO(Buffer &out, GLsizei size, GLsizei entrySize)
+bool OpenGLRenderer::createUBO(Buffer &out, GLsizei size, GLsizei entrySize,
+                               GLsizei bindSize)
 {
     glGenBuffers(1, &out.name);
     glBindBuffer(GL_UNIFORM_BUFFER, out.name);
@@ -434,6 +498,7 @@ bool OpenGLRenderer::createUBO(Buffer &out, GLsizei size, GLsizei entrySize)
     }
 
     out.bufferSize = size;
+    out.bindSize = bindSize;
     out.entrySize = entrySize;
     out.entryCount = size / entrySize;
 
@@ -451,8 +516,14 @@ void OpenGLRenderer::uploadUBOEntry(Buffer &buffer, const void *data, size_t siz
 {
     attachUBO(buffer.name);
     if (buffer.entryCount > 1) {
-        RW_ASSERT(size <= buffer.entrySize);
-        if (buffer.currentEntry >= buffer.entryCount) {
+        RW_ASSERT(size <= static_cast<size_t>(buffer.bindSize));
+        // Data may span several entries, and the bound range must stay
+        // inside the buffer
+        const GLuint entries = static_cast<GLuint>(
+            (size + buffer.entrySize - 1) / buffer.entrySize);
+        const GLuint bindEntries =
+            (buffer.bindSize + buffer.entrySize - 1) / buffer.entrySize;
+        if (buffer.currentEntry + bindEntries > buffer.entryCount) {
             // Orphan the buffer, we don't want it anymore
             glBufferData(GL_UNIFORM_BUFFER, buffer.bufferSize, nullptr,
                          GL_STREAM_DRAW);
@@ -462,12 +533,13 @@ void OpenGLRenderer::uploadUBOEntry(Buffer &buffer, const void *data, size_t siz
         const auto flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT
                            | GL_MAP_UNSYNCHRONIZED_BIT;
         void* dst = glMapBufferRange(GL_UNIFORM_BUFFER, offset,
-                                     buffer.entrySize, flags);
+                                     entries * buffer.entrySize, flags);
         RW_ASSERT(dst != nullptr);
         memcpy(dst, data, size);
         glUnmapBuffer(GL_UNIFORM_BUFFER);
-        glBindBufferRange(GL_UNIFORM_BUFFER, kUBOIndexDraw, buffer.name, offset, size);
-        buffer.currentEntry++;
+        glBindBufferRange(GL_UNIFORM_BUFFER, kUBOIndexDraw, buffer.name, offset,
+                          buffer.bindSize);
+        buffer.currentEntry += entries;
     }
     else {
         glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
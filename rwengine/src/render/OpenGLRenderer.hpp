@@ -74,6 +74,9 @@ class Renderer {
 public:
     typedef std::array<GLuint,2> Textures;
 
+    /// Texture unit that DrawParameters::textureArray is bound to
+    static constexpr GLuint kTextureArrayUnit = 2;
+
     /**
      * @brief The DrawParameters struct stores drawing state
      *
@@ -90,6 +93,11 @@ public:
         size_t start{};
         /// Textures to use
         Textures textures{};
+        /// Array texture to sample instead of textures, if not 0
+        GLuint textureArray{};
+        /// Layer of textureArray, part of the object data so instances can
+        /// use different layers
+        float layer{-1.f};
         /// Blending mode
         BlendMode blendMode = BlendMode::BLEND_NONE;
         /// Depth
@@ -130,13 +138,20 @@ public:
     };
     typedef std::vector<RenderInstruction> RenderList;
 
+    /**
+     * Per object shader data, laid out to match the std140 array stride so
+     * that batches can be uploaded as an array.
+     */
     struct ObjectUniformData {
         glm::mat4 model{1.0f};
         glm::vec4 colour{1.0f};
         float diffuse{};
         float ambient{};
         float visibility{};
+        float layer{-1.f};
     };
+    static_assert(sizeof(ObjectUniformData) == 96,
+                  "ObjectUniformData must match the std140 layout");
 
     struct SceneUniformData {
         glm::mat4 projection{1.0f};
@@ -190,6 +205,13 @@ public:
                       const DrawParameters& p) = 0;
     virtual void drawArrays(const glm::mat4& model, DrawBuffer* draw,
                             const DrawParameters& p) = 0;
+    /**
+     * Draws instances of the vertices in p, the per-instance data is read
+     * from the draw buffer's instance attributes. No object data is
+     * uploaded.
+     */
+    virtual void drawArraysInstanced(DrawBuffer* draw, const DrawParameters& p,
+                                     size_t instances) = 0;
 
     virtual void drawBatched(const RenderList& list) = 0;
 
@@ -249,6 +271,10 @@ private:
     glm::mat4 projection2D{1.0f};
 
 protected:
+    /// Returns true if b can be drawn as another instance of a
+    static bool canInstance(const RenderInstruction& a,
+                            const RenderInstruction& b);
+
     int drawCounter{};
     int textureCounter{};
     int bufferCounter{};
@@ -262,9 +288,16 @@ public:
         std::map<std::string, GLint> uniforms;
 
     public:
-        OpenGLShaderProgram(GLuint p) : program(p) {
+        OpenGLShaderProgram(GLuint p)
+            : program(p)
+            , objectBaseLocation(glGetUniformLocation(p, "objectBase")) {
         }
 
+        /// Location of the objectBase uniform, -1 if the program has none
+        GLint objectBaseLocation;
+        /// Last value set for objectBase
+        GLint objectBase = 0;
+
         ~OpenGLShaderProgram() override {
             glDeleteProgram(program);
         }
@@ -276,6 +309,9 @@ public:
         GLint getUniformLocation(const std::string& name);
     };
 
+    /// Maximum number of objects in one upload of the ObjectData block
+    static constexpr GLuint kMaxBatchObjects = 128;
+
     OpenGLRenderer();
 
     ~OpenGLRenderer() override = default;
@@ -312,6 +348,8 @@ public:
               const DrawParameters& p) override;
     void drawArrays(const glm::mat4& model, DrawBuffer* draw,
                     const DrawParameters& p) override;
+    void drawArraysInstanced(DrawBuffer* draw, const DrawParameters& p,
+                             size_t instances) override;
 
     void drawBatched(const RenderList& list) override;
 
@@ -329,11 +367,19 @@ private:
         GLuint entryCount{};
         GLuint entrySize{};
         GLsizei bufferSize{};
+        /// Size of the range bound for each upload
+        GLsizei bindSize{};
     };
 
     void useDrawBuffer(DrawBuffer* dbuff);
 
-    void useTexture(GLuint unit, GLuint tex);
+    void useTexture(GLuint unit, GLuint tex, GLenum target = GL_TEXTURE_2D);
+
+    /// Sets the buffer, texture and blend state for a draw
+    void setDrawParameters(DrawBuffer* draw, const DrawParameters& p);
+
+    /// Sets which ObjectData entry the first instance of a draw uses
+    void setObjectBase(GLint base);
 
     Buffer UBOObject {};
     Buffer UBOScene {};
@@ -366,12 +412,16 @@ private:
     }
 
     // Buffer Helpers
-    bool createUBO(Buffer& out, GLsizei size, GLsizei entrySize);
+    bool createUBO(Buffer& out, GLsizei size, GLsizei entrySize,
+                   GLsizei bindSize);
 
     void attachUBO(GLuint buffer);
 
     void uploadUBOEntry(Buffer& buffer, const void *data, size_t size);
 
+    /// Staging memory for drawBatched
+    std::vector<ObjectUniformData> batchData;
+
     // Debug group profiling timers
     ProfileInfo profileInfo[MAX_DEBUG_DEPTH];
     GLuint debugQuery;
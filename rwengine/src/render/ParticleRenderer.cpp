@@ -0,0 +1,129 @@
+#include "render/ParticleRenderer.hpp"
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <gl/TextureData.hpp>
+
+#include "core/Profiler.hpp"
+#include "engine/GameWorld.hpp"
+#include "render/GameRenderer.hpp"
+#include "render/GameShaders.hpp"
+#include "render/ViewCamera.hpp"
+#include "render/VisualFX.hpp"
+
+namespace {
+struct ParticleVert {
+    static const AttributeList vertex_attributes() {
+        return {{ATRS_Position, 2, sizeof(ParticleVert), 0ul},
+                {ATRS_TexCoord, 2, sizeof(ParticleVert), 2ul * sizeof(float)},
+                {ATRS_Colour, 3, sizeof(ParticleVert), 4ul * sizeof(float)}};
+    }
+
+    float x, y;
+    float u, v;
+    float r, g, b;
+};
+}  // namespace
+
+const AttributeList ParticleRenderer::Instance::vertex_attributes() {
+    return {{ATRS_Instance0, 4, sizeof(Instance), offsetof(Instance, position),
+             GL_FLOAT, 1},
+            {ATRS_Instance1, 3, sizeof(Instance), offsetof(Instance, up),
+             GL_FLOAT, 1},
+            {ATRS_Instance2, 2, sizeof(Instance), offsetof(Instance, size),
+             GL_FLOAT, 1},
+            {ATRS_Instance3, 4, sizeof(Instance), offsetof(Instance, colour),
+             GL_UNSIGNED_BYTE, 1}};
+}
+
+ParticleRenderer::ParticleRenderer(GameRenderer& renderer) {
+    auto& r = renderer.getRenderer();
+    program = r.createShader(GameShaders::Particle::VertexShader,
+                             GameShaders::Particle::FragmentShader);
+
+    r.setUniformTexture(program.get(), "tex", 0);
+    r.setProgramBlockBinding(program.get(), "SceneData", 1);
+
+    quadGeom.uploadVertices<ParticleVert>(
+        {{0.5f, 0.5f, 1.f, 1.f, 1.f, 1.f, 1.f},
+         {-0.5f, 0.5f, 0.f, 1.f, 1.f, 1.f, 1.f},
+         {0.5f, -0.5f, 1.f, 0.f, 1.f, 1.f, 1.f},
+         {-0.5f, -0.5f, 0.f, 0.f, 1.f, 1.f, 1.f}});
+}
+
+void ParticleRenderer::gather(
+    const std::vector<std::unique_ptr<VisualFX>>& effects,
+    std::vector<Group>& groups) {
+    for (auto& group : groups) {
+        group.instances.clear();
+    }
+
+    // Particles are mostly created in bursts of the same texture
+    Group* last = nullptr;
+    for (auto& fx : effects) {
+        // Other effects not implemented yet
+        if (fx->getType() != Particle) continue;
+        auto particle = static_cast<ParticleFX*>(fx.get());
+        if (!particle->texture) continue;
+
+        if (!last || last->texture != particle->texture) {
+            auto it = std::find_if(groups.begin(), groups.end(),
+                                   [&](const Group& g) {
+                                       return g.texture == particle->texture;
+                                   });
+            if (it == groups.end()) {
+                it = groups.insert(groups.end(), Group{particle->texture, {}});
+            }
+            last = &*it;
+        }
+
+        last->instances.push_back(
+            {particle->position, static_cast<float>(particle->orientation),
+             particle->up, particle->size,
+             glm::u8vec4(glm::clamp(particle->colour, 0.f, 1.f) * 255.f)});
+    }
+
+    groups.erase(std::remove_if(groups.begin(), groups.end(),
+                                [](const Group& g) {
+                                    return g.instances.empty();
+                                }),
+                 groups.end());
+}
+
+void ParticleRenderer::render(GameRenderer& renderer, GameWorld* world,
+                              const ViewCamera& camera) {
+    RW_PROFILE_SCOPE(__func__);
+    gather(world->effects, groups_);
+    if (groups_.empty()) {
+        return;
+    }
+
+    auto& r = renderer.getRenderer();
+    r.useProgram(program.get());
+
+    const auto cameraForward = glm::normalize(
+        glm::inverse(camera.rotation) * glm::vec3(0.f, 1.f, 0.f));
+    r.setUniform(program.get(), "cameraForward", cameraForward);
+
+    Renderer::DrawParameters dp;
+    dp.start = 0;
+    dp.count = 4;
+    dp.blendMode = BlendMode::BLEND_ADDITIVE;
+    dp.depthWrite = false;
+
+    for (const auto& group : groups_) {
+        auto& batch = batches_[group.texture];
+        if (!batch) {
+            batch = std::make_unique<Batch>();
+            batch->draw.setFaceType(GL_TRIANGLE_STRIP);
+        }
+        batch->instances.streamVertices(group.instances);
+        batch->draw.addGeometryOnce({&quadGeom, &batch->instances});
+
+        dp.textures = {{group.texture->getName()}};
+        r.drawArraysInstanced(&batch->draw, dp, group.instances.size());
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef _RWENGINE_PARTICLERENDERER_HPP_
+#define _RWENGINE_PARTICLERENDERER_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtc/type_precision.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <gl/DrawBuffer.hpp>
+#include <gl/GeometryBuffer.hpp>
+
+#include <render/OpenGLRenderer.hpp>
+
+class GameRenderer;
+class GameWorld;
+class TextureData;
+class ViewCamera;
+struct VisualFX;
+
+/**
+ * @brief Draws the world's particle effects as instances of a quad
+ *
+ * Each frame the particles are grouped by texture and each group's instance
+ * data is streamed into a buffer of its own, then drawn with a single
+ * instanced draw. The quads are turned to face their direction in the
+ * vertex shader.
+ *
+ * Particles are blended additively without writing depth, so they are drawn
+ * in any order.
+ */
+class ParticleRenderer {
+public:
+    /// The data of one particle, see GameShaders::Particle::VertexShader
+    struct Instance {
+        glm::vec3 position;
+        /// ParticleFX::Orientation
+        float orientation;
+        glm::vec3 up;
+        glm::vec2 size;
+        glm::u8vec4 colour;
+
+        static const AttributeList vertex_attributes();
+    };
+
+    struct Group {
+        TextureData* texture;
+        std::vector<Instance> instances;
+    };
+
+    ParticleRenderer(GameRenderer& renderer);
+    ~ParticleRenderer() = default;
+
+    /**
+     * Draws the world's particles using the currently active render state
+     */
+    void render(GameRenderer& renderer, GameWorld* world,
+                const ViewCamera& camera);
+
+    /**
+     * Fills groups with the instances of each texture's particles. Groups
+     * are reused between calls so that their storage is kept, the groups
+     * left without particles are removed.
+     */
+    static void gather(const std::vector<std::unique_ptr<VisualFX>>& effects,
+                       std::vector<Group>& groups);
+
+    const std::vector<Group>& getGroups() const {
+        return groups_;
+    }
+
+private:
+    /// The instance buffer of a texture's particles
+    struct Batch {
+        GeometryBuffer instances;
+        DrawBuffer draw;
+    };
+
+    std::unique_ptr<Renderer::ShaderProgram> program;
+
+    GeometryBuffer quadGeom{};
+
+    std::vector<Group> groups_;
+    std::unordered_map<TextureData*, std::unique_ptr<Batch>> batches_;
+};
+
+#endif
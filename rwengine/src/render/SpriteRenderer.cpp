@@ -0,0 +1,176 @@
+#include "render/SpriteRenderer.hpp"
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "render/GameRenderer.hpp"
+
+namespace {
+constexpr char const* SpriteVertexShader = R"(
+#version 330
+
+layout(location = 0) in vec2 position;
+layout(location = 2) in vec4 colour;
+layout(location = 3) in vec2 texcoord;
+out vec2 TexCoord;
+out vec4 Colour;
+
+uniform mat4 proj;
+
+void main() {
+    gl_Position = proj * vec4(position, 0.0, 1.0);
+    TexCoord = texcoord;
+    Colour = colour;
+})";
+
+constexpr char const* SpriteFragmentShader = R"(
+#version 330
+
+in vec2 TexCoord;
+in vec4 Colour;
+uniform sampler2D spriteTexture;
+out vec4 outColour;
+
+void main() {
+    // Untextured quads share draws with textured ones
+    vec4 c = TexCoord.x < 0.0 ? vec4(0.0, 0.0, 0.0, 1.0)
+                              : texture(spriteTexture, TexCoord);
+    outColour = vec4(Colour.rgb + c.rgb, Colour.a * c.a);
+})";
+}  // namespace
+
+void SpriteRenderer::Batch::add(const glm::vec4& extents,
+                                const glm::vec4& colour, GLuint texture,
+                                BlendMode blendMode) {
+    const glm::vec2 a{extents.x, extents.y};
+    const glm::vec2 b = a + glm::vec2{extents.z, extents.w};
+    const auto min = glm::min(a, b);
+    const auto max = glm::max(a, b);
+
+    auto index = draws.size();
+    const auto searchEnd =
+        draws.size() > kMaxDrawSearch ? draws.size() - kMaxDrawSearch : 0;
+    for (auto d = draws.size(); d-- > searchEnd;) {
+        const auto& draw = draws[d];
+        if (draw.blendMode == blendMode &&
+            (texture == 0 || draw.texture == 0 || draw.texture == texture)) {
+            index = d;
+            break;
+        }
+        // Drawing the quad any earlier would put it under this draw
+        if (overlaps(min, max, draw.min, draw.max)) {
+            break;
+        }
+    }
+
+    if (index == draws.size()) {
+        draws.push_back({texture, blendMode, min, max});
+    } else {
+        auto& draw = draws[index];
+        if (draw.texture == 0) {
+            draw.texture = texture;
+        }
+        draw.min = glm::min(draw.min, min);
+        draw.max = glm::max(draw.max, max);
+    }
+
+    const auto uv = [&](float u, float v) {
+        return texture != 0 ? glm::vec2{u, v} : glm::vec2{-1.f};
+    };
+    const SpriteVertex v0{a, uv(0.f, 0.f), colour};
+    const SpriteVertex v1{{b.x, a.y}, uv(1.f, 0.f), colour};
+    const SpriteVertex v2{b, uv(1.f, 1.f), colour};
+    const SpriteVertex v3{{a.x, b.y}, uv(0.f, 1.f), colour};
+    quads.push_back({static_cast<std::uint32_t>(index),
+                     {v0, v1, v2, v0, v2, v3}});
+}
+
+void SpriteRenderer::Batch::build(std::vector<SpriteVertex>& vertices,
+                                  std::vector<Draw>& out) const {
+    out.clear();
+    out.reserve(draws.size());
+    for (const auto& draw : draws) {
+        out.push_back({draw.texture, draw.blendMode, 0, 0});
+    }
+    for (const auto& quad : quads) {
+        out[quad.draw].count += quad.vertices.size();
+    }
+    std::size_t start = 0;
+    for (auto& draw : out) {
+        draw.start = start;
+        start += draw.count;
+    }
+
+    // Quads keep the order they were added in within each draw
+    vertices.resize(start);
+    std::vector<std::size_t> next(out.size());
+    for (std::size_t d = 0; d < out.size(); ++d) {
+        next[d] = out[d].start;
+    }
+    for (const auto& quad : quads) {
+        std::copy(quad.vertices.begin(), quad.vertices.end(),
+                  vertices.begin() + next[quad.draw]);
+        next[quad.draw] += quad.vertices.size();
+    }
+}
+
+SpriteRenderer::SpriteRenderer(GameRenderer& renderer) : renderer(renderer) {
+    spriteShader = renderer.getRenderer().createShader(SpriteVertexShader,
+                                                       SpriteFragmentShader);
+    db.setFaceType(GL_TRIANGLES);
+}
+
+void SpriteRenderer::drawRect(const glm::vec4& extents,
+                              const glm::vec4& colour, GLuint texture,
+                              BlendMode blendMode) {
+    // Text under this rectangle has to be drawn before it, the rest is
+    // drawn after the rectangles anyway
+    const glm::vec2 a{extents.x, extents.y};
+    const glm::vec2 b = a + glm::vec2{extents.z, extents.w};
+    if (renderer.text.overlapsQueued(glm::min(a, b), glm::max(a, b))) {
+        renderer.text.flush();
+    }
+
+    batch.add(extents, colour, texture, blendMode);
+}
+
+void SpriteRenderer::flush() {
+    if (batch.empty()) {
+        return;
+    }
+
+    batch.build(uploadVertices, draws);
+    frameStats.quads += batch.size();
+    batch.clear();
+
+    auto& r = renderer.getRenderer();
+    r.pushDebugGroup("Sprites");
+    r.useProgram(spriteShader.get());
+    r.setUniform(spriteShader.get(), "proj", r.get2DProjection());
+    r.setUniformTexture(spriteShader.get(), "spriteTexture", 0);
+
+    gb.streamVertices(uploadVertices);
+    db.addGeometryOnce({&gb});
+
+    for (const auto& draw : draws) {
+        Renderer::DrawParameters dp;
+        dp.start = draw.start;
+        dp.count = draw.count;
+        dp.blendMode = draw.blendMode;
+        dp.textures = {{draw.texture}};
+        dp.depthMode = DepthMode::OFF;
+
+        r.drawArrays(glm::mat4(1.0f), &db, dp);
+        frameStats.draws++;
+    }
+
+    r.popDebugGroup();
+}
+
+void SpriteRenderer::endFrame() {
+    flush();
+
+    lastFrameStats = frameStats;
+    frameStats = {};
+}
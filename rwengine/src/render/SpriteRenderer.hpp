@@ -0,0 +1,184 @@
+#ifndef _RWENGINE_SPRITERENDERER_HPP_
+#define _RWENGINE_SPRITERENDERER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <gl/DrawBuffer.hpp>
+#include <gl/GeometryBuffer.hpp>
+
+#include <render/OpenGLRenderer.hpp>
+
+class GameRenderer;
+
+/**
+ * @brief Draws the rectangles of the HUD, menus, fades and letterbox
+ *
+ * drawRect() only queues a quad. The queued quads are written to one vertex
+ * buffer and drawn with as few draws as their textures and blend modes
+ * allow when flush() is called, which the TextRenderer does before drawing
+ * its own text, and endFrame() at the end of each frame.
+ *
+ * Queued text is drawn after the quads, so a quad only makes the text draw
+ * first if it covers some of it. Text backgrounds, which are queued before
+ * their own text, share a draw.
+ */
+class SpriteRenderer {
+public:
+    struct SpriteVertex {
+        glm::vec2 position;
+        /// Negative for untextured quads
+        glm::vec2 texcoord;
+        glm::vec4 colour;
+
+        SpriteVertex(glm::vec2 _position, glm::vec2 _texcoord,
+                     glm::vec4 _colour)
+            : position(_position), texcoord(_texcoord), colour(_colour) {
+        }
+
+        SpriteVertex() = default;
+
+        static const AttributeList vertex_attributes() {
+            return {
+                {ATRS_Position, 2, sizeof(SpriteVertex), 0ul},
+                {ATRS_TexCoord, 2, sizeof(SpriteVertex),
+                 0ul + sizeof(glm::vec2)},
+                {ATRS_Colour, 4, sizeof(SpriteVertex),
+                 0ul + sizeof(glm::vec2) * 2},
+            };
+        }
+    };
+
+    /**
+     * @brief Orders quads into draws that share a texture and blend mode
+     *
+     * A quad joins the latest draw it can share, as long as it doesn't
+     * overlap the quads of any later draw, so quads are never drawn under
+     * ones that were queued before them. Untextured quads can share any
+     * texture's draw.
+     */
+    class Batch {
+    public:
+        struct Draw {
+            GLuint texture;
+            BlendMode blendMode;
+            std::size_t start;
+            std::size_t count;
+        };
+
+        /// Number of draws searched back for one a quad can join
+        static constexpr std::size_t kMaxDrawSearch = 16;
+
+        /// @return true if the rectangles from minA to maxA and minB to maxB
+        /// overlap
+        static bool overlaps(const glm::vec2& minA, const glm::vec2& maxA,
+                             const glm::vec2& minB, const glm::vec2& maxB) {
+            return minA.x < maxB.x && maxA.x > minB.x && minA.y < maxB.y &&
+                   maxA.y > minB.y;
+        }
+
+        /**
+         * Queues a quad covering extents (x, y, width, height), in pixels
+         */
+        void add(const glm::vec4& extents, const glm::vec4& colour,
+                 GLuint texture, BlendMode blendMode);
+
+        /**
+         * Writes the quads' vertices in draw order, and the draws
+         */
+        void build(std::vector<SpriteVertex>& vertices,
+                   std::vector<Draw>& draws) const;
+
+        void clear() {
+            quads.clear();
+            draws.clear();
+        }
+
+        bool empty() const {
+            return quads.empty();
+        }
+
+        std::size_t size() const {
+            return quads.size();
+        }
+
+    private:
+        struct Quad {
+            std::uint32_t draw;
+            std::array<SpriteVertex, 6> vertices;
+        };
+
+        struct PendingDraw {
+            GLuint texture;
+            BlendMode blendMode;
+            /// Bounds of the draw's quads
+            glm::vec2 min;
+            glm::vec2 max;
+        };
+
+        std::vector<Quad> quads;
+        std::vector<PendingDraw> draws;
+    };
+
+    /**
+     * Counts the quads drawn in a frame
+     */
+    struct Statistics {
+        std::size_t quads = 0;
+        /// Draw calls issued
+        std::size_t draws = 0;
+    };
+
+    SpriteRenderer(GameRenderer& renderer);
+    ~SpriteRenderer() = default;
+
+    /**
+     * Queues a rectangle. The colour is added to the texture's, with the
+     * alpha multiplied.
+     *
+     * @param extents (x, y, width, height) in pixels from the top left
+     * @param texture texture name, or 0 to fill the rectangle with colour
+     */
+    void drawRect(const glm::vec4& extents, const glm::vec4& colour,
+                  GLuint texture = 0,
+                  BlendMode blendMode = BlendMode::BLEND_ALPHA);
+
+    /**
+     * Draws the queued quads
+     */
+    void flush();
+
+    /**
+     * Draws the queued quads and finishes the frame's counters
+     */
+    void endFrame();
+
+    /**
+     * @return the counters for the last frame that ended
+     */
+    const Statistics& getStatistics() const {
+        return lastFrameStats;
+    }
+
+private:
+    GameRenderer& renderer;
+    std::unique_ptr<Renderer::ShaderProgram> spriteShader;
+
+    Batch batch;
+    std::vector<SpriteVertex> uploadVertices;
+    std::vector<Batch::Draw> draws;
+
+    Statistics frameStats;
+    Statistics lastFrameStats;
+
+    GeometryBuffer gb;
+    DrawBuffer db;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <vector>
 
 #include <gl/gl_core_3_3.h>
@@ -30,10 +31,9 @@ out vec2 TexCoord;
 out vec3 Colour;
 
 uniform mat4 proj;
-uniform vec2 alignment;
 
 void main() {
-    gl_Position = proj * vec4(alignment + position, 0.0, 1.0);
+    gl_Position = proj * vec4(position, 0.0, 1.0);
     TexCoord = texcoord;
     Colour = colour;
 })";
@@ -116,30 +116,12 @@ glm::vec4 indexToTexCoord(size_t index, const glm::u32vec2 &textureSize,
     return glm::vec4(s, t, p, q);
 }
 
-struct TextVertex {
-    glm::vec2 position;
-    glm::vec2 texcoord;
-    glm::vec3 colour;
-
-    TextVertex(glm::vec2 _position, glm::vec2 _texcoord, glm::vec3 _colour)
-        : position(_position), texcoord(_texcoord), colour(_colour) {
-    }
-
-    TextVertex() = default;
-
-    static const AttributeList vertex_attributes() {
-        return {
-            {ATRS_Position, 2, sizeof(TextVertex), 0ul},
-            {ATRS_TexCoord, 2, sizeof(TextVertex), 0ul + sizeof(glm::vec2)},
-            {ATRS_Colour, 3, sizeof(TextVertex), 0ul + sizeof(glm::vec2) * 2},
-        };
-    }
-};
 }  // namespace
 
 TextRenderer::TextRenderer(GameRenderer &renderer) : renderer(renderer) {
     textShader = renderer.getRenderer().createShader(TextVertexShader,
                                                      TextFragmentShader);
+    db.setFaceType(GL_TRIANGLES);
 }
 
 void TextRenderer::setFontTexture(font_t font, const std::string& textureName) {
@@ -177,24 +159,18 @@ void TextRenderer::setFontTexture(font_t font, const std::string& textureName) {
     };
 }
 
-void TextRenderer::renderText(const TextRenderer::TextInfo& ti,
-                              bool forceColour) {
-    if (ti.text.empty() || ti.text[0] == '*')
-        return;
-
-    renderer.getRenderer().pushDebugGroup("Text");
-    renderer.getRenderer().useProgram(textShader.get());
+TextRenderer::Layout TextRenderer::layoutText(const TextInfo& ti,
+                                              bool forceColour) const {
+    Layout layout;
 
     glm::vec2 coord(0.f, 0.f);
-    glm::vec2 alignment = ti.screenPosition;
     // We should track real size not just chars.
     auto lineLength = 0;
 
     glm::vec2 ss(ti.size);
 
     glm::vec3 colour = glm::vec3(ti.baseColour) * (1 / 255.f);
-    glm::vec4 colourBG = glm::vec4(ti.backgroundColour) * (1 / 255.f);
-    std::vector<TextVertex> geo;
+    auto& geo = layout.vertices;
 
     float maxWidth = 0.f;
     float maxHeight = ss.y;
@@ -316,39 +292,152 @@ void TextRenderer::renderText(const TextRenderer::TextInfo& ti,
         geo.emplace_back(glm::vec2{p.x + ss.x, p.y + ss.y}, glm::vec2{tex.z, tex.w}, colour);
     }
 
+    layout.width = maxWidth;
+    layout.height = maxHeight;
+    layout.glyphSize = ss;
+    return layout;
+}
+
+std::size_t TextRenderer::LayoutKeyHash::operator()(
+    const LayoutKey& key) const {
+    // FNV-1a over the text, then the other fields
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](std::uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    for (auto c : key.text) {
+        mix(c);
+    }
+    mix(key.font);
+    mix(std::hash<float>()(key.size));
+    mix(static_cast<std::uint64_t>(key.wrapX));
+    mix((key.colour.r << 16) | (key.colour.g << 8) | key.colour.b);
+    mix(key.forceColour);
+    return static_cast<std::size_t>(hash);
+}
+
+void TextRenderer::renderText(const TextRenderer::TextInfo& ti,
+                              bool forceColour) {
+    if (ti.text.empty() || ti.text[0] == '*')
+        return;
+
+    LayoutKey key{ti.text, ti.font, ti.size, ti.wrapX, ti.baseColour,
+                  forceColour};
+    auto it = layouts.find(key);
+    if (it != layouts.end()) {
+        frameStats.cacheHits++;
+    } else {
+        it = layouts.emplace(std::move(key),
+                             CachedLayout{layoutText(ti, forceColour), 0})
+                 .first;
+    }
+    it->second.lastUsedFrame = frame;
+    const auto& layout = it->second.layout;
+    frameStats.strings++;
+
+    glm::vec2 alignment = ti.screenPosition;
     if (ti.align == TextInfo::TextAlignment::Right) {
-        alignment.x -= maxWidth;
+        alignment.x -= layout.width;
     } else if (ti.align == TextInfo::TextAlignment::Center) {
-        alignment.x -= (maxWidth / 2.f);
+        alignment.x -= (layout.width / 2.f);
     }
 
     alignment.y -= ti.size * 0.2f;
 
-    // If we need to, draw the background.
+    // If we need to, draw the background. The text queued so far is drawn
+    // first if the background covers it.
+    glm::vec4 colourBG = glm::vec4(ti.backgroundColour) * (1 / 255.f);
     if (colourBG.a > 0.f) {
+        const auto& ss = layout.glyphSize;
         renderer.drawColour(
-            colourBG, glm::vec4(ti.screenPosition - (ss / 3.f),
-                                glm::vec2(maxWidth, maxHeight) + (ss / 2.f)));
+            colourBG,
+            glm::vec4(ti.screenPosition - (ss / 3.f),
+                      glm::vec2(layout.width, layout.height) + (ss / 2.f)));
+    }
+
+    auto& vertices = queued[ti.font];
+    vertices.reserve(vertices.size() + layout.vertices.size());
+    glm::vec2 min{std::numeric_limits<float>::max()};
+    glm::vec2 max{std::numeric_limits<float>::lowest()};
+    for (const auto& v : layout.vertices) {
+        vertices.emplace_back(alignment + v.position, v.texcoord, v.colour);
+        min = glm::min(min, vertices.back().position);
+        max = glm::max(max, vertices.back().position);
+    }
+    queuedBounds.push_back({min, max});
+}
+
+bool TextRenderer::overlapsQueued(const glm::vec2& min,
+                                  const glm::vec2& max) const {
+    return std::any_of(queuedBounds.begin(), queuedBounds.end(),
+                       [&](const auto& bounds) {
+                           return SpriteRenderer::Batch::overlaps(
+                               min, max, bounds[0], bounds[1]);
+                       });
+}
+
+void TextRenderer::flush() {
+    queuedBounds.clear();
+    uploadVertices.clear();
+    std::array<std::size_t, FONTS_COUNT> starts{};
+    for (font_t font = 0; font < FONTS_COUNT; ++font) {
+        starts[font] = uploadVertices.size();
+        uploadVertices.insert(uploadVertices.end(), queued[font].begin(),
+                              queued[font].end());
+    }
+    if (uploadVertices.empty()) {
+        return;
     }
 
+    // The rectangles queued before this text go underneath it
+    renderer.sprites.flush();
+
+    renderer.getRenderer().pushDebugGroup("Text");
+    renderer.getRenderer().useProgram(textShader.get());
     renderer.getRenderer().setUniform(
         textShader.get(), "proj", renderer.getRenderer().get2DProjection());
     renderer.getRenderer().setUniformTexture(textShader.get(), "fontTexture", 0);
-    renderer.getRenderer().setUniform(textShader.get(), "alignment", alignment);
 
-    gb.uploadVertices(geo);
-    db.addGeometry(&gb);
-    db.setFaceType(GL_TRIANGLES);
+    gb.streamVertices(uploadVertices);
+    db.addGeometryOnce({&gb});
+    frameStats.glyphs += uploadVertices.size() / 6;
+
+    for (font_t font = 0; font < FONTS_COUNT; ++font) {
+        if (queued[font].empty()) {
+            continue;
+        }
 
-    Renderer::DrawParameters dp;
-    dp.start = 0;
-    dp.blendMode = BlendMode::BLEND_ALPHA;
-    dp.count = gb.getCount();
-    auto fTexturePtr = renderer.getData().findSlotTexture("fonts", fontMetaData.textureName);
-    dp.textures = {{fTexturePtr->getName()}};
-    dp.depthMode = DepthMode::OFF;
+        Renderer::DrawParameters dp;
+        dp.start = starts[font];
+        dp.blendMode = BlendMode::BLEND_ALPHA;
+        dp.count = queued[font].size();
+        auto fTexturePtr = renderer.getData().findSlotTexture(
+            "fonts", fonts[font].textureName);
+        dp.textures = {{fTexturePtr->getName()}};
+        dp.depthMode = DepthMode::OFF;
 
-    renderer.getRenderer().drawArrays(glm::mat4(1.0f), &db, dp);
+        renderer.getRenderer().drawArrays(glm::mat4(1.0f), &db, dp);
+        frameStats.draws++;
+
+        queued[font].clear();
+    }
 
     renderer.getRenderer().popDebugGroup();
 }
+
+void TextRenderer::endFrame() {
+    flush();
+
+    for (auto it = layouts.begin(); it != layouts.end();) {
+        if (frame - it->second.lastUsedFrame > kLayoutLifetime) {
+            it = layouts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    lastFrameStats = frameStats;
+    frameStats = {};
+    frame++;
+}
@@ -2,9 +2,12 @@
 #define _RWENGINE_TEXTRENDERER_HPP_
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
-#include <array>
+#include <unordered_map>
+#include <vector>
 
 #include <gl/DrawBuffer.hpp>
 #include <gl/GeometryBuffer.hpp>
@@ -16,8 +19,15 @@ class GameRenderer;
 /**
  * @brief Handles rendering of bitmap font textures.
  *
- * In future, strings textures might be cached to improve performance, but
- * for now, we just render each glyph on it's own quad
+ * Each glyph is drawn as its own quad. The quads for a string are laid out
+ * once and cached, since the same strings are usually drawn for many frames.
+ *
+ * renderText() only queues the text. The queued text is uploaded into one
+ * vertex buffer and drawn with a single draw per font when flush() is called,
+ * which GameRenderer does before drawing anything else in screen space, and
+ * endFrame() at the end of each frame. The SpriteRenderer's queued
+ * rectangles are drawn first, so the text stays on top of them, unless a
+ * rectangle covering queued text makes it draw earlier.
  */
 class TextRenderer {
 public:
@@ -54,6 +64,20 @@ public:
         float widthFrac;
     };
 
+    /**
+     * Counts the text drawn in a frame
+     */
+    struct Statistics {
+        /// Strings drawn
+        std::size_t strings = 0;
+        /// Strings that were already laid out
+        std::size_t cacheHits = 0;
+        /// Glyphs uploaded to the vertex buffer
+        std::size_t glyphs = 0;
+        /// Draw calls issued
+        std::size_t draws = 0;
+    };
+
     TextRenderer(GameRenderer& renderer);
     ~TextRenderer() = default;
 
@@ -61,7 +85,102 @@ public:
 
     void renderText(const TextInfo& ti, bool forceColour = false);
 
+    /**
+     * Draws the queued text
+     */
+    void flush();
+
+    /**
+     * @return true if any queued text is within the rectangle from min to max
+     */
+    bool overlapsQueued(const glm::vec2& min, const glm::vec2& max) const;
+
+    /**
+     * Draws the queued text and forgets the layouts that haven't been used
+     * for a while
+     */
+    void endFrame();
+
+    /**
+     * @return the counters for the last frame that ended
+     */
+    const Statistics& getStatistics() const {
+        return lastFrameStats;
+    }
+
+    std::size_t getCachedLayoutCount() const {
+        return layouts.size();
+    }
+
 private:
+    struct TextVertex {
+        glm::vec2 position;
+        glm::vec2 texcoord;
+        glm::vec3 colour;
+
+        TextVertex(glm::vec2 _position, glm::vec2 _texcoord,
+                   glm::vec3 _colour)
+            : position(_position), texcoord(_texcoord), colour(_colour) {
+        }
+
+        TextVertex() = default;
+
+        static const AttributeList vertex_attributes() {
+            return {
+                {ATRS_Position, 2, sizeof(TextVertex), 0ul},
+                {ATRS_TexCoord, 2, sizeof(TextVertex),
+                 0ul + sizeof(glm::vec2)},
+                {ATRS_Colour, 3, sizeof(TextVertex),
+                 0ul + sizeof(glm::vec2) * 2},
+            };
+        }
+    };
+
+    /**
+     * The quads for a string, relative to its aligned position
+     */
+    struct Layout {
+        std::vector<TextVertex> vertices;
+        float width = 0.f;
+        float height = 0.f;
+        /// Size of the last glyph, used to pad the background
+        glm::vec2 glyphSize{};
+    };
+
+    /**
+     * Everything that changes a layout. The position and alignment only
+     * offset it.
+     */
+    struct LayoutKey {
+        GameString text;
+        font_t font;
+        float size;
+        int wrapX;
+        glm::u8vec3 colour;
+        bool forceColour;
+
+        bool operator==(const LayoutKey& other) const {
+            return text == other.text && font == other.font &&
+                   size == other.size && wrapX == other.wrapX &&
+                   colour == other.colour &&
+                   forceColour == other.forceColour;
+        }
+    };
+
+    struct LayoutKeyHash {
+        std::size_t operator()(const LayoutKey& key) const;
+    };
+
+    struct CachedLayout {
+        Layout layout;
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    /// Layouts unused for this many frames are forgotten
+    static constexpr std::uint64_t kLayoutLifetime = 120;
+
+    Layout layoutText(const TextInfo& ti, bool forceColour) const;
+
     class FontMetaData {
     public:
         FontMetaData() = default;
@@ -90,6 +209,18 @@ private:
     GameRenderer& renderer;
     std::unique_ptr<Renderer::ShaderProgram> textShader;
 
+    std::unordered_map<LayoutKey, CachedLayout, LayoutKeyHash> layouts;
+    std::uint64_t frame = 0;
+
+    /// Text waiting for flush(), offset to its screen position
+    std::array<std::vector<TextVertex>, FONTS_COUNT> queued;
+    /// Screen bounds of each queued string
+    std::vector<std::array<glm::vec2, 2>> queuedBounds;
+    std::vector<TextVertex> uploadVertices;
+
+    Statistics frameStats;
+    Statistics lastFrameStats;
+
     GeometryBuffer gb;
     DrawBuffer db;
 };
@@ -1,10 +1,14 @@
 #include "render/WaterRenderer.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <map>
 
 #include <glm/glm.hpp>
 
 #include <rw/debug.hpp>
+#include <rw/headless.hpp>
 #include <rw/types.hpp>
 
 #include "engine/GameData.hpp"
@@ -12,31 +16,125 @@
 #include "render/GameRenderer.hpp"
 #include "render/GameShaders.hpp"
 #include "render/OpenGLRenderer.hpp"
+#include "render/ViewCamera.hpp"
+#include "render/ViewFrustum.hpp"
+
+namespace {
+/// @return true if the tile's index is that of a water height
+bool hasWater(uint8_t index, unsigned int nHeights) {
+    // Tiles with the magic value contain no water.
+    return index < nHeights && index < NO_WATER_INDEX;
+}
+}  // namespace
+
+void WaterRenderer::PatchTree::setWaterTable(const float* waterHeights,
+                                             unsigned int nHeights,
+                                             const uint8_t* tiles,
+                                             unsigned int nTiles) {
+    levels.clear();
+
+    auto edgeNum = static_cast<unsigned int>(std::sqrt(nTiles));
+    tileSize = WATER_WORLD_SIZE / edgeNum;
+    minHeight = std::numeric_limits<float>::max();
+    maxHeight = std::numeric_limits<float>::lowest();
+
+    std::vector<bool> water(edgeNum * edgeNum);
+    for (auto x = 0u; x < edgeNum; x++) {
+        for (auto y = 0u; y < edgeNum; y++) {
+            const auto index = tiles[x * edgeNum + y];
+            if (!hasWater(index, nHeights)) continue;
+            water[y * edgeNum + x] = true;
+            minHeight = std::min(minHeight, waterHeights[index]);
+            maxHeight = std::max(maxHeight, waterHeights[index]);
+        }
+    }
+    if (minHeight > maxHeight) {
+        return;
+    }
+    levels.push_back(std::move(water));
+
+    // A node has water if any of its children do
+    for (auto edge = edgeNum; edge > 1;) {
+        const auto& below = levels.back();
+        const auto next = (edge + 1) / 2;
+        std::vector<bool> level(next * next);
+        for (auto y = 0u; y < edge; ++y) {
+            for (auto x = 0u; x < edge; ++x) {
+                if (below[y * edge + x]) {
+                    level[(y / 2) * next + x / 2] = true;
+                }
+            }
+        }
+        levels.push_back(std::move(level));
+        edge = next;
+    }
+}
+
+void WaterRenderer::PatchTree::select(const glm::vec3& camera,
+                                      const ViewFrustum* frustum,
+                                      std::vector<Patch>& out) const {
+    if (levels.empty()) {
+        return;
+    }
+    select(levels.size() - 1, 0, 0, camera, frustum, out);
+}
+
+void WaterRenderer::PatchTree::select(std::size_t level, unsigned int x,
+                                      unsigned int y, const glm::vec3& camera,
+                                      const ViewFrustum* frustum,
+                                      std::vector<Patch>& out) const {
+    const auto edge =
+        static_cast<unsigned int>(std::sqrt(levels[level].size()));
+    if (x >= edge || y >= edge || !levels[level][y * edge + x]) {
+        return;
+    }
+
+    const auto size = tileSize * static_cast<float>(1u << level);
+    const glm::vec2 origin =
+        glm::vec2(-WATER_WORLD_SIZE / 2.f) + glm::vec2(x, y) * size;
+    // The waves only raise the surface
+    const glm::vec3 min{origin, minHeight};
+    const glm::vec3 max{origin + glm::vec2(size),
+                        maxHeight + 2.f * WATER_HEIGHT};
+
+    if (frustum) {
+        const auto center = (min + max) * 0.5f;
+        if (!frustum->intersects(center, glm::length(max - center))) {
+            return;
+        }
+    }
+
+    const auto closest = glm::clamp(camera, min, max);
+    if (level > 0 && glm::distance(camera, closest) < size * kLodDistance) {
+        for (auto cy = y * 2; cy < y * 2 + 2; ++cy) {
+            for (auto cx = x * 2; cx < x * 2 + 2; ++cx) {
+                select(level - 1, cx, cy, camera, frustum, out);
+            }
+        }
+        return;
+    }
+
+    out.push_back({origin, size});
+}
 
 WaterRenderer::WaterRenderer(GameRenderer &renderer) {
-    maskDraw.setFaceType(GL_TRIANGLES);
-    gridDraw.setFaceType(GL_TRIANGLES);
+    patchDraw.setFaceType(GL_TRIANGLES);
 
     waterProg = renderer.getRenderer().createShader(
         GameShaders::WaterHQ::VertexShader,
         GameShaders::WaterHQ::FragmentShader);
-    maskProg = renderer.getRenderer().createShader(
-        GameShaders::Mask3D::VertexShader, GameShaders::Mask3D::FragmentShader);
 
     renderer.getRenderer().setProgramBlockBinding(waterProg.get(), "SceneData", 1);
-    renderer.getRenderer().setProgramBlockBinding(maskProg.get(), "SceneData", 1);
 
     renderer.getRenderer().setUniformTexture(waterProg.get(), "data", 1);
 
-    // Generate grid mesh
-    int gridres = 60;
+    // Generate the patch, covering 0 to 1 on each axis
     std::vector<glm::vec2> grid;
-    float gridresinv = 1.f / (gridres * 0.5f);
-    glm::vec2 b(-1.f, -1.f);
-    for (int x = 0; x < gridres; x++) {
-        for (int y = 0; y < gridres; y++) {
-            glm::vec2 tMin(b + glm::vec2(x, y) * gridresinv);
-            glm::vec2 tMax(b + glm::vec2(x + 1, y + 1) * gridresinv);
+    const float step = 1.f / kPatchResolution;
+    for (int x = 0; x < kPatchResolution; x++) {
+        for (int y = 0; y < kPatchResolution; y++) {
+            glm::vec2 tMin(glm::vec2(x, y) * step);
+            glm::vec2 tMax(glm::vec2(x + 1, y + 1) * step);
 
             // Build geometry
             grid.emplace_back(tMax.x, tMax.y);
@@ -49,57 +147,79 @@ WaterRenderer::WaterRenderer(GameRenderer &renderer) {
         }
     }
 
-    gridGeom.uploadVertices(static_cast<GLsizei>(grid.size()), sizeof(glm::vec2) * grid.size(),
-                            grid.data());
-    gridGeom.getDataAttributes().emplace_back(ATRS_Position, 2, 0, 0, GL_FLOAT);
-    gridDraw.addGeometry(&gridGeom);
+    patchGeom.uploadVertices(static_cast<GLsizei>(grid.size()), sizeof(glm::vec2) * grid.size(),
+                             grid.data());
+    patchGeom.getDataAttributes().emplace_back(ATRS_Position, 2, 0, 0, GL_FLOAT);
+}
+
+WaterRenderer::~WaterRenderer() {
+    if (heightTexture != 0) {
+        glDeleteTextures(1, &heightTexture);
+    }
 }
 
 void WaterRenderer::setWaterTable(const float* waterHeights, const unsigned int nHeights,
                                   const uint8_t* tiles, const unsigned int nTiles) {
-    // Determine the dimensions of the input tiles
-    auto edgeNum = static_cast<unsigned int>(sqrt(nTiles));
-    float tileSize = WATER_WORLD_SIZE / edgeNum;
-    glm::vec2 wO{-WATER_WORLD_SIZE / 2.f, -WATER_WORLD_SIZE / 2.f};
+    tree.setWaterTable(waterHeights, nHeights, tiles, nTiles);
 
-    std::vector<glm::vec3> vertexData;
+    // Determine the dimensions of the input tiles
+    auto edgeNum = static_cast<unsigned int>(std::sqrt(nTiles));
+
+    // Tiles without water are given the most common height, so that the
+    // patches stay level over them
+    std::map<uint8_t, unsigned int> counts;
+    for (auto t = 0u; t < edgeNum * edgeNum; ++t) {
+        if (hasWater(tiles[t], nHeights)) {
+            counts[tiles[t]]++;
+        }
+    }
+    float level = 0.f;
+    if (!counts.empty()) {
+        level = waterHeights[std::max_element(counts.begin(), counts.end(),
+                                              [](const auto& a, const auto& b) {
+                                                  return a.second < b.second;
+                                              })
+                                 ->first];
+    }
 
+    // Transposed so that X runs along the rows
+    heightTexels.assign(edgeNum * edgeNum, glm::vec2(level, 0.f));
     for (auto x = 0u; x < edgeNum; x++) {
-        int xi = x * WATER_HQ_DATA_SIZE;
         for (auto y = 0u; y < edgeNum; y++) {
-            if (tiles[xi + y] >= nHeights) continue;
-
-            // Tiles with the magic value contain no water.
-            if (tiles[xi + y] >= NO_WATER_INDEX) continue;
-            float h = waterHeights[tiles[xi + y]];
-            float hMax = h + WATER_HEIGHT;
-            glm::vec2 tMin(wO + glm::vec2(x, y) * tileSize);
-            glm::vec2 tMax(wO + glm::vec2(x + 1, y + 1) * tileSize);
-
-            // Build geometry
-            vertexData.emplace_back(tMax.x, tMax.y, hMax);
-            vertexData.emplace_back(tMax.x, tMin.y, hMax);
-            vertexData.emplace_back(tMin.x, tMin.y, hMax);
-
-            vertexData.emplace_back(tMin.x, tMin.y, hMax);
-            vertexData.emplace_back(tMin.x, tMax.y, hMax);
-            vertexData.emplace_back(tMax.x, tMax.y, hMax);
+            const auto index = tiles[x * edgeNum + y];
+            if (!hasWater(index, nHeights)) continue;
+            heightTexels[y * edgeNum + x] = glm::vec2(waterHeights[index], 1.f);
         }
     }
-
-    maskGeom.uploadVertices(static_cast<GLsizei>(vertexData.size()),
-                            sizeof(glm::vec3) * vertexData.size(),
-                            vertexData.data());
-    maskGeom.getDataAttributes().emplace_back(ATRS_Position, 3, 0, 0, GL_FLOAT);
-    maskDraw.addGeometry(&maskGeom);
 }
 
-void WaterRenderer::setDataTexture(GLuint fbBinding, GLuint dataTex) {
-    fbOutput = fbBinding;
-    dataTexture = dataTex;
+void WaterRenderer::uploadHeightTexture(Renderer& r) {
+    if (isHeadless()) {
+        heightTexels.clear();
+        return;
+    }
+
+    const auto edgeNum =
+        static_cast<GLsizei>(std::sqrt(heightTexels.size()));
+
+    if (heightTexture == 0) {
+        glGenTextures(1, &heightTexture);
+    }
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, edgeNum, edgeNum, 0, GL_RG,
+                 GL_FLOAT, heightTexels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    heightTexels.clear();
+
+    // The binding above bypassed the renderer's state tracking
+    r.invalidate();
 }
 
-void WaterRenderer::render(GameRenderer &renderer, GameWorld* world) {
+void WaterRenderer::render(GameRenderer &renderer, GameWorld* world,
+                           const ViewCamera& camera) {
     auto& r = renderer.getRenderer();
 
     auto waterTexPtr = world->data->findSlotTexture("particle", "water_old");
@@ -109,48 +229,30 @@ void WaterRenderer::render(GameRenderer &renderer, GameWorld* world) {
         return;
     }
 
-    Renderer::DrawParameters wdp;
-    wdp.start = 0;
-    wdp.count = maskGeom.getCount();
-    wdp.textures = {{0}};
-    glm::mat4 m(1.0);
-
-    glEnable(GL_STENCIL_TEST);
-    glDisable(GL_DEPTH_TEST);
-
-    glStencilFunc(GL_ALWAYS, 1, 0xFF);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-    glStencilMask(0xFF);
-
-    GLenum buffers[] = {GL_COLOR_ATTACHMENT1};
-    glDrawBuffers(1, buffers);
-    glClear(GL_STENCIL_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
-
-    r.useProgram(maskProg.get());
+    if (!heightTexels.empty()) {
+        uploadHeightTexture(r);
+    }
 
-    r.drawArrays(m, &maskDraw, wdp);
+    patches.clear();
+    tree.select(camera.position, &camera.frustum, patches);
+    if (patches.empty()) {
+        return;
+    }
 
-    glStencilFunc(GL_EQUAL, 1, 0xFF);
-    glStencilMask(0x00);
-    glDisable(GL_DEPTH_TEST);
+    instanceGeom.streamVertices(patches);
+    patchDraw.addGeometryOnce({&patchGeom, &instanceGeom});
 
     r.useProgram(waterProg.get());
 
-    buffers[0] = GL_COLOR_ATTACHMENT0;
-    glDrawBuffers(1, buffers);
-
     r.setUniform(waterProg.get(), "time", world->getGameTime());
     r.setUniform(waterProg.get(), "waveParams",
                   glm::vec2(WATER_SCALE, WATER_HEIGHT));
-    auto ivp =
-        glm::inverse(r.getSceneData().projection * r.getSceneData().view);
-    r.setUniform(waterProg.get(), "inverseVP", ivp);
+    r.setUniform(waterProg.get(), "worldSize", WATER_WORLD_SIZE);
 
-    wdp.count = gridGeom.getCount();
-    wdp.textures = {{waterTexPtr->getName(), dataTexture}};
-
-    r.drawArrays(m, &gridDraw, wdp);
+    Renderer::DrawParameters wdp;
+    wdp.start = 0;
+    wdp.count = patchGeom.getCount();
+    wdp.textures = {{waterTexPtr->getName(), heightTexture}};
 
-    glDisable(GL_STENCIL_TEST);
-    glEnable(GL_DEPTH_TEST);
+    r.drawArraysInstanced(&patchDraw, wdp, patches.size());
 }
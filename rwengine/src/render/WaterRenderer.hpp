@@ -1,10 +1,14 @@
 #ifndef _RWENGINE_WATERRENDERER_HPP_
 #define _RWENGINE_WATERRENDERER_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
 #include <gl/DrawBuffer.hpp>
 #include <gl/GeometryBuffer.hpp>
 
@@ -12,47 +16,111 @@
 
 class GameRenderer;
 class GameWorld;
+class ViewCamera;
+class ViewFrustum;
 
 /**
  * Implements the rendering routines for drawing the sea water.
+ *
+ * The water is drawn as instances of a single grid patch. Each instance
+ * places and scales the patch, and the vertex shader raises it to the height
+ * of the water table, which is kept in a texture.
  */
 class WaterRenderer {
 public:
+    /// The square an instance of the patch covers
+    struct Patch {
+        glm::vec2 origin;
+        float size;
+
+        static const AttributeList vertex_attributes() {
+            return {{ATRS_Instance0, 3, sizeof(Patch), 0ul, GL_FLOAT, 1}};
+        }
+    };
+
+    /**
+     * @brief Picks the patches that cover the water around the camera
+     *
+     * The water table is split into a quadtree, whose nodes are dropped if
+     * there's no water under them. Nodes closer to the camera than
+     * kLodDistance times their size are split, down to a single tile, so the
+     * patches grow in rings around the camera.
+     */
+    class PatchTree {
+    public:
+        static constexpr float kLodDistance = 2.f;
+
+        /**
+         * Builds the tree from the water table, see
+         * WaterRenderer::setWaterTable
+         */
+        void setWaterTable(const float* waterHeights, unsigned int nHeights,
+                           const uint8_t* tiles, unsigned int nTiles);
+
+        /**
+         * Adds the patches to draw to out, skipping those outside the
+         * frustum if one is given
+         */
+        void select(const glm::vec3& camera, const ViewFrustum* frustum,
+                    std::vector<Patch>& out) const;
+
+        bool empty() const {
+            return levels.empty();
+        }
+
+    private:
+        void select(std::size_t level, unsigned int x, unsigned int y,
+                    const glm::vec3& camera, const ViewFrustum* frustum,
+                    std::vector<Patch>& out) const;
+
+        /// Whether each node has water under it, from the tiles up to the
+        /// root
+        std::vector<std::vector<bool>> levels;
+        float tileSize = 0.f;
+        float minHeight = 0.f;
+        float maxHeight = 0.f;
+    };
+
+    /// Quads along each edge of the patch
+    static constexpr int kPatchResolution = 8;
+
     WaterRenderer(GameRenderer& renderer);
-    ~WaterRenderer() = default;
+    ~WaterRenderer();
 
     /**
      * Creates the required data for rendering the water. Accepts
      * two arrays. waterHeights stores the real world heights which
      * are indexed into by the array tiles for each water tile.
      *
-     * This data is used to create the internal stencil mask for clipping
-     * the water rendering.
+     * This data is used to create the height texture sampled by the patches
+     * and to choose where they're drawn.
      */
     void setWaterTable(const float* waterHeights, const unsigned int nHeights,
                        const uint8_t* tiles, const unsigned int nTiles);
 
-    void setDataTexture(GLuint fbBinding, GLuint dataTexture);
-
     /**
      * Render the water using the currently active render state
      */
-    void render(GameRenderer& renderer, GameWorld* world);
+    void render(GameRenderer& renderer, GameWorld* world,
+                const ViewCamera& camera);
 
 private:
     std::unique_ptr<Renderer::ShaderProgram> waterProg = nullptr;
-    std::unique_ptr<Renderer::ShaderProgram> maskProg = nullptr;
 
-    DrawBuffer maskDraw{};
-    GeometryBuffer maskGeom{};
+    GeometryBuffer patchGeom{};
+
+    std::vector<Patch> patches;
+    GeometryBuffer instanceGeom{};
+    DrawBuffer patchDraw{};
 
-    std::vector<int> maskSizes;
+    PatchTree tree;
 
-    DrawBuffer gridDraw{};
-    GeometryBuffer gridGeom{};
+    void uploadHeightTexture(Renderer& r);
 
-    GLuint fbOutput{};
-    GLuint dataTexture{};
+    /// Height of each tile's water, and whether it has any
+    GLuint heightTexture = 0;
+    /// Texels waiting to be uploaded to heightTexture before the next draw
+    std::vector<glm::vec2> heightTexels;
 };
 
 #endif
@@ -1,10 +1,19 @@
 #include "script/SCMFile.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 
-void SCMFile::loadFile(char *data, size_t size) {
+namespace {
+/// Shared by all files, so that a file moved into another's place can't
+/// repeat its generation
+std::atomic<std::uint64_t> nextGeneration{1};
+}  // namespace
+
+void SCMFile::loadFile(const char *data, size_t size) {
     _data = std::make_unique<SCMByte[]>(size);
+    _size = size;
+    generation = nextGeneration++;
     std::copy(data, data + size, _data.get());
 
     // Bytes required to hop over a jump opcode.
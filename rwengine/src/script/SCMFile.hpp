@@ -30,12 +30,24 @@ public:
         return _data.get();
     }
 
-    void loadFile(char* data, size_t size);
+    void loadFile(const char* data, size_t size);
 
-    SCMByte* data() const {
+    const SCMByte* data() const {
         return _data.get();
     }
 
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * @return a number that is different after every loadFile(), even when
+     * the new data reuses the old data's memory. 0 if nothing is loaded.
+     */
+    std::uint64_t getGeneration() const {
+        return generation;
+    }
+
     template <class T>
     T read(unsigned int offset) const {
         return bit_cast<T>(*(_data.get() + offset));
@@ -75,6 +87,8 @@ public:
 
 private:
     std::unique_ptr<SCMByte[]> _data;
+    size_t _size{0};
+    std::uint64_t generation{0};
 
     SCMTarget _target{NoTarget};
 
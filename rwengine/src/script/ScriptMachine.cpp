@@ -36,91 +36,23 @@ void ScriptMachine::executeThread(SCMThread& t, int msPassed) {
     if (t.wakeCounter > 0) return;
 
     while (t.wakeCounter == 0) {
-        auto pc = t.programCounter;
-        auto opcode = file.read<SCMOpcode>(pc);
+        const auto& instruction = decodeInstruction(t, t.programCounter);
+        const auto opcode = instruction.opcode;
+        const auto isNegatedConditional = instruction.isNegatedConditional;
+        ScriptFunctionMeta& code = *instruction.code;
 
-        bool isNegatedConditional = ((opcode & SCM_NEGATE_CONDITIONAL_MASK) ==
-                                     SCM_NEGATE_CONDITIONAL_MASK);
-        opcode = opcode & ~SCM_NEGATE_CONDITIONAL_MASK;
-
-        ScriptFunctionMeta* foundcode;
-        if (!module->findOpcode(opcode, &foundcode)) {
-            throw IllegalInstruction(opcode, pc, t.name);
-        }
-        ScriptFunctionMeta& code = *foundcode;
-
-        pc += sizeof(SCMOpcode);
-
-        SCMParams parameters;
-
-        bool hasExtraParameters = code.arguments < 0;
-        auto requiredParams = std::abs(code.arguments);
-
-        for (int p = 0; p < requiredParams || hasExtraParameters; ++p) {
-            auto type_r = file.read<SCMByte>(pc);
-            auto type = static_cast<SCMType>(type_r);
-
-            if (type_r > 42) {
-                // for implicit strings, we need the byte we just read.
-                type = TString;
-            } else {
-                pc += sizeof(SCMByte);
+        // Assigning reuses the capacity of parameters, so no allocation
+        parameters = instruction.parameters;
+        if (instruction.hasVariables) {
+            for (auto& p : parameters) {
+                if (p.type == TGlobal) {
+                    p.globalPtr = globalData.data() + p.integer;
+                } else if (p.type == TLocal) {
+                    p.globalPtr = t.locals.data() + p.integer;
+                }
             }
-
-            parameters.push_back(SCMOpcodeParameter{type, {0}});
-            switch (type) {
-                case EndOfArgList:
-                    hasExtraParameters = false;
-                    break;
-                case TInt8:
-                    parameters.back().integer = file.read<std::int8_t>(pc);
-                    pc += sizeof(SCMByte);
-                    break;
-                case TInt16:
-                    parameters.back().integer = file.read<std::int16_t>(pc);
-                    pc += sizeof(SCMByte) * 2;
-                    break;
-                case TGlobal: {
-                    auto v = file.read<std::uint16_t>(pc);
-                    parameters.back().globalPtr =
-                        globalData.data() + v;  //* SCM_VARIABLE_SIZE;
-                    if (v >= file.getGlobalsSize()) {
-                        state->world->logger->error(
-                            "SCM", "Global Out of bounds! " +
-                                       std::to_string(v) + " " +
-                                       std::to_string(file.getGlobalsSize()));
-                    }
-                    pc += sizeof(SCMByte) * 2;
-                } break;
-                case TLocal: {
-                    auto v = file.read<std::uint16_t>(pc);
-                    parameters.back().globalPtr =
-                        t.locals.data() + v * SCM_VARIABLE_SIZE;
-                    if (v >= SCM_THREAD_LOCAL_SIZE) {
-                        state->world->logger->error("SCM",
-                                                    "Local Out of bounds!");
-                    }
-                    pc += sizeof(SCMByte) * 2;
-                } break;
-                case TInt32:
-                    parameters.back().integer = file.read<std::int32_t>(pc);
-                    pc += sizeof(SCMByte) * 4;
-                    break;
-                case TString:
-                    std::copy(file.data() + pc, file.data() + pc + 8,
-                              parameters.back().string);
-                    pc += sizeof(SCMByte) * 8;
-                    break;
-                case TFloat16:
-                    parameters.back().real =
-                        file.read<std::int16_t>(pc) / 16.f;
-                    pc += sizeof(SCMByte) * 2;
-                    break;
-                default:
-                    throw UnknownType(type, pc, t.name);
-                    break;
-            };
         }
+        instructionCount++;
 
         ScriptArguments sca(&parameters, &t, this);
 
@@ -143,7 +75,7 @@ void ScriptMachine::executeThread(SCMThread& t, int msPassed) {
 #endif
 
         // After debugging has been completed, update the program counter
-        t.programCounter = pc;
+        t.programCounter = instruction.next;
 
         if (code.function) {
             code.function(sca);
@@ -186,6 +118,119 @@ void ScriptMachine::executeThread(SCMThread& t, int msPassed) {
     }
 }
 
+const ScriptMachine::DecodedInstruction& ScriptMachine::decodeInstruction(
+    SCMThread& t, SCMThread::pc_t pc) {
+    if (pc < decodedIndex.size() && decodedIndex[pc] != 0) {
+        return decoded[decodedIndex[pc] - 1];
+    }
+
+    DecodedInstruction instruction;
+
+    auto opcode = file.read<SCMOpcode>(pc);
+
+    instruction.isNegatedConditional =
+        ((opcode & SCM_NEGATE_CONDITIONAL_MASK) ==
+         SCM_NEGATE_CONDITIONAL_MASK);
+    opcode = opcode & ~SCM_NEGATE_CONDITIONAL_MASK;
+    instruction.opcode = opcode;
+
+    if (!module->findOpcode(opcode, &instruction.code)) {
+        throw IllegalInstruction(opcode, pc, t.name);
+    }
+    ScriptFunctionMeta& code = *instruction.code;
+
+    const auto address = pc;
+    pc += sizeof(SCMOpcode);
+
+    auto& parameters = instruction.parameters;
+
+    bool hasExtraParameters = code.arguments < 0;
+    auto requiredParams = std::abs(code.arguments);
+
+    for (int p = 0; p < requiredParams || hasExtraParameters; ++p) {
+        auto type_r = file.read<SCMByte>(pc);
+        auto type = static_cast<SCMType>(type_r);
+
+        if (type_r > 42) {
+            // for implicit strings, we need the byte we just read.
+            type = TString;
+        } else {
+            pc += sizeof(SCMByte);
+        }
+
+        parameters.push_back(SCMOpcodeParameter{type, {0}});
+        switch (type) {
+            case EndOfArgList:
+                hasExtraParameters = false;
+                break;
+            case TInt8:
+                parameters.back().integer = file.read<std::int8_t>(pc);
+                pc += sizeof(SCMByte);
+                break;
+            case TInt16:
+                parameters.back().integer = file.read<std::int16_t>(pc);
+                pc += sizeof(SCMByte) * 2;
+                break;
+            case TGlobal: {
+                auto v = file.read<std::uint16_t>(pc);
+                parameters.back().integer = v;  //* SCM_VARIABLE_SIZE;
+                instruction.hasVariables = true;
+                if (v >= file.getGlobalsSize()) {
+                    state->world->logger->error(
+                        "SCM", "Global Out of bounds! " +
+                                   std::to_string(v) + " " +
+                                   std::to_string(file.getGlobalsSize()));
+                }
+                pc += sizeof(SCMByte) * 2;
+            } break;
+            case TLocal: {
+                auto v = file.read<std::uint16_t>(pc);
+                parameters.back().integer = v * SCM_VARIABLE_SIZE;
+                instruction.hasVariables = true;
+                if (v >= SCM_THREAD_LOCAL_SIZE) {
+                    state->world->logger->error("SCM",
+                                                "Local Out of bounds!");
+                }
+                pc += sizeof(SCMByte) * 2;
+            } break;
+            case TInt32:
+                parameters.back().integer = file.read<std::int32_t>(pc);
+                pc += sizeof(SCMByte) * 4;
+                break;
+            case TString:
+                std::copy(file.data() + pc, file.data() + pc + 8,
+                          parameters.back().string);
+                pc += sizeof(SCMByte) * 8;
+                break;
+            case TFloat16:
+                parameters.back().real = file.read<std::int16_t>(pc) / 16.f;
+                pc += sizeof(SCMByte) * 2;
+                break;
+            default:
+                throw UnknownType(type, pc, t.name);
+                break;
+        };
+    }
+
+    instruction.next = pc;
+
+    if (address >= decodedIndex.size()) {
+        // The cache only covers the file's code
+        uncachedInstruction = std::move(instruction);
+        return uncachedInstruction;
+    }
+
+    decoded.push_back(std::move(instruction));
+    decodedIndex[address] = static_cast<std::uint32_t>(decoded.size());
+    return decoded.back();
+}
+
+void ScriptMachine::invalidateDecodeCache() {
+    decoded.clear();
+    decodedIndex.assign(file.size(), 0);
+    decodedGeneration = file.getGeneration();
+}
+
 ScriptMachine::ScriptMachine(GameState* _state, SCMFile& file,
                              ScriptModule* ops)
     : file(file)
@@ -227,6 +272,11 @@ SCMByte* ScriptMachine::getGlobals() {
 
 void ScriptMachine::execute(float dt) {
     RW_PROFILE_SCOPEC(__func__, MP_ORANGERED);
+    if (decodedGeneration != file.getGeneration()) {
+        invalidateDecodeCache();
+    }
+    instructionCount = 0;
+
     int ms = static_cast<int>(dt * 1000.f);
     for (auto t = _activeThreads.begin(); t != _activeThreads.end(); ++t) {
         auto& thread = *t;
@@ -236,4 +286,7 @@ void ScriptMachine::execute(float dt) {
             t = _activeThreads.erase(t);
         }
     }
+
+    RW_PROFILE_COUNTER_SET("script/instructions", instructionCount);
+    RW_PROFILE_COUNTER_SET("script/decoded", decoded.size());
 }
@@ -126,6 +126,13 @@ struct SCMThread {
  * by consuming the correct number of arguments, allowing the next instruction
  * to be found,
  * and then dispatching a call to the opcode's function.
+ *
+ * Instructions are decoded the first time they are executed and cached by
+ * their address, so later executions only resolve variable arguments to the
+ * executing thread before dispatching. The code is never written to once it
+ * is loaded, SCMFile only hands it out as const; loading another file into
+ * the SCMFile gives it a new generation, which execute() notices and decodes
+ * afresh.
  */
 class ScriptMachine {
 public:
@@ -169,7 +176,38 @@ public:
      */
     void execute(float dt);
 
+    /**
+     * @return the number of instructions executed by the last execute()
+     */
+    size_t getInstructionCount() const {
+        return instructionCount;
+    }
+
+    /**
+     * @return the number of instructions in the decode cache
+     */
+    size_t getDecodedCount() const {
+        return decoded.size();
+    }
+
 private:
+    /**
+     * An instruction and its arguments as decoded from the script
+     *
+     * For TGlobal and TLocal parameters the integer field holds the variable's
+     * byte offset, which is turned into a pointer when the instruction is
+     * executed as locals belong to the thread.
+     */
+    struct DecodedInstruction {
+        ScriptFunctionMeta* code = nullptr;
+        /// Opcode without the negation bit
+        SCMOpcode opcode = 0;
+        bool isNegatedConditional = false;
+        bool hasVariables = false;
+        SCMThread::pc_t next = 0;
+        SCMParams parameters;
+    };
+
     SCMFile& file;
     ScriptModule* module = nullptr;
     GameState* state = nullptr;
@@ -179,7 +217,25 @@ private:
 
     void executeThread(SCMThread& t, int msPassed);
 
+    const DecodedInstruction& decodeInstruction(SCMThread& t,
+                                                SCMThread::pc_t pc);
+
+    /// Discards all decoded instructions
+    void invalidateDecodeCache();
+
     std::vector<SCMByte> globalData;
+
+    /// Index + 1 into decoded for each address of the file, 0 if not decoded
+    std::vector<std::uint32_t> decodedIndex;
+    std::vector<DecodedInstruction> decoded;
+    /// The SCMFile generation the cache was built from
+    std::uint64_t decodedGeneration = 0;
+    DecodedInstruction uncachedInstruction;
+
+    /// Reused for the arguments of each instruction
+    SCMParams parameters;
+
+    size_t instructionCount = 0;
 };
 
 #endif
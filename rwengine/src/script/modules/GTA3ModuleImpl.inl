@@ -2328,12 +2328,11 @@ void opcode_00d7(const ScriptArguments& args, const ScriptLabel arg1) {
 */
 void opcode_00d8(const ScriptArguments& args) {
     if (args.getThread()->isMission) {
-        auto& missionObjects = args.getState()->missionObjects;
-        for (auto object : missionObjects) {
+        for (auto object : args.getState()->missionObjects) {
             /// @todo: there's more logic than only changing life time, or maybe it should be done in cleanUpTraffic
             object->setLifetime(GameObject::TrafficLifetime);
         }
-        missionObjects.clear();
+        args.getState()->clearMissionObjects();
     }
 
     auto player = args.getWorld()->getPlayer();
@@ -7456,8 +7455,8 @@ void opcode_02c5(const ScriptArguments& args, ScriptInt& collected) {
     opcode 02c6
 */
 void opcode_02c6(const ScriptArguments& args) {
-    for (auto& p : args.getWorld()->pickupPool.objects) {
-        auto pickup = static_cast<BigNVeinyPickup*>(p.second.get());
+    for (auto& p : args.getWorld()->pickupPool) {
+        auto pickup = static_cast<BigNVeinyPickup*>(p.get());
         if (pickup->isBigNVeinyPickup()) {
             script::destroyObject(args, pickup);
         }
@@ -7734,7 +7733,7 @@ void opcode_02dd(const ScriptArguments& args, const ScriptString areaName, Scrip
     if (zone) {
         // Create a list of candidate characters by iterating and checking if the char is in this zone
         std::vector<std::pair<GameObjectID, GameObject*>> candidates;
-        for (auto& [id, pedestrianPtr] : args.getWorld()->pedestrianPool.objects) {
+        for (auto& pedestrianPtr : args.getWorld()->pedestrianPool) {
             auto character = static_cast<CharacterObject*>(pedestrianPtr.get());
 
             // We only consider characters walking around normally
@@ -7750,7 +7749,8 @@ void opcode_02dd(const ScriptArguments& args, const ScriptString areaName, Scrip
             auto& max = zone->max;
             if (cp.x > min.x && cp.y > min.y && cp.z > min.z &&
                 cp.x < max.x && cp.y < max.y && cp.z < max.z) {
-                candidates.emplace_back(id, pedestrianPtr.get());
+                candidates.emplace_back(character->getGameObjectID(),
+                                        pedestrianPtr.get());
             }
         }
 
@@ -9072,25 +9072,22 @@ bool opcode_0339(const ScriptArguments& args, ScriptVec3 coord0, ScriptVec3 coor
     	RW_UNIMPLEMENTED("0x339: solid flag");
     }
     if (actors) {
-    	auto& actors = args.getWorld()->pedestrianPool.objects;
-    	for (const auto& o : actors) {
-                if (script::objectInBounds(o.second.get(), coord0, coord1)) {
+    	for (const auto& o : args.getWorld()->pedestrianPool) {
+                if (script::objectInBounds(o.get(), coord0, coord1)) {
     			return true;
     		}
     	}
     }
     if (cars) {
-    	auto& cars = args.getWorld()->vehiclePool.objects;
-    	for (const auto& o : cars) {
-                if (script::objectInBounds(o.second.get(), coord0, coord1)) {
+    	for (const auto& o : args.getWorld()->vehiclePool) {
+                if (script::objectInBounds(o.get(), coord0, coord1)) {
     			return true;
     		}
     	}
     }
     if (objects) {
-    	auto& objects = args.getWorld()->instancePool.objects;
-    	for (const auto& o : objects) {
-                if (script::objectInBounds(o.second.get(), coord0, coord1)) {
+    	for (const auto& o : args.getWorld()->instancePool) {
+                if (script::objectInBounds(o.get(), coord0, coord1)) {
     			return true;
     		}
     	}
@@ -9344,14 +9341,14 @@ bool opcode_034e(const ScriptArguments& args, const ScriptObject object, ScriptV
     newPos.z = (curPos.z < coord.z ? curPos.z + arg7 : curPos.z - arg7);
 
     if (arg8) {
-        for (const auto& obj : args.getWorld()->pedestrianPool.objects) {
-            if (glm::distance(newPos, obj.second->getPosition()) <= 2.1f) {
+        for (const auto& obj : args.getWorld()->pedestrianPool) {
+            if (glm::distance(newPos, obj->getPosition()) <= 2.1f) {
                 return true;
             }
         }
 
-        for (const auto& obj : args.getWorld()->vehiclePool.objects) {
-            if (glm::distance(newPos, obj.second->getPosition()) <= 3.61f) {
+        for (const auto& obj : args.getWorld()->vehiclePool) {
+            if (glm::distance(newPos, obj->getPosition()) <= 3.61f) {
                 return true;
             }
         }
@@ -9665,8 +9662,8 @@ void opcode_0363(const ScriptArguments& args, ScriptVec3 coord, const ScriptFloa
     // Attempt to find the closest object
     InstanceObject* closestObject = nullptr;
     float closestDistance = radius;
-    for(auto& i : args.getWorld()->instancePool.objects) {
-        InstanceObject* object = static_cast<InstanceObject*>(i.second.get());
+    for(auto& i : args.getWorld()->instancePool) {
+        InstanceObject* object = static_cast<InstanceObject*>(i.get());
 
     	// Check if this instance has the correct model id, early out if it isn't
     	auto modelinfo = object->getModelInfo<BaseModelInfo>();
@@ -10932,8 +10929,8 @@ void opcode_03b6(const ScriptArguments& args, ScriptVec3 coord, const ScriptFloa
     auto newobjectid = args.getWorld()->data->findModelObject(newmodel);
     auto nobj = args.getWorld()->data->findModelInfo<SimpleModelInfo>(newobjectid);
 
-    for(auto& p : args.getWorld()->instancePool.objects) {
-        auto o = p.second.get();
+    for(auto& p : args.getWorld()->instancePool) {
+        auto o = p.get();
     	if( !o->getClump() ) continue;
     	if( o->getModelInfo<BaseModelInfo>()->name != oldmodel ) continue;
     	float d = glm::distance(coord, o->getPosition());
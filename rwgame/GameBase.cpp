@@ -2,6 +2,7 @@
 
 #include <core/Logger.hpp>
 #include <rw/debug.hpp>
+#include <rw/headless.hpp>
 #include "GitSHA1.h"
 
 #include <SDL.h>
@@ -17,6 +18,13 @@ GameBase::GameBase(Logger &inlog, const std::optional<RWArgConfigLayer> &args) :
         config(buildConfig(args)) {
     log.info("Game", "Build: " + kBuildStr);
 
+    setHeadless(args.has_value() && args->headlessSteps.has_value());
+    if (isHeadless()) {
+        // Without a window nothing from SDL is used; runs are timed with
+        // std::chrono
+        return;
+    }
+
     bool fullscreen = config.fullscreen();
     size_t w = config.width(), h = config.height();
 
@@ -81,7 +89,9 @@ RWConfig GameBase::buildConfig(const std::optional<RWArgConfigLayer> &args) {
 }
 
 GameBase::~GameBase() {
-    window.close();
+    if (window.isOpen()) {
+        window.close();
+    }
 
     SDL_Quit();
 
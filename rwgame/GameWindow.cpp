@@ -68,10 +68,16 @@ void GameWindow::close() {
 }
 
 void GameWindow::showCursor() {
+    if (!window) {
+        return;
+    }
     SDL_SetRelativeMouseMode(SDL_FALSE);
 }
 
 void GameWindow::hideCursor() {
+    if (!window) {
+        return;
+    }
     SDL_SetRelativeMouseMode(SDL_TRUE);
 }
 
@@ -70,6 +70,7 @@ void HUDDrawer::drawMap(ViewCamera& currentView, ai::PlayerController* player,
         map.screenPosition = (mapTop + mapBottom) / 2.f;
         map.screenSize = hudParameters.uiMapSize * 0.95f;
 
+        render.flushScreenSpace();
         render.map.draw(world, map);
     }
 }
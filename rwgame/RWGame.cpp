@@ -26,10 +26,15 @@
 #include <objects/VehicleObject.hpp>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <thread>
+#include <type_traits>
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4305 5033)
@@ -48,15 +53,61 @@ static constexpr std::array<
                     {GameRenderer::Arrow, "arrow.dff", ""}}};
 
 constexpr float kMaxPhysicsSubSteps = 2;
+
+/// Seed for the world's random numbers in headless runs
+constexpr unsigned int kHeadlessRandomSeed = 0;
+
+/// Adds the lifetime of the scope to a running total, in seconds
+class ScopedTimer {
+public:
+    explicit ScopedTimer(double& total)
+        : total_(total), start_(std::chrono::steady_clock::now()) {
+    }
+
+    ~ScopedTimer() {
+        total_ += std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start_)
+                      .count();
+    }
+
+private:
+    double& total_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// FNV-1a, over the bytes of trivially copyable values
+class StateHash {
+public:
+    template <class T>
+    void add(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        addBytes(&value, sizeof(T));
+    }
+
+    void addBytes(const void* data, std::size_t size) {
+        auto bytes = static_cast<const std::uint8_t*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash_ = (hash_ ^ bytes[i]) * 0x100000001b3ull;
+        }
+    }
+
+    std::uint64_t get() const {
+        return hash_;
+    }
+
+private:
+    std::uint64_t hash_ = 0xcbf29ce484222325ull;
+};
 }  // namespace
 
 #define MOUSE_SENSITIVITY_SCALE 2.5f
 
 RWGame::RWGame(Logger& log, const std::optional<RWArgConfigLayer> &args)
     : GameBase(log, args)
+    , jobs(static_cast<unsigned int>(std::max(0, config.jobThreads())))
     , data(&log, config.gamedataPath())
-    , renderer(&log, &data)
-    , imgui(*this) {
+    , imgui(*this)
+    , parallelObjects(!config.serialObjects()) {
     RW_PROFILE_THREAD("Main");
     RW_TIMELINE_ENTER("Startup", MP_YELLOW);
 
@@ -70,46 +121,79 @@ RWGame::RWGame(Logger& log, const std::optional<RWArgConfigLayer> &args)
         test = args->test;
         startSave = args->loadGamePath;
         benchFile = args->benchmarkPath;
+        headlessSteps = args->headlessSteps;
     }
 
-    imgui.init();
+    if (headlessSteps) {
+        // The world is still drawn, so that building the render list can be
+        // measured without a GL context
+        auto drawRecorder = std::make_unique<NullRenderer>();
+        nullRenderer = drawRecorder.get();
+        renderer = std::make_unique<GameRenderer>(&log, &data,
+                                                  std::move(drawRecorder));
+    } else {
+        renderer = std::make_unique<GameRenderer>(&log, &data);
+        debug = std::make_unique<DebugDraw>();
+        imgui.init();
+    }
 
     log.info("Game", "Game directory: " + config.gamedataPath());
+    data.levelCache.setDirectory(config.levelCachePath());
+    data.setJobSystem(&jobs);
     if (!data.load()) {
         throw std::runtime_error("Invalid game directory path: " +
                                  config.gamedataPath());
     }
 
+    data.streamer.setFrameBudget(config.streamingBudget());
+    // Models arriving in the background would make headless runs depend on
+    // timing, so they are loaded synchronously instead
+    if (!headlessSteps) {
+        data.streamer.start(
+            static_cast<unsigned int>(std::max(0, config.streamingThreads())));
+    }
+
+    hudDrawer.applyHUDScale(config.hudScale());
+
     for (const auto& [specialModel, fileName, name] : kSpecialModels) {
         auto model = data.loadClump(fileName, name);
-        renderer.setSpecialModel(specialModel, model);
+        renderer->setSpecialModel(specialModel, model);
     }
 
     // Set up text renderer
-    renderer.text.setFontTexture(FONT_PAGER, "pager");
-    renderer.text.setFontTexture(FONT_PRICEDOWN, "font1");
-    renderer.text.setFontTexture(FONT_ARIAL, "font2");
+    renderer->text.setFontTexture(FONT_PAGER, "pager");
+    renderer->text.setFontTexture(FONT_PRICEDOWN, "font1");
+    renderer->text.setFontTexture(FONT_ARIAL, "font2");
 
-    hudDrawer.applyHUDScale(config.hudScale());
-    renderer.map.scaleHUD(config.hudScale());
+    renderer->setJobSystem(&jobs);
+    renderer->setParallelRenderList(!config.serialRenderList());
+    renderer->lodMeshes.setDistance(config.mergedLodDistance());
 
-    debug.setDebugMode(btIDebugDraw::DBG_DrawWireframe |
-                       btIDebugDraw::DBG_DrawConstraints |
-                       btIDebugDraw::DBG_DrawConstraintLimits);
-    debug.setShaderProgram(renderer.worldProg.get());
+    renderer->map.scaleHUD(config.hudScale());
+
+    if (debug) {
+        debug->setDebugMode(btIDebugDraw::DBG_DrawWireframe |
+                            btIDebugDraw::DBG_DrawConstraints |
+                            btIDebugDraw::DBG_DrawConstraintLimits);
+        debug->setShaderProgram(renderer->worldProg.get());
+    }
 
     data.loadDynamicObjects((std::filesystem::path{config.gamedataPath()} / "data/object.dat")
                                 .string());  // FIXME: use path
 
     data.loadGXT("text/" + config.gameLanguage() + ".gxt");
 
-    getRenderer().water.setWaterTable(data.waterHeights, 48, data.realWater,
-                                      128 * 128);
+    renderer->water.setWaterTable(data.waterHeights, 48, data.realWater,
+                                  128 * 128);
 
-    for (int m = 0; m < MAP_BLOCK_SIZE; ++m) {
-        std::ostringstream oss;
-        oss << "radar" << std::setw(2) << std::setfill('0') << m << ".txd";
-        data.loadTXD(oss.str());
+    // The radar is only drawn by the HUD
+    if (!headlessSteps) {
+        for (int m = 0; m < MAP_BLOCK_SIZE; ++m) {
+            std::ostringstream oss;
+            oss << "radar" << std::setw(2) << std::setfill('0') << m << ".txd";
+            data.loadTXD(oss.str());
+        }
+        renderer->map.loadRadarAtlas();
     }
 
     stateManager.enter<LoadingState>(this, [=]() {
@@ -117,7 +201,7 @@ RWGame::RWGame(Logger& log, const std::optional<RWArgConfigLayer> &args)
             stateManager.enter<BenchmarkState>(this, *benchFile);
         } else if (test) {
             stateManager.enter<IngameState>(this, true, "test");
-        } else if (newgame) {
+        } else if (newgame || headlessSteps) {
             stateManager.enter<IngameState>(this, true);
         } else if (startSave.has_value()) {
             stateManager.enter<IngameState>(this, true, *startSave);
@@ -130,6 +214,21 @@ RWGame::RWGame(Logger& log, const std::optional<RWArgConfigLayer> &args)
     auto loadTime =
         std::chrono::duration_cast<std::chrono::milliseconds>(loadTimeEnd - loadTimeStart);
     log.info("Game", "Loading took " + std::to_string(loadTime.count()) + " ms");
+    for (const auto& step : data.getLoadTimings()) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << step.name << ": "
+            << step.milliseconds << " ms, wave " << step.wave << " on "
+            << (step.thread == TaskGraph::Thread::Main ? "main" : "jobs");
+        log.verbose("Data", oss.str());
+    }
+    if (data.levelCache.isEnabled()) {
+        const auto& cacheStats = data.levelCache.getStatistics();
+        log.info("Game", "Level cache: " +
+                             std::to_string(cacheStats.hits.load()) +
+                             " files loaded, " +
+                             std::to_string(cacheStats.misses.load()) +
+                             " compiled");
+    }
 
     log.info("Game", "Started");
     RW_TIMELINE_LEAVE("Startup");
@@ -145,7 +244,12 @@ void RWGame::newGame() {
 
     // Destroy the current world and start over
     world = std::make_unique<GameWorld>(&log, &data);
-    world->dynamicsWorld->setDebugDrawer(&debug);
+    if (debug) {
+        world->dynamicsWorld->setDebugDrawer(debug.get());
+    }
+    if (headlessSteps) {
+        world->setRandomSeed(kHeadlessRandomSeed);
+    }
 
     // Associate the new world with the new state and vice versa
     state.world = world.get();
@@ -415,6 +519,10 @@ void RWGame::handleCheatInput(char symbol) {
 int RWGame::run() {
     namespace chrono = std::chrono;
 
+    if (headlessSteps) {
+        return runHeadless(*headlessSteps);
+    }
+
     auto lastFrame = chrono::steady_clock::now();
     const float deltaTime = GAME_TIMESTEP;
     float accumulatedTime = 0.0f;
@@ -443,6 +551,8 @@ int RWGame::run() {
             accumulatedTime = tickWorld(deltaTime, accumulatedTime);
         }
 
+        data.streamer.update();
+
         render(1, frameTime);
 
         getWindow().swap();
@@ -468,6 +578,7 @@ float RWGame::tickWorld(const float deltaTime, float accumulatedTime) {
 
         {
             RW_PROFILE_SCOPEC("stepSimulation", MP_DARKORANGE1);
+            ScopedTimer timer(simulationTimes.physics);
             world->dynamicsWorld->stepSimulation(
                     deltaTimeWithTimeScale, kMaxPhysicsSubSteps, deltaTime);
         }
@@ -483,6 +594,101 @@ float RWGame::tickWorld(const float deltaTime, float accumulatedTime) {
     return accumulatedTime;
 }
 
+int RWGame::runHeadless(int steps) {
+    namespace chrono = std::chrono;
+
+    const float deltaTime = GAME_TIMESTEP;
+    simulationTimes = {};
+    double renderTime = 0.;
+
+    renderer->setViewport(config.width(), config.height());
+    nullRenderer->resetStatistics();
+
+    auto start = chrono::steady_clock::now();
+
+    int step = 0;
+    for (; step < steps && stateManager.currentState(); ++step) {
+        RW_PROFILE_FRAME_BOUNDARY();
+
+        if (!world->isPaused()) {
+            tickWorld(deltaTime, deltaTime);
+        }
+
+        data.streamer.update();
+
+        // Traffic is placed around the camera, which is normally updated by
+        // render()
+        if (!stateManager.states.empty()) {
+            currentCam = stateManager.states.back()->getCamera(1.f);
+        }
+
+        const auto renderStart = chrono::steady_clock::now();
+        renderer->renderWorld(world.get(), currentCam, 1.f);
+        renderTime +=
+            chrono::duration<double>(chrono::steady_clock::now() - renderStart)
+                .count();
+
+        stateManager.updateStack();
+    }
+
+    auto total =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    const auto perStep = 1000. / std::max(step, 1);
+    auto printTime = [&](const char* name, double seconds) {
+        std::cout << std::left << std::setw(10) << name << std::right
+                  << std::setw(12) << seconds * 1000. << " ms "
+                  << std::setw(10) << seconds * perStep << " ms/step\n";
+    };
+
+    std::cout << "Results =============\n"
+              << "Steps: " << step << " of " << steps << "\n"
+              << "Simulated: " << step * deltaTime << " seconds\n"
+              << "Objects: " << world->allObjects.size() << "\n"
+              << std::fixed << std::setprecision(3);
+    printTime("physics", simulationTimes.physics);
+    printTime("objects", simulationTimes.objects);
+    printTime("script", simulationTimes.script);
+    std::cout << "Script instructions: " << simulationTimes.instructions
+              << " (" << simulationTimes.instructions /
+                             std::max(simulationTimes.script * 1000., 1e-3)
+              << " per ms)\n";
+    printTime("traffic", simulationTimes.traffic);
+    printTime("render", renderTime);
+    printTime("total", total);
+    const auto& draws = nullRenderer->getStatistics();
+    std::cout << "Draws: " << draws.draws << " Instances: " << draws.instances
+              << " State changes: " << draws.stateChanges << "\n";
+    std::cout << "Checksum: " << std::hex << std::setw(16) << std::setfill('0')
+              << getStateChecksum() << std::dec << '\n';
+
+    stateManager.clear();
+
+    return 0;
+}
+
+std::uint64_t RWGame::getStateChecksum() const {
+    StateHash hash;
+    hash.add(state.gameTime);
+    hash.add(state.basic.gameHour);
+    hash.add(state.basic.gameMinute);
+    hash.add(state.playerInfo.money);
+
+    for (const auto* object : world->allObjects) {
+        hash.add(object->getGameObjectID());
+        hash.add(object->type());
+        hash.add(object->getPosition());
+        hash.add(object->getRotation());
+    }
+
+    if (vm) {
+        const auto& globals = vm->getGlobalData();
+        hash.addBytes(globals.data(), globals.size());
+    }
+
+    return hash.get();
+}
+
 bool RWGame::updateInput() {
     RW_PROFILE_SCOPE(__func__);
     SDL_Event event;
@@ -579,13 +785,18 @@ void RWGame::tick(float dt) {
             }
         }
 
-        tickObjects(dt);
+        {
+            ScopedTimer timer(simulationTimes.objects);
+            tickObjects(dt);
+        }
 
         state.text.tick(dt);
 
         if (vm) {
+            ScopedTimer timer(simulationTimes.script);
             try {
                 vm->execute(dt);
+                simulationTimes.instructions += vm->getInstructionCount();
             } catch (SCMException& ex) {
                 std::cerr << ex.what() << '\n';
                 log.error("Script", ex.what());
@@ -595,6 +806,7 @@ void RWGame::tick(float dt) {
 
         /// @todo this doesn't make sense as the condition
         if (state.playerObject) {
+            ScopedTimer timer(simulationTimes.traffic);
             currentCam.frustum.update(currentCam.frustum.projection() *
                                       currentCam.getView());
             // Use the current camera position to spawn pedestrians.
@@ -607,7 +819,7 @@ void RWGame::tick(float dt) {
     }
 }
 
-void RWGame::tickObjects(float dt) const {
+void RWGame::tickObjects(float dt) {
     RW_PROFILE_SCOPEC(__func__, MP_MAGENTA1);
     world->updateEffects();
 
@@ -619,6 +831,17 @@ void RWGame::tickObjects(float dt) const {
         }
     }
 
+    {
+        RW_PROFILE_SCOPEC("poses", MP_HOTPINK1);
+        // One batch per type, so the chunks of a batch take similar time
+        updatePoses(world->pedestrianPool);
+        updatePoses(world->cutscenePool);
+        updatePoses(world->vehiclePool);
+        updatePoses(world->instancePool);
+        updatePoses(world->pickupPool);
+        updatePoses(world->projectilePool);
+    }
+
     {
         RW_PROFILE_SCOPEC("garages", MP_HOTPINK2);
         for (auto &g : world->garages) {
@@ -636,6 +859,23 @@ void RWGame::tickObjects(float dt) const {
     world->destroyQueuedObjects();
 }
 
+void RWGame::updatePoses(GameWorld::ObjectPool& pool) {
+    const auto& objects = pool.getObjects();
+    if (!parallelObjects) {
+        for (auto& object : objects) {
+            object->updatePose();
+        }
+        return;
+    }
+
+    jobs.parallelFor(objects.size(), [&](size_t, size_t begin, size_t end) {
+        RW_PROFILE_SCOPE("updatePoses");
+        for (auto i = begin; i < end; ++i) {
+            objects[i]->updatePose();
+        }
+    });
+}
+
 void RWGame::render(float alpha, float time) {
     RW_PROFILE_SCOPEC(__func__, MP_CORNFLOWERBLUE);
     RW_UNUSED(time);
@@ -651,7 +891,7 @@ void RWGame::render(float alpha, float time) {
     }
 
     glm::ivec2 windowSize = getWindow().getSize();
-    renderer.setViewport(windowSize.x, windowSize.y);
+    renderer->setViewport(windowSize.x, windowSize.y);
 
     ViewCamera viewCam = currentCam;
 
@@ -667,21 +907,24 @@ void RWGame::render(float alpha, float time) {
     glEnable(GL_DEPTH_TEST);
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
-    renderer.getRenderer().pushDebugGroup("World");
+    renderer->getRenderer().pushDebugGroup("World");
 
-    renderer.renderWorld(world.get(), viewCam, alpha);
+    renderer->renderWorld(world.get(), viewCam, alpha);
 
-    renderer.getRenderer().popDebugGroup();
+    renderer->getRenderer().popDebugGroup();
 
     renderDebugView();
 
-    if (!world->isPaused()) hudDrawer.drawOnScreenText(world.get(), renderer);
+    if (!world->isPaused()) hudDrawer.drawOnScreenText(world.get(), *renderer);
 
     if (stateManager.currentState()) {
         RW_PROFILE_SCOPE("state");
-        stateManager.draw(renderer);
+        stateManager.draw(*renderer);
     }
 
+    renderer->text.endFrame();
+    renderer->sprites.endFrame();
+
     imgui.endFrame(viewCam);
 }
 
@@ -690,7 +933,7 @@ void RWGame::renderDebugView() {
     switch (debugview_) {
         case DebugViewMode::Physics:
             world->dynamicsWorld->debugDrawWorld();
-            debug.flush(renderer);
+            debug->flush(*renderer);
             break;
         case DebugViewMode::Navigation:
             renderDebugPaths();
@@ -707,16 +950,16 @@ void RWGame::renderDebugPaths() {
     for (const auto& n : world->aigraph.nodes) {
         btVector3 p(n->position.x, n->position.y, n->position.z);
         auto& col = n->type == ai::NodeType::Pedestrian ? pedColour : roadColour;
-        debug.drawLine(p - btVector3(0.f, 0.f, 1.f),
+        debug->drawLine(p - btVector3(0.f, 0.f, 1.f),
                        p + btVector3(0.f, 0.f, 1.f), col);
-        debug.drawLine(p - btVector3(1.f, 0.f, 0.f),
+        debug->drawLine(p - btVector3(1.f, 0.f, 0.f),
                        p + btVector3(1.f, 0.f, 0.f), col);
-        debug.drawLine(p - btVector3(0.f, 1.f, 0.f),
+        debug->drawLine(p - btVector3(0.f, 1.f, 0.f),
                        p + btVector3(0.f, 1.f, 0.f), col);
 
         for (const auto& c : n->connections) {
             btVector3 f(c->position.x, c->position.y, c->position.z);
-            debug.drawLine(p, f, col);
+            debug->drawLine(p, f, col);
         }
     }
 
@@ -726,13 +969,13 @@ void RWGame::renderDebugPaths() {
         btVector3 maxColor(0.f, 1.f, 0.f);
         btVector3 min(garage->min.x, garage->min.y, garage->min.z);
         btVector3 max(garage->max.x, garage->max.y, garage->max.z);
-        debug.drawLine(min, min + btVector3(0.5f, 0.f, 0.f), minColor);
-        debug.drawLine(min, min + btVector3(0.f, 0.5f, 0.f), minColor);
-        debug.drawLine(min, min + btVector3(0.f, 0.f, 0.5f), minColor);
+        debug->drawLine(min, min + btVector3(0.5f, 0.f, 0.f), minColor);
+        debug->drawLine(min, min + btVector3(0.f, 0.5f, 0.f), minColor);
+        debug->drawLine(min, min + btVector3(0.f, 0.f, 0.5f), minColor);
 
-        debug.drawLine(max, max - btVector3(0.5f, 0.f, 0.f), maxColor);
-        debug.drawLine(max, max - btVector3(0.f, 0.5f, 0.f), maxColor);
-        debug.drawLine(max, max - btVector3(0.f, 0.f, 0.5f), maxColor);
+        debug->drawLine(max, max - btVector3(0.5f, 0.f, 0.f), maxColor);
+        debug->drawLine(max, max - btVector3(0.f, 0.5f, 0.f), maxColor);
+        debug->drawLine(max, max - btVector3(0.f, 0.f, 0.5f), maxColor);
     }
 
     // Draw vehicle generators
@@ -747,21 +990,21 @@ void RWGame::renderDebugPaths() {
                          .rotate(btVector3(0.f, 0.f, 1.f), heading);
         auto left = btVector3(-0.15f, -0.15f, 0.f)
                         .rotate(btVector3(0.f, 0.f, 1.f), heading);
-        debug.drawLine(position, position + back, color);
-        debug.drawLine(position, position + right, color);
-        debug.drawLine(position, position + left, color);
+        debug->drawLine(position, position + back, color);
+        debug->drawLine(position, position + right, color);
+        debug->drawLine(position, position + left, color);
     }
 
     // Draw the targetNode if a character is driving a vehicle
-    for (auto& p : world->pedestrianPool.objects) {
-        auto v = static_cast<CharacterObject*>(p.second.get());
+    for (auto& p : world->pedestrianPool) {
+        auto v = static_cast<CharacterObject*>(p.get());
 
         static const glm::vec3 color(1.f, 1.f, 0.f);
 
         if (auto vehicle = v->getCurrentVehicle(); vehicle)
         {
             if (v->controller->targetNode) {
-                debug.drawLine(v->getPosition(), v->controller->targetNode->position, color);
+                debug->drawLine(v->getPosition(), v->controller->targetNode->position, color);
             }
 
             auto [center, halfSize] = vehicle->obstacleCheckVolume();
@@ -784,24 +1027,24 @@ void RWGame::renderDebugPaths() {
                            });
 
             static const glm::vec3 color2(1.f, 0.f, 0.f);
-            debug.drawLine(corners[0], corners[1], color2);
-            debug.drawLine(corners[0], corners[2], color2);
-            debug.drawLine(corners[3], corners[1], color2);
-            debug.drawLine(corners[3], corners[2], color2);
-
-            debug.drawLine(corners[0], corners[4], color2);
-            debug.drawLine(corners[1], corners[5], color2);
-            debug.drawLine(corners[2], corners[6], color2);
-            debug.drawLine(corners[3], corners[7], color2);
-
-            debug.drawLine(corners[4], corners[5], color2);
-            debug.drawLine(corners[4], corners[6], color2);
-            debug.drawLine(corners[7], corners[5], color2);
-            debug.drawLine(corners[7], corners[6], color2);
+            debug->drawLine(corners[0], corners[1], color2);
+            debug->drawLine(corners[0], corners[2], color2);
+            debug->drawLine(corners[3], corners[1], color2);
+            debug->drawLine(corners[3], corners[2], color2);
+
+            debug->drawLine(corners[0], corners[4], color2);
+            debug->drawLine(corners[1], corners[5], color2);
+            debug->drawLine(corners[2], corners[6], color2);
+            debug->drawLine(corners[3], corners[7], color2);
+
+            debug->drawLine(corners[4], corners[5], color2);
+            debug->drawLine(corners[4], corners[6], color2);
+            debug->drawLine(corners[7], corners[5], color2);
+            debug->drawLine(corners[7], corners[6], color2);
         }
     }
 
-    debug.flush(renderer);
+    debug->flush(*renderer);
 }
 
 void RWGame::globalKeyEvent(const SDL_Event& event) {
@@ -834,6 +1077,27 @@ void RWGame::globalKeyEvent(const SDL_Event& event) {
         case SDLK_F4:
             toggle_debug(DebugViewMode::Objects);
             break;
+        case SDLK_F5:
+            renderer->setParallelRenderList(!renderer->isParallelRenderList());
+            log.info("Game", std::string("Parallel render list ") +
+                                 (renderer->isParallelRenderList() ? "enabled"
+                                                                  : "disabled"));
+            break;
+        case SDLK_F6:
+            parallelObjects = !parallelObjects;
+            log.info("Game", std::string("Parallel object updates ") +
+                                 (parallelObjects ? "enabled" : "disabled"));
+            break;
+        case SDLK_F7: {
+            // Cycle through the worker counts the machine can run at once
+            const auto threads =
+                std::max(1u, std::thread::hardware_concurrency());
+            const auto workers =
+                static_cast<unsigned int>(jobs.getConcurrency()) % threads;
+            jobs.setWorkerCount(workers);
+            log.info("Game", "Job threads: " + std::to_string(workers));
+            break;
+        }
         default:
             break;
     }
@@ -8,11 +8,13 @@
 #include "StateManager.hpp"
 #include "game.hpp"
 
+#include <core/JobSystem.hpp>
 #include <engine/GameData.hpp>
 #include <engine/GameState.hpp>
 #include <engine/GameWorld.hpp>
 #include <render/DebugDraw.hpp>
 #include <render/GameRenderer.hpp>
+#include <render/NullRenderer.hpp>
 #include <script/SCMFile.hpp>
 #include <script/ScriptMachine.hpp>
 #include <script/modules/GTA3Module.hpp>
@@ -20,6 +22,10 @@
 #include <SDL_events.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
 
 class RWGame final : public GameBase {
 public:
@@ -31,11 +37,28 @@ public:
         Objects
     };
 
+    /**
+     * Seconds spent in each part of tickWorld(), reported by --headless
+     */
+    struct SimulationTimes {
+        double physics = 0.;
+        double objects = 0.;
+        double script = 0.;
+        double traffic = 0.;
+        /// Script instructions executed, to give the script's throughput
+        std::size_t instructions = 0;
+    };
+
 private:
+    JobSystem jobs;
     GameData data;
-    GameRenderer renderer;
+    /// Draws to a NullRenderer in headless mode
+    std::unique_ptr<GameRenderer> renderer;
+    /// The renderer's drawing interface in headless mode
+    NullRenderer* nullRenderer = nullptr;
     RWImGui imgui;
-    DebugDraw debug;
+    /// Not created in headless mode
+    std::unique_ptr<DebugDraw> debug;
     GameState state;
     HUDDrawer hudDrawer{};
 
@@ -50,11 +73,19 @@ private:
     bool inFocus = true;
     ViewCamera currentCam;
 
+    /// Update object poses on the job threads, the result is the same
+    /// either way as each object only changes itself
+    bool parallelObjects = true;
+
     DebugViewMode debugview_ = DebugViewMode::Disabled;
     int lastDraws{0};  /// Number of draws issued for the last frame.
 
     std::string cheatInputWindow = std::string(32, ' ');
 
+    /// Fixed steps to run without a window, if set
+    std::optional<int> headlessSteps;
+    SimulationTimes simulationTimes;
+
 public:
     RWGame(Logger& log, const std::optional<RWArgConfigLayer> &args);
     ~RWGame() override;
@@ -83,7 +114,7 @@ public:
     }
 
     GameRenderer& getRenderer() {
-        return renderer;
+        return *renderer;
     }
 
     ScriptMachine* getScriptVM() const {
@@ -130,7 +161,25 @@ private:
 
     void renderDebugView();
 
-    void tickObjects(float dt) const;
+    void tickObjects(float dt);
+
+    /**
+     * Updates the poses of the objects in pool, in parallel unless
+     * parallelObjects is false
+     */
+    void updatePoses(GameWorld::ObjectPool& pool);
+
+    /**
+     * Runs steps fixed time steps as fast as possible, then prints how long
+     * each part of the simulation took and a checksum of the final state.
+     */
+    int runHeadless(int steps);
+
+    /**
+     * Hashes the object transforms, clock and script globals, so runs can
+     * be compared for determinism
+     */
+    std::uint64_t getStateChecksum() const;
 };
 
 #endif
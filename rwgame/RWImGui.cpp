@@ -55,9 +55,23 @@ void WindowDebugStats(RWGame& game) {
                 static_cast<double>(world->state->basic.timeScale));
     ImGui::Text("%i Drawn %lu Culled", renderer.getRenderer().getDrawCount(),
                 renderer.getCulledCount());
+    ImGui::Text("%lu Cells %lu Instances culled by cell, %lu merged",
+                renderer.getCulledCellCount(),
+                renderer.getCulledInstanceCount(),
+                renderer.getMergedCellCount());
+    const auto& lodStats = renderer.lodMeshes.getStatistics();
+    ImGui::Text("%lu LOD meshes %lu Instances %lu Vertices", lodStats.meshes,
+                lodStats.instances, lodStats.vertices);
     ImGui::Text("%i Textures %i Buffers",
                 renderer.getRenderer().getTextureCount(),
                 renderer.getRenderer().getBufferCount());
+    const auto& textStats = renderer.text.getStatistics();
+    ImGui::Text("%lu Strings %lu Cached %lu Glyphs %lu Text draws",
+                textStats.strings, textStats.cacheHits, textStats.glyphs,
+                textStats.draws);
+    const auto& spriteStats = renderer.sprites.getStatistics();
+    ImGui::Text("%lu Sprites %lu Sprite draws", spriteStats.quads,
+                spriteStats.draws);
     ImGui::End();
 }
 
@@ -72,8 +86,8 @@ void WindowDebugObjects(RWGame& game, const ViewCamera& camera) {
                      ImGuiWindowFlags_NoInputs);
     ImGui::Text("%lu Models", data.modelinfo.size());
     ImGui::Text("Dynamic Objects\n %lu Vehicles\n %lu Peds",
-                world->vehiclePool.objects.size(),
-                world->pedestrianPool.objects.size());
+                world->vehiclePool.size(),
+                world->pedestrianPool.size());
     ImGui::End();
 
     // Render worldspace overlay for nearby objects
@@ -102,9 +116,9 @@ void WindowDebugObjects(RWGame& game, const ViewCamera& camera) {
         ImGui::End();
     };
 
-    for (auto& p : world->vehiclePool.objects) {
-        if (!isnearby(p.second.get())) continue;
-        auto v = static_cast<VehicleObject*>(p.second.get());
+    for (auto& p : world->vehiclePool) {
+        if (!isnearby(p.get())) continue;
+        auto v = static_cast<VehicleObject*>(p.get());
 
         std::stringstream ss;
         ss << v->getVehicle()->vehiclename_ << "\n"
@@ -114,9 +128,9 @@ void WindowDebugObjects(RWGame& game, const ViewCamera& camera) {
 
         showdata(v, ss);
     }
-    for (auto& p : world->pedestrianPool.objects) {
-        if (!isnearby(p.second.get())) continue;
-        auto c = static_cast<CharacterObject*>(p.second.get());
+    for (auto& p : world->pedestrianPool) {
+        if (!isnearby(p.get())) continue;
+        auto c = static_cast<CharacterObject*>(p.get());
         const auto& state = c->getCurrentState();
         auto act = c->controller->getCurrentActivity();
 
@@ -66,7 +66,11 @@ void BenchmarkState::exit() {
               << "Duration: " << duration << " seconds\n"
               << "Avg frametime: " << std::setprecision(3)
               << (duration / frameCounter) << " (" << (frameCounter / duration)
-              << " fps)" << '\n';
+              << " fps)" << '\n'
+              << "Avg culled cells: "
+              << (static_cast<double>(culledCells) / frameCounter) << " ("
+              << (static_cast<double>(culledInstances) / frameCounter)
+              << " instances)" << '\n';
 }
 
 void BenchmarkState::tick(float dt) {
@@ -95,6 +99,8 @@ void BenchmarkState::tick(float dt) {
 void BenchmarkState::draw(GameRenderer& r) {
     frameCounter++;
     State::draw(r);
+    culledCells += r.getCulledCellCount();
+    culledInstances += r.getCulledInstanceCount();
 }
 
 void BenchmarkState::handleEvent(const SDL_Event& e) {
@@ -26,6 +26,8 @@ class BenchmarkState final : public State {
     float benchmarkTime{0.f};
     float duration{0.f};
     uint32_t frameCounter{0};
+    uint64_t culledCells{0};
+    uint64_t culledInstances{0};
 
 public:
     BenchmarkState(RWGame* game, const std::string& benchfile);
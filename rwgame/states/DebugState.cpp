@@ -150,7 +150,7 @@ void DebugState::drawMapMenu() {
              "towergaragedoor2",   "towergaragedoor3",   "vheistlocdoor"}};
 
         auto gw = game->getWorld();
-        for (auto& [id, instancePtr] : gw->instancePool.objects) {
+        for (auto& instancePtr : gw->instancePool) {
             auto obj = static_cast<InstanceObject*>(instancePtr.get());
             if (std::find(garageDoorModels.begin(), garageDoorModels.end(),
                           obj->getModelInfo<BaseModelInfo>()->name) !=
@@ -208,8 +208,7 @@ void DebugState::drawAIMenu() {
     }
 
     if (ImGui::MenuItem("Kill All Peds")) {
-        for (auto& [id, pedestrianPtr] :
-             game->getWorld()->pedestrianPool.objects) {
+        for (auto& pedestrianPtr : game->getWorld()->pedestrianPool) {
             if (pedestrianPtr->getLifetime() == GameObject::PlayerLifetime) {
                 continue;
             }
@@ -132,6 +132,8 @@ void ViewerWidget::drawText(GameRenderer& r) {
     for(auto &textInfo : textInfos) {
         _renderer->text.renderText(textInfo, false);
     }
+    _renderer->text.endFrame();
+    _renderer->sprites.endFrame();
     r.renderPostProcess();
 }
 
@@ -2,9 +2,13 @@
 #include <data/Clump.hpp>
 #include <engine/Animator.hpp>
 #include <loaders/LoaderIFP.hpp>
+#include <objects/CharacterObject.hpp>
 #include <glm/gtx/string_cast.hpp>
 #include "test_Globals.hpp"
 
+#include <chrono>
+#include <cmath>
+
 BOOST_AUTO_TEST_SUITE(AnimationTests, DATA_TEST_PREDICATE)
 
 BOOST_AUTO_TEST_CASE(test_matrix) {
@@ -44,4 +48,204 @@ BOOST_AUTO_TEST_CASE(test_matrix) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_benchmark_characters) {
+    constexpr auto kCharacters = 300;
+    constexpr auto kTicks = 60;
+
+    std::vector<CharacterObject*> characters;
+    for (auto i = 0; i < kCharacters; ++i) {
+        auto character = Global::get().e->createPedestrian(
+            1, {100.f + i * 2.f, 100.f, 50.f});
+        BOOST_REQUIRE(character != nullptr);
+        character->animator->playAnimation(
+            AnimIndexMovement, character->animations->animation(AnimCycle::Walk),
+            1.f, true);
+        characters.push_back(character);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto t = 0; t < kTicks; ++t) {
+        for (auto character : characters) {
+            character->animator->tick(1.f / 30.f);
+        }
+    }
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+    BOOST_TEST_MESSAGE("Animating " << kCharacters << " characters: "
+                                    << time.count() / kTicks << "ms per tick");
+
+    for (auto character : characters) {
+        Global::get().e->destroyObject(character);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(AnimationTrackTests)
+
+namespace {
+/// An animation with bones keyed at 30fps, rotating through a full circle
+AnimationPtr createAnimation(int bones, int keyframes) {
+    auto animation = std::make_shared<Animation>();
+    animation->duration = (keyframes - 1) / 30.f;
+    for (auto b = 0; b < bones; ++b) {
+        std::vector<AnimationKeyframe> frames;
+        for (auto k = 0; k < keyframes; ++k) {
+            const auto angle = 6.2832f * k / keyframes + b;
+            frames.emplace_back(
+                glm::angleAxis(angle, glm::normalize(glm::vec3(1.f, b, 2.f))),
+                glm::vec3(b, k * 0.1f, std::sin(angle)), glm::vec3(1.f),
+                k / 30.f, k);
+        }
+        const auto name = "bone" + std::to_string(b);
+        animation->bones.emplace(
+            name, AnimationBone(name, 0, 0, animation->duration,
+                                b % 3 ? AnimationBone::RT0 : AnimationBone::R00,
+                                frames));
+    }
+    return animation;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(test_sample_matches_keyframes) {
+    auto animation = createAnimation(11, 20);
+    const auto& tracks = animation->getTracks();
+    BOOST_REQUIRE_EQUAL(tracks.size(), 11);
+
+    std::vector<uint32_t> indices;
+    for (uint32_t t = 0; t < tracks.size(); ++t) {
+        indices.push_back(t);
+    }
+    std::vector<glm::quat> rotations(indices.size());
+    std::vector<glm::vec3> translations(indices.size());
+
+    for (float time : {0.f, 0.01f, 0.25f, 0.5f, animation->duration, 1.f}) {
+        tracks.sample(time, indices.data(), indices.size(), rotations.data(),
+                      translations.data());
+        for (auto i = 0u; i < indices.size(); ++i) {
+            auto& bone = animation->bones.at(tracks.names[i]);
+            auto kf = bone.getInterpolatedKeyframe(time);
+            if (bone.type == AnimationBone::R00) {
+                kf.position = glm::vec3(0.f);
+            }
+            // nlerp and slerp agree closely between nearby keyframes
+            BOOST_CHECK_GT(std::abs(glm::dot(kf.rotation, rotations[i])),
+                           0.9999f);
+            BOOST_CHECK_LT(glm::distance(kf.position, translations[i]), 1e-5f);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_sample_cursors) {
+    auto animation = createAnimation(11, 20);
+    const auto& tracks = animation->getTracks();
+
+    std::vector<uint32_t> indices;
+    for (uint32_t t = 0; t < tracks.size(); ++t) {
+        indices.push_back(t);
+    }
+    std::vector<uint32_t> cursors(indices.size(), 0);
+    std::vector<glm::quat> rotations(indices.size());
+    std::vector<glm::quat> expectedRotations(indices.size());
+    std::vector<glm::vec3> translations(indices.size());
+    std::vector<glm::vec3> expectedTranslations(indices.size());
+
+    // Playing forwards, stepping over several keys, then seeking back
+    for (float time :
+         {0.f, 0.01f, 0.02f, 0.05f, 0.3f, 0.31f, 0.1f, 0.f, 1.f, 0.2f}) {
+        tracks.sample(time, indices.data(), indices.size(), rotations.data(),
+                      translations.data(), cursors.data());
+        tracks.sample(time, indices.data(), indices.size(),
+                      expectedRotations.data(), expectedTranslations.data());
+        for (auto i = 0u; i < indices.size(); ++i) {
+            BOOST_CHECK(rotations[i] == expectedRotations[i]);
+            BOOST_CHECK(translations[i] == expectedTranslations[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_tracks) {
+    auto animation = createAnimation(11, 20);
+    auto packed = createAnimation(11, 20);
+    const auto& tracks = animation->getTracks();
+    const auto unpackedSize = packed->getMemoryUsage();
+
+    packed->packTracks();
+    const auto& packedTracks = packed->getTracks();
+    BOOST_CHECK(packedTracks.quantized);
+    BOOST_CHECK(packed->bones.at("bone1").frames.empty());
+    BOOST_CHECK_LT(packed->getMemoryUsage(), unpackedSize);
+    BOOST_REQUIRE_EQUAL(packedTracks.size(), tracks.size());
+    BOOST_CHECK_EQUAL(packedTracks.find("bone1"), tracks.find("bone1"));
+    BOOST_CHECK_EQUAL(packedTracks.find("missing"), packedTracks.size());
+
+    std::vector<uint32_t> indices;
+    for (uint32_t t = 0; t < tracks.size(); ++t) {
+        indices.push_back(t);
+    }
+    std::vector<glm::quat> rotations(indices.size());
+    std::vector<glm::quat> packedRotations(indices.size());
+    std::vector<glm::vec3> translations(indices.size());
+    std::vector<glm::vec3> packedTranslations(indices.size());
+
+    for (float time : {0.f, 0.01f, 0.25f, 0.5f, animation->duration}) {
+        tracks.sample(time, indices.data(), indices.size(), rotations.data(),
+                      translations.data());
+        packedTracks.sample(time, indices.data(), indices.size(),
+                            packedRotations.data(), packedTranslations.data());
+        for (auto i = 0u; i < indices.size(); ++i) {
+            BOOST_CHECK_GT(std::abs(glm::dot(rotations[i], packedRotations[i])),
+                           0.9999f);
+            BOOST_CHECK(translations[i] == packedTranslations[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_benchmark_sample) {
+    constexpr auto kSteps = 2000;
+    auto animation = createAnimation(32, 60);
+    const auto& tracks = animation->getTracks();
+
+    std::vector<AnimationBone*> bones;
+    std::vector<uint32_t> indices;
+    for (uint32_t t = 0; t < tracks.size(); ++t) {
+        bones.push_back(&animation->bones.at(tracks.names[t]));
+        indices.push_back(t);
+    }
+    std::vector<glm::quat> rotations(indices.size());
+    std::vector<glm::vec3> translations(indices.size());
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    for (auto s = 0; s < kSteps; ++s) {
+        const auto time = std::fmod(s * 0.016f, animation->duration);
+        for (auto i = 0u; i < bones.size(); ++i) {
+            auto kf = bones[i]->getInterpolatedKeyframe(time);
+            rotations[i] = kf.rotation;
+            translations[i] = kf.position;
+        }
+    }
+    std::chrono::duration<double, std::milli> perBone = clock::now() - start;
+    const auto expected = translations;
+
+    start = clock::now();
+    for (auto s = 0; s < kSteps; ++s) {
+        const auto time = std::fmod(s * 0.016f, animation->duration);
+        tracks.sample(time, indices.data(), indices.size(), rotations.data(),
+                      translations.data());
+    }
+    std::chrono::duration<double, std::milli> batched = clock::now() - start;
+
+    BOOST_TEST_MESSAGE("Sampling " << bones.size() << " bones " << kSteps
+                                   << " times: per bone " << perBone.count()
+                                   << "ms, batched " << batched.count()
+                                   << "ms");
+
+    for (auto i = 0u; i < bones.size(); ++i) {
+        if (bones[i]->type != AnimationBone::R00) {
+            BOOST_CHECK_LT(glm::distance(expected[i], translations[i]), 1e-5f);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,6 @@
 #include <boost/test/unit_test.hpp>
 #include <loaders/LoaderIMG.hpp>
+#include <cstring>
 #include "test_Globals.hpp"
 
 BOOST_AUTO_TEST_SUITE(ArchiveTests, DATA_TEST_PREDICATE)
@@ -28,4 +29,26 @@ BOOST_AUTO_TEST_CASE(test_open_archive) {
     BOOST_CHECK_EQUAL(f2.size, f.size);
 }
 
+BOOST_AUTO_TEST_CASE(test_view_asset) {
+    std::shared_ptr<const char[]> view;
+    std::unique_ptr<char[]> copy;
+    LoaderIMGFile f;
+
+    {
+        LoaderIMG archive;
+
+        BOOST_REQUIRE(archive.load(Global::getGamePath() + "/models/gta3"));
+        BOOST_REQUIRE(archive.isMapped());
+        BOOST_REQUIRE(archive.findAssetInfo("landstal.dff", f));
+
+        view = archive.viewAsset(f);
+        copy = archive.loadToMemory("landstal.dff");
+        BOOST_REQUIRE(view != nullptr);
+        BOOST_REQUIRE(copy != nullptr);
+    }
+
+    // The view keeps the archive mapped
+    BOOST_CHECK_EQUAL(std::memcmp(view.get(), copy.get(), f.size * 2048), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
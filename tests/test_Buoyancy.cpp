@@ -1,4 +1,5 @@
 #include <boost/test/unit_test.hpp>
+#include <engine/GameData.hpp>
 #include <objects/VehicleObject.hpp>
 #include "test_Globals.hpp"
 
@@ -57,4 +58,38 @@ BOOST_AUTO_TEST_CASE(test_vehicle_buoyancy) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_water_heights) {
+    auto& data = *Global::get().e->data;
+    glm::vec2 tpos(-WATER_WORLD_SIZE / 2.f + 10.f);
+
+    const std::vector<glm::vec3> points{{tpos, 0.f},
+                                        {tpos + glm::vec2(1.f), 0.f},
+                                        {-WATER_WORLD_SIZE, 0.f, 0.f}};
+    std::vector<float> heights(points.size());
+    data.getWaterHeightsAt(points.data(), points.size(), heights.data());
+
+    // Relies on tile 0,0 being watered...
+    for (auto p = 0u; p < 2; ++p) {
+        auto wi = data.getWaterIndexAt(points[p]);
+        BOOST_REQUIRE_LT(wi, NO_WATER_INDEX);
+        BOOST_CHECK_CLOSE(heights[p],
+                          data.waterHeights[wi] +
+                              data.getWaveHeightAt(points[p]),
+                          0.001f);
+        BOOST_CHECK_EQUAL(heights[p], data.getWaterHeightAt(points[p]));
+        BOOST_CHECK(data.hasWaterAt(points[p]));
+    }
+
+    // Outside the water table
+    BOOST_CHECK_EQUAL(heights[2], GameData::kNoWaterHeight);
+    BOOST_CHECK(!data.hasWaterAt(points[2]));
+
+    auto orgval = data.realWater[0];
+    data.realWater[0] = NO_WATER_INDEX;
+    BOOST_CHECK_EQUAL(data.getWaterHeightAt(points[0]),
+                      GameData::kNoWaterHeight);
+    BOOST_CHECK(!data.hasWaterAt(points[0]));
+    data.realWater[0] = orgval;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -658,6 +658,23 @@ BOOST_AUTO_TEST_CASE(test_argParser_int) {
     BOOST_CHECK_EQUAL(*optLayer->width, width);
 }
 
+BOOST_AUTO_TEST_CASE(test_argParser_headless) {
+    RWArgumentParser argParser;
+    {
+        const char *args[] = {""};
+        auto optLayer = argParser.parseArguments(1, args);
+        BOOST_REQUIRE(optLayer.has_value());
+        BOOST_CHECK(!optLayer->headlessSteps.has_value());
+    }
+    {
+        const char *args[] = {"", "--headless", "600"};
+        auto optLayer = argParser.parseArguments(3, args);
+        BOOST_REQUIRE(optLayer.has_value());
+        BOOST_REQUIRE(optLayer->headlessSteps.has_value());
+        BOOST_CHECK_EQUAL(*optLayer->headlessSteps, 600);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_argParser_incomplete_optional) {
     RWArgumentParser argParser;
     const char *args[] = {"", "--hel"};
@@ -15,6 +15,59 @@ BOOST_AUTO_TEST_CASE(test_gameobject_id) {
     BOOST_CHECK_NE(object1->getGameObjectID(), object2->getGameObjectID());
 }
 
+BOOST_AUTO_TEST_CASE(test_active_instances) {
+    auto& gw = *Global::get().e;
+    const auto count = gw.activeInstances.size();
+
+    auto object = gw.createInstance(1337, glm::vec3(100.f, 0.f, 0.f));
+    BOOST_CHECK(!object->isAwake());
+
+    object->wake();
+    BOOST_CHECK(object->isAwake());
+    BOOST_CHECK_EQUAL(gw.activeInstances.size(), count + 1);
+
+    // Nothing is moving it, so it leaves after a tick
+    object->tickPhysics(1.f / 60.f);
+    BOOST_CHECK(!object->isAwake());
+    BOOST_CHECK_EQUAL(gw.activeInstances.size(), count);
+
+    // Floating objects are always kept awake
+    object->setFloating(true);
+    object->tickPhysics(1.f / 60.f);
+    BOOST_CHECK(object->isAwake());
+
+    gw.destroyObject(object);
+    BOOST_CHECK_EQUAL(gw.activeInstances.size(), count);
+}
+
+BOOST_AUTO_TEST_CASE(test_mission_objects) {
+    auto& gw = *Global::get().e;
+    GameState state;
+
+    auto object1 = gw.createInstance(1337, glm::vec3(100.f, 0.f, 0.f));
+    auto object2 = gw.createInstance(1337, glm::vec3(100.f, 0.f, 100.f));
+    state.addMissionObject(object1);
+    state.addMissionObject(object2);
+    state.addMissionObject(object1);
+    BOOST_CHECK_EQUAL(state.missionObjects.size(), 2u);
+
+    // The last object takes the place of the removed one
+    state.removeMissionObject(object1);
+    BOOST_REQUIRE_EQUAL(state.missionObjects.size(), 1u);
+    BOOST_CHECK_EQUAL(state.missionObjects[0], object2);
+    state.removeMissionObject(object1);
+    BOOST_CHECK_EQUAL(state.missionObjects.size(), 1u);
+
+    state.clearMissionObjects();
+    BOOST_CHECK(state.missionObjects.empty());
+    state.addMissionObject(object2);
+    BOOST_CHECK_EQUAL(state.missionObjects.size(), 1u);
+    state.clearMissionObjects();
+
+    gw.destroyObject(object1);
+    gw.destroyObject(object2);
+}
+
 BOOST_AUTO_TEST_CASE(test_offsetgametime) {
     auto& gw = *Global::get().e;
     gw.state = new GameState();
@@ -68,3 +121,72 @@ BOOST_AUTO_TEST_CASE(test_offsetgametime) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+namespace {
+class PoolTestObject final : public GameObject {
+public:
+    PoolTestObject()
+        : GameObject(nullptr, glm::vec3(), glm::quat{1.0f, 0.0f, 0.0f, 0.0f},
+                     nullptr) {
+    }
+
+    void tick(float) override {
+    }
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(ObjectPoolTests)
+
+BOOST_AUTO_TEST_CASE(test_pool_handles) {
+    GameWorld::ObjectPool pool;
+
+    std::vector<GameObject*> objects;
+    for (auto i = 0; i < 3; ++i) {
+        auto object = std::make_unique<PoolTestObject>();
+        objects.push_back(object.get());
+        pool.insert(std::move(object));
+    }
+    BOOST_CHECK_EQUAL(pool.size(), 3);
+    BOOST_CHECK_EQUAL(objects[0]->getGameObjectID(), 1);
+    BOOST_CHECK_EQUAL(objects[2]->getGameObjectID(), 3);
+
+    const auto staleID = objects[1]->getGameObjectID();
+    pool.remove(objects[1]);
+    BOOST_CHECK_EQUAL(pool.size(), 2);
+    BOOST_CHECK(pool.find(staleID) == nullptr);
+    BOOST_CHECK_EQUAL(pool.find(objects[2]->getGameObjectID()), objects[2]);
+
+    // The slot is reused, but the old ID stays stale
+    auto object = std::make_unique<PoolTestObject>();
+    auto reused = object.get();
+    pool.insert(std::move(object));
+    BOOST_CHECK_NE(reused->getGameObjectID(), staleID);
+    BOOST_CHECK(pool.find(staleID) == nullptr);
+    BOOST_CHECK_EQUAL(pool.find(reused->getGameObjectID()), reused);
+
+    std::size_t count = 0;
+    for (const auto& p : pool) {
+        BOOST_CHECK_EQUAL(pool.find(p->getGameObjectID()), p.get());
+        count++;
+    }
+    BOOST_CHECK_EQUAL(count, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_requested_id) {
+    GameWorld::ObjectPool pool;
+
+    auto object = std::make_unique<PoolTestObject>();
+    object->setGameObjectID(9999);
+    auto requested = object.get();
+    pool.insert(std::move(object));
+    BOOST_CHECK_EQUAL(requested->getGameObjectID(), 9999);
+    BOOST_CHECK_EQUAL(pool.find(9999), requested);
+
+    // Slots skipped by the requested ID are used first
+    object = std::make_unique<PoolTestObject>();
+    auto next = object.get();
+    pool.insert(std::move(object));
+    BOOST_CHECK_EQUAL(next->getGameObjectID(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
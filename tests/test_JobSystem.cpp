@@ -0,0 +1,77 @@
+#include <boost/test/unit_test.hpp>
+#include <core/JobSystem.hpp>
+
+#include <atomic>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(JobSystemTests)
+
+BOOST_AUTO_TEST_CASE(test_inline) {
+    JobSystem jobs;
+    BOOST_CHECK_EQUAL(jobs.getConcurrency(), 1);
+
+    std::vector<int> visited(100, 0);
+    jobs.parallelFor(visited.size(), 4,
+                     [&](size_t, size_t begin, size_t end) {
+                         for (auto i = begin; i < end; ++i) {
+                             visited[i]++;
+                         }
+                     });
+
+    for (auto v : visited) {
+        BOOST_CHECK_EQUAL(v, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_for) {
+    JobSystem jobs(3);
+    BOOST_CHECK_EQUAL(jobs.getConcurrency(), 4);
+
+    std::vector<int> visited(1000, 0);
+    std::atomic<size_t> chunks{0};
+
+    // Run several batches to cover workers picking up consecutive batches
+    for (int batch = 0; batch < 50; ++batch) {
+        jobs.parallelFor(visited.size(), 7,
+                         [&](size_t, size_t begin, size_t end) {
+                             for (auto i = begin; i < end; ++i) {
+                                 visited[i]++;
+                             }
+                             chunks++;
+                         });
+    }
+
+    BOOST_CHECK_EQUAL(chunks, 50 * 7);
+    for (auto v : visited) {
+        BOOST_CHECK_EQUAL(v, 50);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_empty) {
+    JobSystem jobs(2);
+    bool called = false;
+    jobs.parallelFor(0, [&](size_t, size_t, size_t) { called = true; });
+    BOOST_CHECK(!called);
+}
+
+BOOST_AUTO_TEST_CASE(test_set_worker_count) {
+    JobSystem jobs(1);
+
+    for (auto workers : {3u, 0u, 2u}) {
+        jobs.setWorkerCount(workers);
+        BOOST_CHECK_EQUAL(jobs.getConcurrency(), workers + 1);
+
+        std::vector<int> visited(100, 0);
+        jobs.parallelFor(visited.size(), 5,
+                         [&](size_t, size_t begin, size_t end) {
+                             for (auto i = begin; i < end; ++i) {
+                                 visited[i]++;
+                             }
+                         });
+        for (auto v : visited) {
+            BOOST_CHECK_EQUAL(v, 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
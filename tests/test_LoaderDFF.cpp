@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 #include <data/Clump.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
 #include <platform/FileHandle.hpp>
 #include "test_Globals.hpp"
 
@@ -65,4 +67,114 @@ BOOST_AUTO_TEST_CASE(test_clump_clone) {
     }
 }
 
+namespace {
+/// Builds a clump shaped like a ped skeleton, a spine with limbs of length
+/// limbLength coming off each spine frame
+ClumpPtr createSkeleton(unsigned int spine, unsigned int limbLength) {
+    unsigned int index = 0;
+    auto root = std::make_shared<ModelFrame>(index++);
+    auto parent = root;
+    for (auto s = 0u; s < spine; ++s) {
+        auto frame = std::make_shared<ModelFrame>(
+            index++, glm::mat3{1.0f}, glm::vec3(0.f, 0.f, 0.1f));
+        parent->addChild(frame);
+        auto limbParent = frame;
+        for (auto l = 0u; l < limbLength; ++l) {
+            auto limb = std::make_shared<ModelFrame>(
+                index++, glm::mat3{1.0f}, glm::vec3(0.1f, 0.f, 0.f));
+            limbParent->addChild(limb);
+            limbParent = limb;
+        }
+        parent = frame;
+    }
+
+    auto clump = std::make_shared<Clump>();
+    clump->setFrame(root);
+    return clump;
+}
+
+/// Moves every frame the way Animator::tick does
+void animateSkeleton(const Clump& clump, float t, bool eager) {
+    for (auto frame : clump.getFrames()) {
+        frame->setTranslation(frame->getDefaultTranslation() +
+                              glm::vec3(0.f, t, 0.f));
+        if (eager) {
+            frame->updateHierarchyTransform();
+        }
+        frame->setRotation(glm::mat3(
+            glm::rotate(glm::mat4(1.0f), t, glm::vec3(0.f, 0.f, 1.f))));
+        if (eager) {
+            frame->updateHierarchyTransform();
+        }
+    }
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(test_frame_deferred_transform) {
+    auto frame1 = std::make_shared<ModelFrame>(0);
+    auto frame2 = std::make_shared<ModelFrame>(
+        1, glm::mat3{1.0f}, glm::vec3(1.f, 0.f, 0.f));
+    auto frame3 = std::make_shared<ModelFrame>(
+        2, glm::mat3{1.0f}, glm::vec3(0.f, 1.f, 0.f));
+    frame1->addChild(frame2);
+    frame2->addChild(frame3);
+
+    auto clump = std::make_shared<Clump>();
+    clump->setFrame(frame1);
+
+    BOOST_REQUIRE_EQUAL(clump->getFrames().size(), 3);
+    BOOST_CHECK_EQUAL(clump->getFrames()[0], frame1.get());
+    BOOST_CHECK_EQUAL(clump->getFrames()[2], frame3.get());
+    BOOST_CHECK(!frame3->isDirty());
+
+    frame1->setTranslation(glm::vec3(0.f, 0.f, 5.f));
+    BOOST_CHECK(frame1->isDirty());
+    BOOST_CHECK(frame2->isDirty());
+    BOOST_CHECK(frame3->isDirty());
+
+    // Reading a frame resolves its ancestors, but not its descendants
+    BOOST_CHECK_EQUAL(frame2->getWorldTransform()[3],
+                      glm::vec4(1.f, 0.f, 5.f, 1.f));
+    BOOST_CHECK(!frame1->isDirty());
+    BOOST_CHECK(frame3->isDirty());
+
+    clump->updateTransforms();
+    BOOST_CHECK(!frame3->isDirty());
+    BOOST_CHECK_EQUAL(frame3->getWorldTransform()[3],
+                      glm::vec4(1.f, 1.f, 5.f, 1.f));
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_transform_benchmark) {
+    constexpr auto kSteps = 200;
+    auto eager = createSkeleton(8, 3);
+    auto deferred = createSkeleton(8, 3);
+
+    using clock = std::chrono::steady_clock;
+    auto measure = [&](const Clump& clump, bool isEager) {
+        auto start = clock::now();
+        for (auto i = 0; i < kSteps; ++i) {
+            animateSkeleton(clump, i * 0.01f, isEager);
+            clump.updateTransforms();
+        }
+        return std::chrono::duration<double, std::milli>(clock::now() - start)
+            .count();
+    };
+
+    auto eagerTime = measure(*eager, true);
+    auto deferredTime = measure(*deferred, false);
+    BOOST_TEST_MESSAGE("Animating " << eager->getFrames().size()
+                                    << " frames " << kSteps
+                                    << " times: eager " << eagerTime
+                                    << "ms, deferred " << deferredTime << "ms");
+
+    const auto& eagerFrames = eager->getFrames();
+    const auto& deferredFrames = deferred->getFrames();
+    BOOST_REQUIRE_EQUAL(eagerFrames.size(), deferredFrames.size());
+    for (auto i = 0u; i < eagerFrames.size(); ++i) {
+        BOOST_CHECK(!deferredFrames[i]->isDirty());
+        BOOST_CHECK(eagerFrames[i]->getWorldTransform() ==
+                    deferredFrames[i]->getWorldTransform());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,8 +1,13 @@
 #include <boost/test/unit_test.hpp>
 #include <data/ModelData.hpp>
+#include <data/PathData.hpp>
+#include <loaders/LevelCache.hpp>
 #include <loaders/LoaderIDE.hpp>
 #include "test_Globals.hpp"
 
+#include <filesystem>
+#include <fstream>
+
 namespace {
 constexpr auto kTestDataObjects = R"(
 objs
@@ -92,3 +97,124 @@ BOOST_AUTO_TEST_CASE(pedestrian_data_is_correct) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+namespace {
+constexpr auto kTestDataLevel = R"(
+objs
+1100, NAME, TXD, 1, 220, 0
+end
+
+tobj
+1101, LAMP, TXD, 2, 30, 150, 4, 20, 6
+end
+
+hier
+200, cutobj01, cutobj
+end
+
+cars
+90, vehicle, texture, car, HANDLING, NAME, richfamily, 10, 7, 0, 164, 0.8
+end
+
+peds
+1, mod, txd, COP, STAT_COP, man, 7f
+end
+
+path
+ped, 1100, NAME
+1, -1, 0, 0, 0, 0, 16, 1, 1
+2, 0, 0, 16, 32, 48, 16, 1, 1
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+0, -1, 0, 0, 0, 0, 0, 0, 0
+end
+)";
+
+PedStats pedStats(int id, const char* name) {
+    PedStats stats{};
+    stats.id_ = id;
+    stats.name_ = name;
+    return stats;
+}
+}  // namespace
+
+struct WithIDECache {
+    WithIDECache() {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        std::ofstream(source) << kTestDataLevel;
+    }
+
+    ~WithIDECache() {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::filesystem::path directory{std::filesystem::temp_directory_path() /
+                                    "openrw_test_ide_cache"};
+    std::filesystem::path source{directory / "test.ide"};
+    LevelCache cache{directory / "cache"};
+};
+
+BOOST_FIXTURE_TEST_SUITE(LevelCacheIDETests, WithIDECache)
+
+BOOST_AUTO_TEST_CASE(cached_ide_matches_parsed) {
+    const PedStatsList stats{pedStats(0, "STAT_PLAYER"),
+                             pedStats(5, "STAT_COP")};
+
+    LoaderIDE parsed;
+    BOOST_REQUIRE(cache.loadIDE(source, stats, parsed));
+    BOOST_TEST(cache.getStatistics().misses.load() == 1);
+
+    LoaderIDE cached;
+    BOOST_REQUIRE(cache.loadIDE(source, stats, cached));
+    BOOST_TEST(cache.getStatistics().hits.load() == 1);
+    BOOST_REQUIRE(cached.objects.size() == parsed.objects.size());
+
+    ASSERT_INSTANCE_IS<1>(*cached.objects[1100], "NAME", "TXD", {{220.f}}, 0);
+    ASSERT_INSTANCE_IS<2>(*cached.objects[1101], "LAMP", "TXD",
+                          {{30.f, 150.f}}, 4);
+    ASSERT_VEHICLE_IS(*cached.objects[90], "vehicle", "texture",
+                      VehicleModelInfo::CAR, "HANDLING", "NAME",
+                      VehicleModelInfo::RICHFAMILY, 10, 164, 0.8f);
+    ASSERT_PED_IS(*cached.objects[1], "mod", "txd", PedModelInfo::COP, 5,
+                  "man", 0x7f);
+
+    BOOST_REQUIRE(cached.objects[200]->type() == ModelDataType::ClumpInfo);
+    BOOST_TEST(cached.objects[200]->name == "cutobj01");
+
+    const auto& lamp = static_cast<SimpleModelInfo&>(*cached.objects[1101]);
+    BOOST_TEST(lamp.timeOn == 20);
+    BOOST_TEST(lamp.timeOff == 6);
+
+    const auto& original = static_cast<SimpleModelInfo&>(*parsed.objects[1100]);
+    const auto& simple = static_cast<SimpleModelInfo&>(*cached.objects[1100]);
+    BOOST_REQUIRE(original.paths.size() == 1);
+    BOOST_REQUIRE(simple.paths.size() == 1);
+    BOOST_TEST(simple.paths[0].modelName == original.paths[0].modelName);
+    BOOST_REQUIRE(simple.paths[0].nodes.size() == 2);
+    const auto& node = simple.paths[0].nodes[1];
+    BOOST_TEST(node.type == PathNode::INTERNAL);
+    BOOST_TEST(node.next == 0);
+    BOOST_TEST(node.position.z == 3.f);
+    BOOST_TEST(node.size == original.paths[0].nodes[1].size);
+}
+
+BOOST_AUTO_TEST_CASE(cached_peds_use_current_stats) {
+    LoaderIDE parsed;
+    BOOST_REQUIRE(cache.loadIDE(source, {pedStats(5, "STAT_COP")}, parsed));
+
+    // The stats are looked up again when the entry is loaded
+    LoaderIDE cached;
+    BOOST_REQUIRE(cache.loadIDE(source, {pedStats(7, "STAT_COP")}, cached));
+    BOOST_TEST(cache.getStatistics().hits.load() == 1);
+    BOOST_TEST(static_cast<PedModelInfo&>(*cached.objects[1]).statindex_ == 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
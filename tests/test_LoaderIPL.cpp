@@ -1,8 +1,13 @@
 #include <boost/test/unit_test.hpp>
+#include <loaders/LevelCache.hpp>
 #include <loaders/LoaderIPL.hpp>
 #include <data/InstanceData.hpp>
 #include "test_Globals.hpp"
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
 namespace {
 constexpr auto kIPLTestData = R"(
 zone
@@ -81,3 +86,67 @@ BOOST_AUTO_TEST_CASE(instance_data_is_correct) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+struct WithLevelCache {
+    WithLevelCache() {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        std::ofstream(source) << kIPLTestData;
+    }
+
+    ~WithLevelCache() {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::filesystem::path directory{std::filesystem::temp_directory_path() /
+                                    "openrw_test_level_cache"};
+    std::filesystem::path source{directory / "test.ipl"};
+    LevelCache cache{directory / "cache"};
+};
+
+BOOST_FIXTURE_TEST_SUITE(LevelCacheTests, WithLevelCache)
+
+BOOST_AUTO_TEST_CASE(cached_ipl_matches_parsed) {
+    LoaderIPL parsed;
+    BOOST_REQUIRE(cache.loadIPL(source, parsed));
+    BOOST_TEST(cache.getStatistics().misses.load() == 1);
+    BOOST_TEST(std::filesystem::exists(cache.getEntryPath(source)));
+
+    LoaderIPL cached;
+    BOOST_REQUIRE(cache.loadIPL(source, cached));
+    BOOST_TEST(cache.getStatistics().hits.load() == 1);
+
+    BOOST_TEST(cached.zones == parsed.zones, boost::test_tools::per_element());
+    BOOST_TEST(cached.m_instances == parsed.m_instances,
+               boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(touched_source_uses_cache) {
+    LoaderIPL ipl;
+    BOOST_REQUIRE(cache.loadIPL(source, ipl));
+
+    std::filesystem::last_write_time(
+        source, std::filesystem::last_write_time(source) +
+                    std::chrono::seconds(10));
+
+    LoaderIPL touched;
+    BOOST_REQUIRE(cache.loadIPL(source, touched));
+    BOOST_TEST(cache.getStatistics().hits.load() == 1);
+    BOOST_TEST(touched.m_instances.size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(changed_source_is_parsed) {
+    LoaderIPL ipl;
+    BOOST_REQUIRE(cache.loadIPL(source, ipl));
+
+    std::ofstream(source, std::ios::app)
+        << "inst\n120, ModelC, 1, 2, 3, 1, 1, 1, 0, 0, 0, 1\nend\n";
+
+    LoaderIPL changed;
+    BOOST_REQUIRE(cache.loadIPL(source, changed));
+    BOOST_TEST(cache.getStatistics().misses.load() == 2);
+    BOOST_TEST(changed.m_instances.size() == 4);
+    BOOST_TEST(changed.m_instances.back().model == "ModelC");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+#include <boost/test/unit_test.hpp>
+#include <data/Clump.hpp>
+#include <data/ModelData.hpp>
+#include <loaders/RWBinaryStream.hpp>
+#include <render/LodCellMeshes.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+Geometry::Material material(const glm::u8vec4& colour) {
+    Geometry::Material mat;
+    mat.colour = colour;
+    mat.flags = 0;
+    mat.diffuseIntensity = 1.f;
+    mat.ambientIntensity = 1.f;
+    return mat;
+}
+
+SubGeometry subgeometry(std::size_t material,
+                        std::vector<uint32_t> indices) {
+    SubGeometry subgeom;
+    subgeom.material = material;
+    subgeom.numIndices = indices.size();
+    subgeom.indices = std::move(indices);
+    return subgeom;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(LodCellMeshesTests)
+
+BOOST_AUTO_TEST_CASE(test_merge_geometry) {
+    const glm::u8vec4 white{255, 255, 255, 255};
+    const glm::u8vec4 red{255, 0, 0, 255};
+    SimpleModelInfo modelinfo;
+    modelinfo.flags = 0;
+
+    // A strip of two triangles
+    Geometry quad;
+    quad.facetype = Geometry::TriangleStrip;
+    quad.flags = RW::BSGeometry::ModuleMaterialColor;
+    quad.materials = {material(white)};
+    quad.subgeom = {subgeometry(0, {0, 1, 2, 3})};
+    quad.vertices = {{{0.f, 0.f, 0.f}, {0.f, 0.f, 1.f}, {}, white},
+                     {{1.f, 0.f, 0.f}, {0.f, 0.f, 1.f}, {}, white},
+                     {{0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}, {}, white},
+                     {{1.f, 1.f, 0.f}, {0.f, 0.f, 1.f}, {}, white}};
+
+    // One triangle of each material
+    Geometry triangles;
+    triangles.facetype = Geometry::Triangles;
+    triangles.flags = RW::BSGeometry::ModuleMaterialColor;
+    triangles.materials = {material(red), material(white)};
+    triangles.subgeom = {subgeometry(0, {0, 1, 2}),
+                         subgeometry(1, {0, 2, 1})};
+    triangles.vertices = {{{0.f, 0.f, 0.f}, {0.f, 0.f, 1.f}, {}, white},
+                          {{1.f, 0.f, 0.f}, {0.f, 0.f, 1.f}, {}, white},
+                          {{0.f, 1.f, 5.f}, {0.f, 0.f, 1.f}, {}, white}};
+
+    LodCellMeshes::MeshBuilder builder;
+    BOOST_CHECK(builder.add(quad, glm::mat4(1.f), modelinfo));
+    BOOST_CHECK(builder.add(
+        triangles,
+        glm::translate(glm::mat4(1.f), glm::vec3(100.f, 0.f, 0.f)),
+        modelinfo));
+
+    // Geometry whose vertices only live in the GL can't be merged
+    Geometry uploaded;
+    BOOST_CHECK(!builder.add(uploaded, glm::mat4(1.f), modelinfo));
+
+    std::vector<uint32_t> indices;
+    std::vector<Renderer::DrawParameters> draws;
+    builder.build(indices, draws);
+
+    const auto& vertices = builder.getVertices();
+    BOOST_CHECK_EQUAL(vertices.size(), 7u);
+    BOOST_CHECK_EQUAL(vertices[4].position.x, 100.f);
+    BOOST_CHECK_EQUAL(builder.getMax().x, 101.f);
+    BOOST_CHECK_EQUAL(builder.getMax().z, 5.f);
+
+    // The white triangles of both geometries share a draw
+    BOOST_REQUIRE_EQUAL(draws.size(), 2u);
+    BOOST_CHECK_EQUAL(draws[0].start, 0u);
+    BOOST_CHECK_EQUAL(draws[0].count, 9u);
+    BOOST_CHECK(draws[0].colour == white);
+    BOOST_CHECK_EQUAL(draws[1].start, 9u);
+    BOOST_CHECK_EQUAL(draws[1].count, 3u);
+    BOOST_CHECK(draws[1].colour == red);
+
+    // The strip's second triangle is flipped, the second geometry's indices
+    // start after the first's vertices
+    BOOST_REQUIRE_EQUAL(indices.size(), 12u);
+    const std::vector<uint32_t> whiteIndices(indices.begin(),
+                                             indices.begin() + 9);
+    const std::vector<uint32_t> expected{0, 1, 2, 2, 1, 3, 4, 6, 5};
+    BOOST_CHECK_EQUAL_COLLECTIONS(whiteIndices.begin(), whiteIndices.end(),
+                                  expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(indices[9], 4u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+#include <boost/test/unit_test.hpp>
+#include <data/ModelData.hpp>
+#include <engine/GameData.hpp>
+#include <engine/ModelStreamer.hpp>
+#include "test_Globals.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+/// Pumps the streamer until the model has been loaded or given up on
+bool pump(ModelStreamer& streamer, ModelID model) {
+    for (auto i = 0; i < 500; ++i) {
+        streamer.update();
+        if (streamer.request(model) || streamer.hasFailed(model)) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(ModelStreamerTests, DATA_TEST_PREDICATE)
+
+BOOST_AUTO_TEST_CASE(test_stream_model) {
+    auto& data = *Global::get().d;
+
+    // Any simple model that hasn't been loaded yet
+    ModelID model = 0;
+    for (const auto& [id, info] : data.modelinfo) {
+        if (info->type() == ModelDataType::SimpleInfo && !info->isLoaded()) {
+            model = id;
+            break;
+        }
+    }
+    BOOST_REQUIRE_NE(model, 0);
+
+    ModelStreamer streamer(data, &Global::get().log);
+    streamer.start(2);
+
+    // Requests for the same model share a job
+    BOOST_CHECK(!streamer.request(model));
+    BOOST_CHECK(!streamer.request(model));
+    streamer.update();
+    BOOST_CHECK_EQUAL(streamer.getFrameStats().requested, 1u);
+
+    BOOST_REQUIRE(pump(streamer, model));
+    BOOST_CHECK(!streamer.hasFailed(model));
+    BOOST_CHECK(data.modelinfo[model]->isLoaded());
+    BOOST_CHECK(streamer.request(model));
+
+    streamer.stop();
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_missing_model) {
+    auto& data = *Global::get().d;
+
+    constexpr ModelID kMissing = 65000;
+    auto info = std::make_unique<SimpleModelInfo>();
+    info->name = "missing_streamer_model";
+    info->textureslot = "missing_streamer_model";
+    info->setModelID(kMissing);
+    data.modelinfo[kMissing] = std::move(info);
+
+    ModelStreamer streamer(data, &Global::get().log);
+    streamer.start(1);
+
+    BOOST_CHECK(!streamer.request(kMissing));
+    BOOST_REQUIRE(pump(streamer, kMissing));
+    BOOST_CHECK(streamer.hasFailed(kMissing));
+
+    // It isn't read again
+    BOOST_CHECK(!streamer.request(kMissing));
+    streamer.update();
+    BOOST_CHECK_EQUAL(streamer.getFrameStats().requested, 0u);
+    BOOST_CHECK_EQUAL(streamer.getFrameStats().pending, 0u);
+
+    streamer.stop();
+    data.modelinfo.erase(kMissing);
+    data.textureSlots.erase("missing_streamer_model");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,14 @@
 #include <boost/test/unit_test.hpp>
+#include <gl/DrawBuffer.hpp>
 #include <render/GameRenderer.hpp>
+#include <render/NullRenderer.hpp>
+#include <render/SpriteRenderer.hpp>
+#include <render/WaterRenderer.hpp>
+#include <rw/types.hpp>
+#include "test_Globals.hpp"
+
+#include <memory>
+#include <sstream>
 
 BOOST_AUTO_TEST_SUITE(RendererTests)
 
@@ -23,4 +32,244 @@ BOOST_AUTO_TEST_CASE(frustum_test_visible) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_game_renderer_null_renderer, DATA_TEST_PREDICATE) {
+    auto drawRecorder = std::make_unique<NullRenderer>();
+    const auto& stats = drawRecorder->getStatistics();
+    const auto* recorder = drawRecorder.get();
+
+    GameRenderer renderer(&Global::get().log, Global::get().d,
+                          std::move(drawRecorder));
+    BOOST_CHECK(&renderer.getRenderer() == recorder);
+
+    renderer.setViewport(800, 600);
+    renderer.renderWorld(Global::get().e, ViewCamera(), 1.f);
+
+    // The sky at least is drawn
+    BOOST_CHECK_GT(stats.draws, 0u);
+    BOOST_CHECK(recorder->getViewport() == glm::ivec2(800, 600));
+}
+
+BOOST_AUTO_TEST_CASE(test_null_renderer_batching) {
+    NullRenderer renderer;
+    DrawBuffer bufferA;
+    DrawBuffer bufferB;
+
+    Renderer::DrawParameters params;
+    params.count = 36;
+    params.textures = {{1, 0}};
+
+    // Two runs of the same draw, then a different texture
+    RenderList list;
+    for (int i = 0; i < 3; ++i) {
+        list.emplace_back(0, glm::mat4(1.f), &bufferA, params);
+    }
+    for (int i = 0; i < 2; ++i) {
+        list.emplace_back(0, glm::mat4(1.f), &bufferB, params);
+    }
+    params.textures = {{2, 0}};
+    list.emplace_back(0, glm::mat4(1.f), &bufferB, params);
+
+    renderer.drawBatched(list);
+
+    const auto& stats = renderer.getStatistics();
+    BOOST_CHECK_EQUAL(stats.renderListLength, 6);
+    BOOST_CHECK_EQUAL(stats.draws, 3);
+    BOOST_CHECK_EQUAL(stats.instances, 6);
+    BOOST_CHECK_EQUAL(stats.primitives, 6 * 36);
+    BOOST_CHECK_EQUAL(stats.bufferBinds, 2);
+    BOOST_CHECK_EQUAL(stats.textureBinds, 2);
+    BOOST_CHECK_EQUAL(stats.uniformUploads, 1);
+    BOOST_CHECK_EQUAL(stats.uniformBytes,
+                      6 * sizeof(Renderer::ObjectUniformData));
+    BOOST_CHECK_EQUAL(renderer.getDrawCount(), 3);
+
+    renderer.resetStatistics();
+    BOOST_CHECK_EQUAL(renderer.getStatistics().draws, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_null_renderer_texture_arrays) {
+    NullRenderer renderer;
+    DrawBuffer buffer;
+
+    Renderer::DrawParameters params;
+    params.count = 36;
+    params.textureArray = 1;
+
+    // Each material of a packed slot samples a different layer
+    RenderList list;
+    for (int i = 0; i < 4; ++i) {
+        params.start = static_cast<size_t>(i) * 36;
+        params.layer = static_cast<float>(i);
+        list.emplace_back(0, glm::mat4(1.f), &buffer, params);
+    }
+    // Instances may sample different layers
+    params.layer = 0.f;
+    list.emplace_back(0, glm::mat4(1.f), &buffer, params);
+
+    renderer.pushDebugGroup("World");
+    renderer.drawBatched(list);
+    const auto& profile = renderer.popDebugGroup();
+
+    const auto& stats = renderer.getStatistics();
+    BOOST_CHECK_EQUAL(stats.draws, 4);
+    BOOST_CHECK_EQUAL(stats.textureBinds, 1);
+    BOOST_CHECK_EQUAL(profile.textures, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_null_renderer_recording) {
+    NullRenderer renderer;
+    DrawBuffer buffer;
+    Renderer::DrawParameters params;
+    params.count = 6;
+
+    renderer.draw(glm::mat4(1.f), &buffer, params);
+    BOOST_CHECK(renderer.getCommands().empty());
+
+    renderer.setRecording(true);
+    renderer.pushDebugGroup("World");
+    renderer.draw(glm::mat4(1.f), &buffer, params);
+    renderer.drawArrays(glm::mat4(1.f), &buffer, params);
+    const auto& profile = renderer.popDebugGroup();
+    renderer.setRecording(false);
+
+    BOOST_CHECK_EQUAL(profile.draws, 2);
+    BOOST_CHECK_EQUAL(profile.primitives, 12);
+
+    const auto& commands = renderer.getCommands();
+    BOOST_REQUIRE_EQUAL(commands.size(), 4);
+    BOOST_CHECK_EQUAL(commands[0], "push World");
+    BOOST_CHECK_EQUAL(commands[1].rfind("draw buffer=1 start=0 count=6", 0), 0);
+    BOOST_CHECK_EQUAL(commands[2].rfind("drawArrays buffer=1", 0), 0);
+    BOOST_CHECK_EQUAL(commands[3], "pop");
+
+    std::ostringstream dump;
+    renderer.dumpCommands(dump);
+    BOOST_CHECK_EQUAL(dump.str().substr(0, 11), "push World\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_sprite_batch) {
+    using Batch = SpriteRenderer::Batch;
+    const glm::vec4 white{1.f};
+    Batch batch;
+
+    // Two icons with a rectangle between them, then a second texture
+    batch.add({0.f, 0.f, 10.f, 10.f}, white, 1, BlendMode::BLEND_ALPHA);
+    batch.add({20.f, 0.f, 10.f, 10.f}, white, 0, BlendMode::BLEND_ALPHA);
+    batch.add({40.f, 0.f, 10.f, 10.f}, white, 2, BlendMode::BLEND_ALPHA);
+    // Doesn't overlap the second texture, so joins the first draw
+    batch.add({0.f, 20.f, 10.f, 10.f}, white, 1, BlendMode::BLEND_ALPHA);
+    // Covers the second texture, so has to be drawn after it
+    batch.add({35.f, 5.f, 10.f, 10.f}, white, 1, BlendMode::BLEND_ALPHA);
+    batch.add({0.f, 40.f, 10.f, 10.f}, white, 1, BlendMode::BLEND_ADDITIVE);
+
+    std::vector<SpriteRenderer::SpriteVertex> vertices;
+    std::vector<Batch::Draw> draws;
+    batch.build(vertices, draws);
+    BOOST_CHECK_EQUAL(vertices.size(), 36u);
+    BOOST_REQUIRE_EQUAL(draws.size(), 4);
+
+    BOOST_CHECK_EQUAL(draws[0].texture, 1u);
+    BOOST_CHECK_EQUAL(draws[0].start, 0u);
+    BOOST_CHECK_EQUAL(draws[0].count, 18u);
+    BOOST_CHECK_EQUAL(draws[1].texture, 2u);
+    BOOST_CHECK_EQUAL(draws[1].start, 18u);
+    BOOST_CHECK_EQUAL(draws[2].texture, 1u);
+    BOOST_CHECK_EQUAL(draws[2].count, 6u);
+    BOOST_CHECK(draws[3].blendMode == BlendMode::BLEND_ADDITIVE);
+
+    // Quads keep their order within a draw, untextured ones aren't sampled
+    BOOST_CHECK_EQUAL(vertices[6].position.x, 20.f);
+    BOOST_CHECK_LT(vertices[6].texcoord.x, 0.f);
+    BOOST_CHECK_EQUAL(vertices[12].position.y, 20.f);
+    BOOST_CHECK_EQUAL(vertices[12].texcoord.x, 0.f);
+
+    batch.clear();
+    BOOST_CHECK(batch.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_text_backgrounds_batched, DATA_TEST_PREDICATE) {
+    GameRenderer renderer(&Global::get().log, Global::get().d,
+                          std::make_unique<NullRenderer>());
+    renderer.setViewport(800, 600);
+    renderer.text.setFontTexture(FONT_PRICEDOWN, "font1");
+    auto endFrame = [&] {
+        renderer.text.endFrame();
+        renderer.sprites.endFrame();
+    };
+
+    TextRenderer::TextInfo ti;
+    ti.font = FONT_PRICEDOWN;
+    ti.size = 20.f;
+    ti.text = GameStringUtil::fromString("Item", FONT_PRICEDOWN);
+    ti.backgroundColour = {0, 0, 0, 255};
+
+    // Menu items whose backgrounds don't cover each other's text
+    auto drawItems = [&] {
+        for (int i = 0; i < 4; ++i) {
+            ti.screenPosition = {100.f, 100.f + i * 50.f};
+            renderer.text.renderText(ti);
+        }
+    };
+    drawItems();
+    endFrame();
+    BOOST_CHECK_EQUAL(renderer.sprites.getStatistics().quads, 4u);
+    BOOST_CHECK_EQUAL(renderer.sprites.getStatistics().draws, 1u);
+    BOOST_CHECK_EQUAL(renderer.text.getStatistics().draws, 1u);
+
+    // A rectangle over queued text has to be drawn after it
+    drawItems();
+    renderer.drawColour({1.f, 0.f, 0.f, 1.f}, {90.f, 90.f, 50.f, 50.f});
+    endFrame();
+    BOOST_CHECK_EQUAL(renderer.sprites.getStatistics().draws, 2u);
+    BOOST_CHECK_EQUAL(renderer.text.getStatistics().draws, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_water_patch_tree) {
+    constexpr unsigned int kEdge = 8;
+    constexpr float kTileSize = WATER_WORLD_SIZE / kEdge;
+    const float heights[] = {5.f};
+
+    // Water everywhere but the top right quarter
+    std::vector<uint8_t> tiles(kEdge * kEdge, 0);
+    for (auto x = kEdge / 2; x < kEdge; ++x) {
+        for (auto y = kEdge / 2; y < kEdge; ++y) {
+            tiles[x * kEdge + y] = NO_WATER_INDEX;
+        }
+    }
+
+    WaterRenderer::PatchTree tree;
+    BOOST_CHECK(tree.empty());
+    tree.setWaterTable(heights, 1, tiles.data(), tiles.size());
+    BOOST_REQUIRE(!tree.empty());
+
+    // Above the middle of the bottom left tile
+    const glm::vec2 corner(-WATER_WORLD_SIZE / 2.f);
+    const glm::vec3 camera{corner + glm::vec2(kTileSize / 2.f), 10.f};
+    std::vector<WaterRenderer::Patch> patches;
+    tree.select(camera, nullptr, patches);
+    BOOST_REQUIRE(!patches.empty());
+
+    float area = 0.f;
+    float largest = 0.f;
+    for (const auto& patch : patches) {
+        area += patch.size * patch.size;
+        largest = std::max(largest, patch.size);
+
+        const auto tile = (patch.origin - corner) / kTileSize;
+        BOOST_CHECK(tile.x < kEdge / 2 || tile.y < kEdge / 2);
+
+        // Full detail under the camera
+        if (patch.origin == corner) {
+            BOOST_CHECK_EQUAL(patch.size, kTileSize);
+        }
+    }
+    BOOST_CHECK_EQUAL(area, kTileSize * kTileSize * 48.f);
+    BOOST_CHECK_GT(largest, kTileSize);
+
+    // Nothing is drawn without any water
+    std::fill(tiles.begin(), tiles.end(), NO_WATER_INDEX);
+    tree.setWaterTable(heights, 1, tiles.data(), tiles.size());
+    BOOST_CHECK(tree.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
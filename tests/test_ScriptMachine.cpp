@@ -1,6 +1,12 @@
 #include <boost/test/unit_test.hpp>
+#include <engine/GameState.hpp>
 #include <script/SCMFile.hpp>
 #include <script/ScriptMachine.hpp>
+#include <script/ScriptModule.hpp>
+#include "test_Globals.hpp"
+
+#include <iterator>
+#include <vector>
 
 SCMByte data[] = {0x02, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
                   0x01, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -19,4 +25,80 @@ BOOST_AUTO_TEST_CASE(scmfile_test) {
     BOOST_CHECK_EQUAL(f.getCodeSection(), 0x28);
 }
 
+// Header from above followed by a loop at 0x30:
+// 0x30: global 0 += 5
+// 0x37: local 1 += 1
+// 0x3E: wait 0
+// 0x42: goto 0x30
+SCMByte loopData[] = {
+    0x02, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x18,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x01, 0x28, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x02, 0x00, 0x00, 0x04, 0x05,
+    0x08, 0x00, 0x03, 0x01, 0x00, 0x04, 0x01,
+    0x01, 0x00, 0x04, 0x00,
+    0x02, 0x00, 0x01, 0x30, 0x00, 0x00, 0x00};
+
+void test_wait(const ScriptArguments& args, const ScriptInt time) {
+    args.getThread()->wakeCounter = time > 0 ? time : -1;
+}
+
+void test_goto(const ScriptArguments& args, const ScriptLabel label) {
+    args.getThread()->programCounter = label;
+}
+
+void test_add(const ScriptArguments&, ScriptInt& var, const ScriptInt value) {
+    var += value;
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_cache, DATA_TEST_PREDICATE) {
+    SCMFile f;
+    f.loadFile(loopData, sizeof(loopData));
+
+    ScriptModule module("Test");
+    module.bind(0x0001, 1, test_wait);
+    module.bind(0x0002, 1, test_goto);
+    module.bind(0x0008, 2, test_add);
+
+    GameState state;
+    state.world = Global::get().e;
+
+    ScriptMachine machine(&state, f, &module);
+    machine.startThread(0x30);
+    auto& thread = machine.getThreads().front();
+    auto local = [&]() {
+        return *reinterpret_cast<ScriptInt*>(thread.locals.data() +
+                                             SCM_VARIABLE_SIZE);
+    };
+    auto global = [&]() {
+        return *reinterpret_cast<ScriptInt*>(machine.getGlobals());
+    };
+
+    machine.execute(0.f);
+    BOOST_CHECK_EQUAL(machine.getInstructionCount(), 3);
+    BOOST_CHECK_EQUAL(machine.getDecodedCount(), 3);
+    BOOST_CHECK_EQUAL(global(), 5);
+    BOOST_CHECK_EQUAL(local(), 1);
+
+    machine.execute(0.f);
+    BOOST_CHECK_EQUAL(machine.getInstructionCount(), 4);
+    BOOST_CHECK_EQUAL(machine.getDecodedCount(), 4);
+    BOOST_CHECK_EQUAL(global(), 10);
+    BOOST_CHECK_EQUAL(local(), 2);
+
+    // Loading other code into the file is noticed by the next execute(),
+    // even after several loads that may have reused the same memory
+    std::vector<SCMByte> patched(std::begin(loopData), std::end(loopData));
+    patched[0x36] = 0x07;
+    const auto generation = f.getGeneration();
+    f.loadFile(loopData, sizeof(loopData));
+    f.loadFile(patched.data(), patched.size());
+    BOOST_CHECK_NE(f.getGeneration(), generation);
+    machine.execute(0.f);
+    BOOST_CHECK_EQUAL(machine.getDecodedCount(), 4);
+    BOOST_CHECK_EQUAL(global(), 17);
+    BOOST_CHECK_EQUAL(local(), 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
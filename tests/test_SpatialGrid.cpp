@@ -0,0 +1,124 @@
+#include <boost/test/unit_test.hpp>
+#include <data/Clump.hpp>
+#include <engine/SpatialGrid.hpp>
+#include <objects/GameObject.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+class TestObject final : public GameObject {
+public:
+    explicit TestObject(const glm::vec3& pos)
+        : GameObject(nullptr, pos, glm::quat{1.0f, 0.0f, 0.0f, 0.0f},
+                     nullptr) {
+    }
+
+    void tick(float) override {
+    }
+};
+
+std::vector<GameObject*> findInRadius(const SpatialGrid& grid,
+                                      const glm::vec3& center, float radius) {
+    std::vector<GameObject*> found;
+    grid.forEachInRadius(center, radius,
+                         [&](GameObject* object) { found.push_back(object); });
+    std::sort(found.begin(), found.end());
+    return found;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(SpatialGridTests)
+
+BOOST_AUTO_TEST_CASE(test_radius_query) {
+    SpatialGrid grid(10.f);
+    TestObject a({0.f, 0.f, 0.f});
+    TestObject b({5.f, 5.f, 0.f});
+    TestObject c({-25.f, 40.f, 0.f});
+    grid.insert(&a);
+    grid.insert(&b);
+    grid.insert(&c);
+    BOOST_CHECK_EQUAL(grid.size(), 3);
+
+    auto found = findInRadius(grid, {1.f, 1.f, 0.f}, 8.f);
+    BOOST_REQUIRE_EQUAL(found.size(), 2);
+    BOOST_CHECK(std::find(found.begin(), found.end(), &c) == found.end());
+
+    // Distance is measured in 3D, even though cells are 2D
+    BOOST_CHECK(findInRadius(grid, {0.f, 0.f, 20.f}, 8.f).empty());
+
+    // Larger than the occupied cells, which are visited directly
+    BOOST_CHECK_EQUAL(findInRadius(grid, {0.f, 0.f, 0.f}, 10000.f).size(), 3);
+
+    BOOST_CHECK(grid.anyInRadius({-20.f, 40.f, 0.f}, 6.f,
+                                 [&](GameObject* o) { return o == &c; }));
+    BOOST_CHECK(!grid.anyInRadius({-20.f, 40.f, 0.f}, 4.f,
+                                  [](GameObject*) { return true; }));
+}
+
+BOOST_AUTO_TEST_CASE(test_box_query) {
+    SpatialGrid grid(10.f);
+    TestObject a({-5.f, -5.f, 0.f});
+    TestObject b({15.f, 2.f, 3.f});
+    grid.insert(&a);
+    grid.insert(&b);
+
+    std::vector<GameObject*> found;
+    grid.forEachInBox({0.f, 0.f, 0.f}, {20.f, 20.f, 5.f},
+                      [&](GameObject* object) { found.push_back(object); });
+    BOOST_REQUIRE_EQUAL(found.size(), 1);
+    BOOST_CHECK_EQUAL(found[0], &b);
+}
+
+BOOST_AUTO_TEST_CASE(test_objects_move_between_cells) {
+    SpatialGrid grid(10.f);
+    TestObject a({0.f, 0.f, 0.f});
+    grid.insert(&a);
+
+    a.setPosition({100.f, -100.f, 0.f});
+    BOOST_CHECK(findInRadius(grid, {0.f, 0.f, 0.f}, 5.f).empty());
+    BOOST_CHECK_EQUAL(findInRadius(grid, {100.f, -100.f, 0.f}, 5.f).size(), 1);
+
+    grid.remove(&a);
+    BOOST_CHECK_EQUAL(grid.size(), 0);
+    BOOST_CHECK(findInRadius(grid, {100.f, -100.f, 0.f}, 5.f).empty());
+
+    // Moving objects outside the grid doesn't touch it
+    a.setPosition({0.f, 0.f, 0.f});
+    BOOST_CHECK(findInRadius(grid, {0.f, 0.f, 0.f}, 5.f).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_destroyed_objects_leave_grid) {
+    SpatialGrid grid;
+    {
+        auto object = std::make_unique<TestObject>(glm::vec3(1.f, 2.f, 3.f));
+        grid.insert(object.get());
+        BOOST_CHECK_EQUAL(grid.size(), 1);
+    }
+    BOOST_CHECK_EQUAL(grid.size(), 0);
+    BOOST_CHECK(findInRadius(grid, {1.f, 2.f, 3.f}, 1.f).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_max_radius_follows_model) {
+    SpatialGrid grid;
+    TestObject object({0.f, 0.f, 0.f});
+    grid.insert(&object);
+    BOOST_CHECK_EQUAL(grid.getMaxObjectRadius(), 0.f);
+
+    // A model given after insertion still widens the queries
+    auto geometry = std::make_shared<Geometry>();
+    geometry->geometryBounds.center = glm::vec3(0.f);
+    geometry->geometryBounds.radius = 10.f;
+    auto atomic = std::make_shared<Atomic>();
+    atomic->setGeometry(geometry);
+    auto clump = std::make_shared<Clump>();
+    clump->addAtomic(atomic);
+    clump->recalculateMetrics();
+    object.setModel(clump);
+    BOOST_CHECK_CLOSE(grid.getMaxObjectRadius(), 10.f, 0.001f);
+
+    grid.remove(&object);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
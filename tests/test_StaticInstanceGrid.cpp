@@ -0,0 +1,89 @@
+#include <boost/test/unit_test.hpp>
+#include <data/ModelData.hpp>
+#include <engine/GameWorld.hpp>
+#include <engine/StaticInstanceGrid.hpp>
+#include <objects/InstanceObject.hpp>
+#include "test_Globals.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+BOOST_AUTO_TEST_SUITE(StaticInstanceGridTests, DATA_TEST_PREDICATE)
+
+BOOST_AUTO_TEST_CASE(test_cell_bounds) {
+    auto& gw = *Global::get().e;
+    StaticInstanceGrid grid(100.f);
+
+    auto a = gw.createInstance(1337, glm::vec3(10.f, 10.f, 0.f));
+    auto b = gw.createInstance(1337, glm::vec3(60.f, 20.f, 5.f));
+    auto c = gw.createInstance(1337, glm::vec3(-250.f, 10.f, 0.f));
+    grid.insert(a);
+    grid.insert(b);
+    grid.insert(c);
+    BOOST_CHECK(a->isInCellGrid());
+    BOOST_CHECK_EQUAL(grid.size(), 3);
+    BOOST_REQUIRE_EQUAL(grid.getCells().size(), 2);
+
+    grid.updateBounds();
+    const auto& cell = grid.getCells()[0];
+    BOOST_CHECK_EQUAL(cell.instances.size(), 2);
+    BOOST_CHECK(!cell.dirty);
+    BOOST_CHECK_EQUAL(cell.min.x, 10.f);
+    BOOST_CHECK_EQUAL(cell.max.x, 60.f);
+    BOOST_CHECK_EQUAL(cell.max.z, 5.f);
+    BOOST_CHECK_EQUAL(
+        cell.lodDistance,
+        a->getModelInfo<SimpleModelInfo>()->getLargestLodDistance());
+    BOOST_CHECK_LE(glm::distance(cell.center, b->getPosition()), cell.radius);
+
+    // Moved instances stay in their cell, which grows to cover them
+    b->setPosition({90.f, 20.f, 5.f});
+    BOOST_CHECK(grid.getCells()[0].dirty);
+    grid.updateBounds();
+    BOOST_CHECK_EQUAL(grid.getCells()[0].max.x, 90.f);
+
+    // Data built from the cell has to be built again once it's hidden
+    const auto version = grid.getCells()[0].version;
+    a->setVisible(false);
+    BOOST_CHECK_NE(grid.getCells()[0].version, version);
+
+    grid.remove(a);
+    BOOST_CHECK(!a->isInCellGrid());
+    BOOST_CHECK_EQUAL(grid.size(), 2);
+    BOOST_REQUIRE_EQUAL(grid.getCells()[0].instances.size(), 1);
+    BOOST_CHECK_EQUAL(grid.getCells()[0].instances[0], b);
+
+    gw.destroyObject(a);
+    gw.destroyObject(b);
+    gw.destroyObject(c);
+    BOOST_CHECK_EQUAL(grid.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_destroyed_instances_leave_grid) {
+    auto& gw = *Global::get().e;
+    StaticInstanceGrid grid;
+
+    auto a = gw.createInstance(1337, glm::vec3(0.f, 0.f, 0.f));
+    auto b = gw.createInstance(1337, glm::vec3(1.f, 0.f, 0.f));
+    auto c = gw.createInstance(1337, glm::vec3(2.f, 0.f, 0.f));
+    grid.insert(a);
+    grid.insert(b);
+    grid.insert(c);
+
+    gw.destroyObject(a);
+    BOOST_CHECK_EQUAL(grid.size(), 2);
+
+    // The instance moved into the free place can still be removed
+    const auto& instances = grid.getCells()[0].instances;
+    BOOST_CHECK(std::find(instances.begin(), instances.end(), c) !=
+                instances.end());
+    gw.destroyObject(c);
+    BOOST_REQUIRE_EQUAL(instances.size(), 1);
+    BOOST_CHECK_EQUAL(instances[0], b);
+
+    gw.destroyObject(b);
+    BOOST_CHECK_EQUAL(grid.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
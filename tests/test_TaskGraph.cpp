@@ -0,0 +1,123 @@
+#include <boost/test/unit_test.hpp>
+#include <core/JobSystem.hpp>
+#include <core/TaskGraph.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+std::size_t positionOf(const std::vector<std::string>& order,
+                       const std::string& name) {
+    return static_cast<std::size_t>(
+        std::find(order.begin(), order.end(), name) - order.begin());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(TaskGraphTests)
+
+BOOST_AUTO_TEST_CASE(test_dependency_order) {
+    JobSystem jobs(3);
+    TaskGraph graph;
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name) {
+        return [&, name] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    graph.add("d", {"b", "c"}, record("d"));
+    graph.add("b", {"a"}, record("b"));
+    graph.add("c", {"a", "missing"}, record("c"));
+    graph.add("a", {}, record("a"));
+    graph.run(&jobs);
+
+    BOOST_REQUIRE_EQUAL(order.size(), 4);
+    BOOST_CHECK_LT(positionOf(order, "a"), positionOf(order, "b"));
+    BOOST_CHECK_LT(positionOf(order, "a"), positionOf(order, "c"));
+    BOOST_CHECK_LT(positionOf(order, "b"), positionOf(order, "d"));
+    BOOST_CHECK_LT(positionOf(order, "c"), positionOf(order, "d"));
+
+    const auto& timings = graph.getTimings();
+    BOOST_REQUIRE_EQUAL(timings.size(), 4);
+    for (const auto& timing : timings) {
+        const auto expected = timing.name == "a" ? 0u
+                              : timing.name == "d" ? 2u
+                                                   : 1u;
+        BOOST_CHECK_EQUAL(timing.wave, expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_main_thread) {
+    JobSystem jobs(3);
+    TaskGraph graph;
+
+    const auto caller = std::this_thread::get_id();
+    std::atomic<int> onCaller{0};
+    std::atomic<int> ran{0};
+
+    for (int i = 0; i < 8; ++i) {
+        graph.add("main" + std::to_string(i), {},
+                  [&] {
+                      onCaller += std::this_thread::get_id() == caller;
+                      ran++;
+                  },
+                  TaskGraph::Thread::Main);
+        graph.add("any" + std::to_string(i), {}, [&] { ran++; });
+    }
+    graph.run(&jobs);
+
+    BOOST_CHECK_EQUAL(ran, 16);
+    BOOST_CHECK_EQUAL(onCaller, 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_added_steps) {
+    JobSystem jobs(2);
+    TaskGraph graph;
+
+    std::vector<std::string> order;
+    graph.add("first", {},
+              [&] {
+                  order.push_back("first");
+                  graph.add("added", {"second"},
+                            [&] { order.push_back("added"); });
+              },
+              TaskGraph::Thread::Main);
+    graph.add("second", {"first"}, [&] { order.push_back("second"); });
+    graph.run(&jobs);
+
+    BOOST_CHECK(order == (std::vector<std::string>{"first", "second", "added"}));
+}
+
+BOOST_AUTO_TEST_CASE(test_exception) {
+    JobSystem jobs(2);
+    TaskGraph graph;
+
+    std::atomic<int> ran{0};
+    graph.add("throws", {}, [] { throw std::logic_error("failed"); });
+    graph.add("sibling", {}, [&] { ran++; });
+    graph.add("after", {"throws"}, [&] { ran += 10; });
+
+    BOOST_CHECK_THROW(graph.run(&jobs), std::logic_error);
+    BOOST_CHECK_EQUAL(ran, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_cycle) {
+    TaskGraph graph;
+
+    bool ran = false;
+    graph.add("a", {"b"}, [&] { ran = true; });
+    graph.add("b", {"a"}, [&] { ran = true; });
+
+    BOOST_CHECK_THROW(graph.run(), std::runtime_error);
+    BOOST_CHECK(!ran);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 #include <fonts/GameTexts.hpp>
 #include <loaders/LoaderGXT.hpp>
 #include <platform/FileHandle.hpp>
+#include <render/GameRenderer.hpp>
 #include "test_Globals.hpp"
 
 #define T(x) GameStringUtil::fromString(x, FONT_PRICEDOWN)
@@ -141,4 +142,37 @@ BOOST_AUTO_TEST_CASE(format_remove) {
     BOOST_CHECK_EQUAL(1, st.getText<ScreenTextType::Big>().size());
 }
 
+BOOST_AUTO_TEST_CASE(layout_cache, DATA_TEST_PREDICATE) {
+    GameRenderer renderer(&Global::get().log, Global::get().d);
+    auto& text = renderer.text;
+    text.setFontTexture(FONT_PRICEDOWN, "font1");
+
+    TextRenderer::TextInfo ti;
+    ti.font = FONT_PRICEDOWN;
+    ti.size = 20.f;
+    ti.text = T("Cached");
+    text.renderText(ti);
+
+    // Moving the text reuses its layout, changing the colour doesn't
+    ti.screenPosition = {100.f, 100.f};
+    text.renderText(ti);
+    ti.baseColour = {255, 0, 0};
+    text.renderText(ti);
+    text.endFrame();
+
+    const auto& stats = text.getStatistics();
+    BOOST_CHECK_EQUAL(stats.strings, 3);
+    BOOST_CHECK_EQUAL(stats.cacheHits, 1);
+    BOOST_CHECK_EQUAL(stats.glyphs, 3 * 6);
+    BOOST_CHECK_EQUAL(stats.draws, 1);
+    BOOST_CHECK_EQUAL(text.getCachedLayoutCount(), 2);
+
+    // Layouts that aren't drawn are eventually forgotten
+    for (int i = 0; i < 1000; ++i) {
+        text.endFrame();
+    }
+    BOOST_CHECK_EQUAL(text.getCachedLayoutCount(), 0);
+    BOOST_CHECK_EQUAL(text.getStatistics().strings, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
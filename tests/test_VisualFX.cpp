@@ -1,6 +1,9 @@
 #include <boost/test/unit_test.hpp>
+#include <render/ParticleRenderer.hpp>
 #include <render/VisualFX.hpp>
 
+#include <chrono>
+
 BOOST_AUTO_TEST_SUITE(VisualFXTests)
 
 BOOST_AUTO_TEST_CASE(test_light_data) {
@@ -9,4 +12,83 @@ BOOST_AUTO_TEST_CASE(test_light_data) {
     BOOST_CHECK_EQUAL(fx->getType(), Light);
 }
 
+BOOST_AUTO_TEST_CASE(test_particle_groups) {
+    TextureData smoke(0, {32, 32}, false);
+    TextureData spark(0, {32, 32}, false);
+
+    std::vector<std::unique_ptr<VisualFX>> effects;
+    auto addParticle = [&](TextureData* texture, const glm::vec3& position) {
+        auto particle = std::make_unique<ParticleFX>();
+        particle->texture = texture;
+        particle->position = position;
+        particle->orientation = ParticleFX::UpCamera;
+        particle->colour = {1.f, 0.5f, 0.f, 1.f};
+        effects.push_back(std::move(particle));
+    };
+    addParticle(&smoke, {1.f, 0.f, 0.f});
+    addParticle(&spark, {2.f, 0.f, 0.f});
+    effects.push_back(std::make_unique<LightFX>());
+    addParticle(&smoke, {3.f, 0.f, 0.f});
+
+    std::vector<ParticleRenderer::Group> groups;
+    ParticleRenderer::gather(effects, groups);
+    BOOST_REQUIRE_EQUAL(groups.size(), 2);
+    BOOST_CHECK_EQUAL(groups[0].texture, &smoke);
+    BOOST_REQUIRE_EQUAL(groups[0].instances.size(), 2);
+    BOOST_CHECK_EQUAL(groups[1].instances.size(), 1);
+
+    const auto& instance = groups[0].instances[1];
+    BOOST_CHECK_EQUAL(instance.position.x, 3.f);
+    BOOST_CHECK_EQUAL(instance.orientation,
+                      static_cast<float>(ParticleFX::UpCamera));
+    BOOST_CHECK_EQUAL(instance.colour.r, 255);
+    BOOST_CHECK_EQUAL(instance.colour.g, 127);
+    BOOST_CHECK_EQUAL(instance.colour.b, 0);
+
+    // Textures without particles are dropped
+    effects.erase(effects.begin());
+    effects.pop_back();
+    ParticleRenderer::gather(effects, groups);
+    BOOST_REQUIRE_EQUAL(groups.size(), 1);
+    BOOST_CHECK_EQUAL(groups[0].texture, &spark);
+}
+
+BOOST_AUTO_TEST_CASE(test_benchmark_particles) {
+    constexpr auto kParticles = 10000;
+    constexpr auto kTextures = 4;
+    constexpr auto kFrames = 100;
+
+    std::vector<std::unique_ptr<TextureData>> textures;
+    for (auto i = 0; i < kTextures; ++i) {
+        textures.push_back(
+            std::make_unique<TextureData>(0, glm::ivec2{32, 32}, false));
+    }
+
+    std::vector<std::unique_ptr<VisualFX>> effects;
+    for (auto i = 0; i < kParticles; ++i) {
+        auto particle = std::make_unique<ParticleFX>();
+        particle->texture = textures[(i / 16) % kTextures].get();
+        particle->position = {i * 0.1f, 0.f, 0.f};
+        effects.push_back(std::move(particle));
+    }
+
+    std::vector<ParticleRenderer::Group> groups;
+    auto start = std::chrono::steady_clock::now();
+    for (auto f = 0; f < kFrames; ++f) {
+        ParticleRenderer::gather(effects, groups);
+    }
+    std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - start;
+    BOOST_TEST_MESSAGE("Gathering " << kParticles << " particles: "
+                                    << time.count() / kFrames
+                                    << "ms per frame");
+
+    BOOST_REQUIRE_EQUAL(groups.size(), kTextures);
+    std::size_t instances = 0;
+    for (const auto& group : groups) {
+        instances += group.instances.size();
+    }
+    BOOST_CHECK_EQUAL(instances, kParticles);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
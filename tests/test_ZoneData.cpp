@@ -1,7 +1,59 @@
 #include <boost/test/unit_test.hpp>
 #include <data/ZoneData.hpp>
+#include <data/ZoneGrid.hpp>
 #include "test_Globals.hpp"
 
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace {
+/// A city sized hierarchy of islands, districts and overlapping blocks
+ZoneDataList createZones(std::mt19937& rng) {
+    ZoneDataList zones;
+    zones.reserve(1 + 4 + 4 * 16 + 200);
+    zones.emplace_back("CITYZON", 0, glm::vec3(-4000.f, -4000.f, -500.f),
+                       glm::vec3(4000.f, 4000.f, 500.f), 0, 0, 0);
+
+    for (int i = 0; i < 4; ++i) {
+        const glm::vec3 min(-4000.f + (i % 2) * 4000.f,
+                            -4000.f + (i / 2) * 4000.f, -200.f);
+        zones.emplace_back("ISLAND" + std::to_string(i), 0, min,
+                           min + glm::vec3(4000.f, 4000.f, 400.f), i + 1, 0, 0);
+        for (int d = 0; d < 16; ++d) {
+            const glm::vec3 dmin =
+                min + glm::vec3((d % 4) * 1000.f, (d / 4) * 1000.f, 0.f);
+            zones.emplace_back("DISTRICT", 0, dmin,
+                               dmin + glm::vec3(1000.f, 1000.f, 400.f), i + 1,
+                               0, 0);
+        }
+    }
+
+    std::uniform_real_distribution<float> position(-3900.f, 3700.f);
+    std::uniform_real_distribution<float> size(20.f, 200.f);
+    std::uniform_real_distribution<float> height(-150.f, 100.f);
+    for (int b = 0; b < 200; ++b) {
+        const glm::vec3 min(position(rng), position(rng), height(rng));
+        zones.emplace_back("BLOCK", 0, min,
+                           min + glm::vec3(size(rng), size(rng), 50.f), 0, 0,
+                           0);
+    }
+
+    for (auto& zone : zones) {
+        if (&zone != &zones.front()) {
+            zones.front().insertZone(zone);
+        }
+    }
+    return zones;
+}
+
+glm::vec3 randomPoint(std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(-4100.f, 4100.f);
+    std::uniform_real_distribution<float> height(-600.f, 600.f);
+    return {position(rng), position(rng), height(rng)};
+}
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE(ZoneDataTests)
 
 BOOST_AUTO_TEST_CASE(test_contains_point) {
@@ -30,4 +82,71 @@ BOOST_AUTO_TEST_CASE(test_hierarchy) {
     BOOST_CHECK_EQUAL(zone.findLeafAtPoint({ 5.f, 5.f, 0.f}), &leaf);
 
 }
+
+BOOST_AUTO_TEST_CASE(test_grid_matches_hierarchy) {
+    std::mt19937 rng(1234);
+    auto zones = createZones(rng);
+    auto& root = zones.front();
+
+    ZoneGrid grid;
+    grid.build(root);
+
+    ZoneGrid::Hint hint;
+    for (int i = 0; i < 100000; ++i) {
+        const auto point = randomPoint(rng);
+        const auto expected = root.findLeafAtPoint(point);
+        BOOST_REQUIRE_EQUAL(grid.find(point), expected);
+        BOOST_REQUIRE_EQUAL(grid.find(point, hint), expected);
+    }
+
+    // Points on the edges of zones belong to them
+    for (const auto& zone : zones) {
+        BOOST_CHECK_EQUAL(grid.find(zone.min), root.findLeafAtPoint(zone.min));
+        BOOST_CHECK_EQUAL(grid.find(zone.max), root.findLeafAtPoint(zone.max));
+    }
+
+    // Hints from before a rebuild are not used
+    const glm::vec3 point(10.f, 10.f, 0.f);
+    grid.find(point, hint);
+    grid.clear();
+    BOOST_CHECK(grid.find(point, hint) == nullptr);
+    grid.build(root);
+    BOOST_CHECK_EQUAL(grid.find(point, hint), root.findLeafAtPoint(point));
+}
+
+BOOST_AUTO_TEST_CASE(test_benchmark_grid) {
+    constexpr auto kQueries = 1 << 20;
+    std::mt19937 rng(42);
+    auto zones = createZones(rng);
+    auto& root = zones.front();
+
+    ZoneGrid grid;
+    grid.build(root);
+
+    std::vector<glm::vec3> points(kQueries);
+    for (auto& point : points) {
+        point = randomPoint(rng);
+    }
+
+    using clock = std::chrono::steady_clock;
+    std::size_t hierarchyFound = 0;
+    auto start = clock::now();
+    for (const auto& point : points) {
+        hierarchyFound += root.findLeafAtPoint(point) != nullptr;
+    }
+    std::chrono::duration<double, std::milli> hierarchy = clock::now() - start;
+
+    std::size_t gridFound = 0;
+    start = clock::now();
+    for (const auto& point : points) {
+        gridFound += grid.find(point) != nullptr;
+    }
+    std::chrono::duration<double, std::milli> gridTime = clock::now() - start;
+
+    BOOST_TEST_MESSAGE("Finding zones at " << kQueries << " points: hierarchy "
+                                           << hierarchy.count() << "ms, grid "
+                                           << gridTime.count() << "ms");
+    BOOST_CHECK_EQUAL(gridFound, hierarchyFound);
+}
+
 BOOST_AUTO_TEST_SUITE_END()